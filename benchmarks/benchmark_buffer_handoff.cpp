@@ -0,0 +1,127 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/stream.h"
+#include "mir/graphics/buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+class ClientBuffer : public mg::Buffer
+{
+public:
+    ClientBuffer(int id) : id_{static_cast<uint32_t>(id)} {}
+
+    std::shared_ptr<mg::NativeBuffer> native_buffer_handle() const override { return nullptr; }
+    mg::BufferID id() const override { return id_; }
+    geom::Size size() const override { return {640, 480}; }
+    MirPixelFormat pixel_format() const override { return mir_pixel_format_abgr_8888; }
+    mg::NativeBufferBase* native_buffer_base() override { return nullptr; }
+
+private:
+    mg::BufferID const id_;
+};
+
+struct CompositorResult
+{
+    long frames{0};
+    long calls{0};
+    nanoseconds total_time{0};
+    nanoseconds slowest_call{0};
+};
+}
+
+/*
+ * One client thread submits buffers to a stream as fast as it can while
+ * compositor threads take them. How long the slowest compositor call took
+ * shows whether the client can stall the compositors.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of compositor threads> <submission count>"<<std::endl;
+        exit(1);
+    }
+
+    int const compositor_count = std::atoi(argv[1]);
+    long const submission_count = std::atol(argv[2]);
+
+    mc::Stream stream{{640, 480}, mir_pixel_format_abgr_8888};
+
+    std::vector<std::shared_ptr<mg::Buffer>> buffers;
+    for (int i = 0; i != 3; ++i)
+        buffers.push_back(std::make_shared<ClientBuffer>(i + 1));
+
+    stream.submit_buffer(buffers.front());
+
+    std::atomic<bool> done{false};
+    std::vector<CompositorResult> results(compositor_count);
+    std::vector<std::thread> compositors;
+
+    auto const start = steady_clock::now();
+
+    for (auto& result : results)
+    {
+        compositors.emplace_back([&stream, &done, &result]
+            {
+                while (!done)
+                {
+                    auto const before = steady_clock::now();
+                    if (stream.buffers_ready_for_compositor(&result))
+                    {
+                        stream.lock_compositor_buffer(&result);
+                        ++result.frames;
+                    }
+                    auto const call_time = steady_clock::now() - before;
+                    ++result.calls;
+                    result.total_time += call_time;
+                    result.slowest_call = std::max<nanoseconds>(result.slowest_call, call_time);
+                }
+            });
+    }
+
+    for (long i = 0; i != submission_count; ++i)
+        stream.submit_buffer(buffers[i % buffers.size()]);
+
+    done = true;
+    for (auto& thread : compositors)
+        thread.join();
+
+    auto const duration = steady_clock::now() - start;
+    std::cout<<"Submitting "<<submission_count<<" buffers took "<<duration_cast<nanoseconds>(duration).count()<<"ns"<<std::endl;
+
+    for (auto const& result : results)
+    {
+        std::cout<<"Compositor composited "<<result.frames<<" frames, "
+                 <<"calls took "<<(result.calls ? result.total_time.count() / result.calls : 0)<<"ns on average, "
+                 <<"slowest "<<result.slowest_call.count()<<"ns"<<std::endl;
+    }
+
+    exit(0);
+}
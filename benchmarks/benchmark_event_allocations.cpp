@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/events/event_builders.h"
+#include "mir/events/event.h"
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+namespace mev = mir::events;
+
+using namespace std::chrono;
+
+// Count every heap allocation (including Cap'n Proto's calloc()ed segments)
+namespace
+{
+std::atomic<long> allocations{0};
+}
+
+extern "C"
+{
+void* __libc_malloc(size_t size);
+void* __libc_calloc(size_t count, size_t size);
+void* __libc_realloc(void* block, size_t size);
+
+void* malloc(size_t size)
+{
+    ++allocations;
+    return __libc_malloc(size);
+}
+
+void* calloc(size_t count, size_t size)
+{
+    ++allocations;
+    return __libc_calloc(count, size);
+}
+
+void* realloc(void* block, size_t size)
+{
+    ++allocations;
+    return __libc_realloc(block, size);
+}
+}
+
+namespace
+{
+struct Stage
+{
+    char const* name;
+    long allocations;
+    nanoseconds time;
+};
+
+template<typename Action>
+Stage measure(char const* name, int count, Action const& action)
+{
+    auto const allocations_before = allocations.load();
+    auto const start = steady_clock::now();
+
+    for (int i = 0; i != count; ++i)
+        action(i);
+
+    return {name, allocations - allocations_before, duration_cast<nanoseconds>(steady_clock::now() - start)};
+}
+}
+
+/*
+ * Takes pointer motion events through the steps they go through on their
+ * way to a client, counting the heap allocations each step makes.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of events>"<<std::endl;
+        exit(1);
+    }
+
+    int const event_count = std::atoi(argv[1]);
+    std::vector<uint8_t> const cookie(40, 0x5a);
+
+    std::vector<mir::EventUPtr> events;
+    std::vector<mir::EventUPtr> copies;
+    std::vector<std::string> serialized;
+    events.reserve(event_count);
+    copies.reserve(event_count);
+    serialized.reserve(event_count);
+
+    auto const make_event = [&](int i)
+        {
+            events.push_back(mev::make_event(
+                MirInputDeviceId{1}, nanoseconds{i}, cookie, mir_input_event_modifier_none,
+                mir_pointer_action_motion, 0, i % 1920, i % 1080, 0.0f, 0.0f, 1.0f, 1.0f));
+        };
+
+    // Let any per-thread caches fill up first
+    for (int i = 0; i != 100; ++i)
+        make_event(i);
+    events.clear();
+
+    std::vector<Stage> const stages{
+        measure("Building", event_count, make_event),
+        measure("Copying", event_count, [&](int i) { copies.push_back(mev::clone_event(*events[i])); }),
+        measure("Serializing", event_count, [&](int i) { serialized.push_back(MirEvent::serialize(copies[i].get())); }),
+        measure("Deserializing", event_count, [&](int i) { MirEvent::deserialize(serialized[i]); }),
+        measure("Releasing", event_count, [&](int i) { events[i].reset(); copies[i].reset(); })};
+
+    for (auto const& stage : stages)
+    {
+        std::cout<<stage.name<<": "
+                 <<static_cast<double>(stage.allocations) / event_count<<" allocations and "
+                 <<stage.time.count() / event_count<<"ns per event"<<std::endl;
+    }
+
+    exit(0);
+}
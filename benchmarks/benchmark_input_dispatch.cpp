@@ -0,0 +1,209 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/surface_input_dispatcher.h"
+#include "src/server/scene/surface_stack.h"
+#include "src/server/scene/basic_surface.h"
+#include "src/server/report/null/scene_report.h"
+#include "src/server/compositor/stream.h"
+#include "mir/events/event_builders.h"
+#include "mir/graphics/buffer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace ms = mir::scene;
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+class ClientBuffer : public mg::Buffer
+{
+public:
+    ClientBuffer(geom::Size size) : size_{size} {}
+
+    std::shared_ptr<mg::NativeBuffer> native_buffer_handle() const override { return nullptr; }
+    mg::BufferID id() const override { return id_; }
+    geom::Size size() const override { return size_; }
+    MirPixelFormat pixel_format() const override { return mir_pixel_format_abgr_8888; }
+    mg::NativeBufferBase* native_buffer_base() override { return nullptr; }
+
+private:
+    mg::BufferID const id_;
+    geom::Size const size_;
+};
+
+auto make_surface(ms::SurfaceStack& stack, geom::Rectangle const& rect)
+    -> std::shared_ptr<ms::BasicSurface>
+{
+    auto const report = std::make_shared<mir::report::null::SceneReport>();
+    auto const stream = std::make_shared<mc::Stream>(rect.size, mir_pixel_format_abgr_8888);
+    stream->submit_buffer(std::make_shared<ClientBuffer>(rect.size));
+    auto const surface = std::make_shared<ms::BasicSurface>(
+        "surface",
+        rect,
+        mir_pointer_unconfined,
+        std::list<ms::StreamInfo>{{stream, {}, {}}},
+        nullptr,
+        report);
+    stack.add_surface(surface, mi::InputReceptionMode::normal);
+    return surface;
+}
+
+auto touch(MirInputDeviceId device, MirTouchAction action, geom::Point const& point) -> std::shared_ptr<MirEvent const>
+{
+    auto event = mev::make_event(
+        device, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{}, mir_input_event_modifier_none);
+    mev::add_touch(*event, 0, action, mir_touch_tooltype_finger, point.x.as_int(), point.y.as_int(), 1, 1, 1, 1);
+    return event;
+}
+
+auto motion(MirInputDeviceId device, geom::Point const& point) -> std::shared_ptr<MirEvent const>
+{
+    return mev::make_event(
+        device, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{},
+        mir_input_event_modifier_none, mir_pointer_action_motion, 0,
+        point.x.as_int(), point.y.as_int(), 0.0f, 0.0f, 1.0f, 1.0f);
+}
+
+auto key(MirInputDeviceId device, MirKeyboardAction action) -> std::shared_ptr<MirEvent const>
+{
+    return mev::make_event(
+        device, steady_clock::now().time_since_epoch(), std::vector<uint8_t>{},
+        action, 0, 30, mir_input_event_modifier_none);
+}
+
+struct Latency
+{
+    void add(nanoseconds latency)
+    {
+        total += latency;
+        worst = std::max(worst, latency);
+        ++count;
+    }
+
+    void print(char const* what) const
+    {
+        std::cout<<what<<" took "<<(count ? total.count() / count : 0)<<"ns on average, "
+                 <<duration_cast<microseconds>(worst).count()<<"us at worst"<<std::endl;
+    }
+
+    nanoseconds total{0};
+    nanoseconds worst{0};
+    int count{0};
+};
+}
+
+/*
+ * Replays an interleaved trace from several input devices on one thread,
+ * as the input platform delivers them: busy touch panels, a keyboard typing
+ * into one client and a pointer moving around another. Meanwhile the shell
+ * moves the surface under the pointer about on a thread of its own. Reports
+ * how long dispatch takes for each kind of device, and how long the shell's
+ * moves take.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of touch panels> <events per device>"<<std::endl;
+        exit(1);
+    }
+
+    int const panel_count = std::atoi(argv[1]);
+    int const event_count = std::atoi(argv[2]);
+
+    auto const stack = std::make_shared<ms::SurfaceStack>(std::make_shared<mir::report::null::SceneReport>());
+
+    // A column of touch panel clients down the left, and keyboard and pointer clients to their right
+    for (int i = 0; i != panel_count; ++i)
+        make_surface(*stack, {{0, 100 * i}, {100, 100}});
+    auto const typed_into = make_surface(*stack, {{200, 0}, {100, 100}});
+    auto const pointed_at = make_surface(*stack, {{400, 0}, {100, 100}});
+
+    mi::SurfaceInputDispatcher dispatcher{stack};
+    dispatcher.start();
+    dispatcher.set_focus(typed_into);
+
+    Latency touch_latency;
+    Latency pointer_latency;
+    Latency key_latency;
+    Latency move_latency;
+
+    std::atomic<bool> done{false};
+    std::thread shell{[&]
+        {
+            for (int j = 0; !done; ++j)
+            {
+                auto const before = steady_clock::now();
+                pointed_at->move_to({400 + j % 7, 0});
+                move_latency.add(steady_clock::now() - before);
+                std::this_thread::sleep_for(microseconds{500});
+            }
+        }};
+
+    auto const timed_dispatch = [&dispatcher](Latency& latency, std::shared_ptr<MirEvent const> const& event)
+        {
+            auto const before = steady_clock::now();
+            dispatcher.dispatch(event);
+            latency.add(steady_clock::now() - before);
+        };
+
+    auto const start = steady_clock::now();
+
+    for (int j = 0; j != event_count; ++j)
+    {
+        for (int i = 0; i != panel_count; ++i)
+        {
+            MirInputDeviceId const device = 100 + i;
+            geom::Point const point{50, 100 * i + 50};
+            auto const action =
+                j % 10 == 0 ? mir_touch_action_down :
+                j % 10 == 9 ? mir_touch_action_up :
+                mir_touch_action_change;
+
+            timed_dispatch(touch_latency, touch(device, action, point));
+        }
+
+        timed_dispatch(pointer_latency, motion(MirInputDeviceId{2}, {400 + j % 100, j % 100}));
+        timed_dispatch(key_latency, key(MirInputDeviceId{1}, j % 2 ? mir_keyboard_action_up : mir_keyboard_action_down));
+    }
+
+    auto const duration = steady_clock::now() - start;
+
+    done = true;
+    shell.join();
+
+    std::cout<<"Replaying "<<event_count<<" events from each of "<<panel_count + 2<<" devices took "
+             <<duration_cast<milliseconds>(duration).count()<<"ms"<<std::endl;
+    touch_latency.print("Touch dispatch");
+    pointer_latency.print("Pointer dispatch");
+    key_latency.print("Key dispatch");
+    move_latency.print("Shell surface moves");
+
+    dispatcher.stop();
+    exit(0);
+}
@@ -0,0 +1,131 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/surface_stack.h"
+#include "src/server/scene/basic_surface.h"
+#include "src/server/report/null/scene_report.h"
+#include "src/server/compositor/stream.h"
+#include "mir/input/surface.h"
+#include "mir/graphics/buffer.h"
+
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <vector>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace ms = mir::scene;
+namespace mi = mir::input;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+class ClientBuffer : public mg::Buffer
+{
+public:
+    ClientBuffer(geom::Size size) : size_{size} {}
+
+    std::shared_ptr<mg::NativeBuffer> native_buffer_handle() const override { return nullptr; }
+    mg::BufferID id() const override { return id_; }
+    geom::Size size() const override { return size_; }
+    MirPixelFormat pixel_format() const override { return mir_pixel_format_abgr_8888; }
+    mg::NativeBufferBase* native_buffer_base() override { return nullptr; }
+
+private:
+    mg::BufferID const id_;
+    geom::Size const size_;
+};
+}
+
+/*
+ * Scatters surfaces over a 4K desktop and finds the surface under random
+ * points, both through SurfaceStack::surface_at() and by walking every
+ * surface (as hit-testing used to).
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of surfaces> <number of lookups>"<<std::endl;
+        exit(1);
+    }
+
+    int const surface_count = std::atoi(argv[1]);
+    int const lookup_count = std::atoi(argv[2]);
+
+    geom::Size const desktop{3840, 2160};
+    auto const report = std::make_shared<mir::report::null::SceneReport>();
+
+    std::mt19937 random;
+    std::uniform_int_distribution<int> x(0, desktop.width.as_int() - 1);
+    std::uniform_int_distribution<int> y(0, desktop.height.as_int() - 1);
+    std::uniform_int_distribution<int> width(50, 800);
+    std::uniform_int_distribution<int> height(50, 600);
+
+    ms::SurfaceStack stack{report};
+    for (int i = 0; i != surface_count; ++i)
+    {
+        geom::Rectangle const rect{{x(random), y(random)}, {width(random), height(random)}};
+        auto const stream = std::make_shared<mc::Stream>(rect.size, mir_pixel_format_abgr_8888);
+        stream->submit_buffer(std::make_shared<ClientBuffer>(rect.size));
+        auto const surface = std::make_shared<ms::BasicSurface>(
+            "surface",
+            rect,
+            mir_pointer_unconfined,
+            std::list<ms::StreamInfo>{{stream, {}, {}}},
+            nullptr,
+            report);
+        stack.add_surface(surface, mi::InputReceptionMode::normal);
+    }
+
+    std::vector<geom::Point> points;
+    for (int i = 0; i != lookup_count; ++i)
+        points.emplace_back(x(random), y(random));
+
+    int hits = 0;
+    auto start = steady_clock::now();
+    for (auto const& point : points)
+    {
+        if (stack.surface_at(point))
+            ++hits;
+    }
+    auto const indexed = steady_clock::now() - start;
+
+    int walked_hits = 0;
+    start = steady_clock::now();
+    for (auto const& point : points)
+    {
+        std::shared_ptr<mi::Surface> top;
+        stack.for_each([&](std::shared_ptr<mi::Surface> const& surface)
+            {
+                if (surface->input_area_contains(point))
+                    top = surface;
+            });
+        if (top)
+            ++walked_hits;
+    }
+    auto const walked = steady_clock::now() - start;
+
+    std::cout<<lookup_count<<" lookups among "<<surface_count<<" surfaces ("<<hits<<" hits)"<<std::endl;
+    std::cout<<"surface_at() took "<<duration_cast<nanoseconds>(indexed).count() / lookup_count<<"ns per lookup"<<std::endl;
+    std::cout<<"Walking every surface ("<<walked_hits<<" hits) took "
+             <<duration_cast<nanoseconds>(walked).count() / lookup_count<<"ns per lookup"<<std::endl;
+
+    exit(0);
+}
@@ -0,0 +1,95 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/wayland_executor.h"
+
+#include <wayland-server-core.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+namespace mf = mir::frontend;
+
+using namespace std::chrono;
+
+/*
+ * Spawns work onto a Wayland event loop from several threads at once (as
+ * the input and compositor threads do) and measures how long it takes for
+ * all of it to run, and how many times the loop had to wake up to run it.
+ */
+int main(int argc, char** argv)
+{
+    if (argc != 3)
+    {
+        std::cout<<"Usage: "<<argv[0]<<" <number of threads> <spawns per thread>"<<std::endl;
+        exit(1);
+    }
+
+    int const thread_count = std::atoi(argv[1]);
+    long const spawn_count = std::atol(argv[2]);
+    long const total = thread_count * spawn_count;
+
+    auto const loop = wl_event_loop_create();
+    long executed{0};
+    long wakeups{0};
+
+    {
+        mf::WaylandExecutor executor{loop};
+
+        // Get the executor going on this thread before timing anything
+        executor.spawn([]{});
+        wl_event_loop_dispatch(loop, -1);
+
+        std::atomic<bool> go{false};
+        std::vector<std::thread> spawners;
+        for (int i = 0; i != thread_count; ++i)
+        {
+            spawners.emplace_back(
+                [&]
+                {
+                    while (!go)
+                        std::this_thread::yield();
+
+                    for (long j = 0; j != spawn_count; ++j)
+                        executor.spawn([&executed] { ++executed; });
+                });
+        }
+
+        auto const start = steady_clock::now();
+        go = true;
+
+        while (executed != total)
+        {
+            wl_event_loop_dispatch(loop, -1);
+            ++wakeups;
+        }
+
+        auto const duration = steady_clock::now() - start;
+
+        for (auto& spawner : spawners)
+            spawner.join();
+
+        std::cout<<"Running "<<total<<" spawned tasks from "<<thread_count<<" threads took "
+                 <<duration_cast<nanoseconds>(duration).count() / total<<"ns per task, in "
+                 <<wakeups<<" wakeups"<<std::endl;
+    }
+
+    wl_event_loop_destroy(loop);
+    exit(0);
+}
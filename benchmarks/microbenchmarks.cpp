@@ -0,0 +1,435 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/surface_stack.h"
+#include "src/server/scene/basic_surface.h"
+#include "src/server/compositor/stream.h"
+#include "src/server/compositor/multi_monitor_arbiter.h"
+#include "src/server/compositor/queueing_schedule.h"
+#include "src/server/compositor/occlusion.h"
+#include "src/server/input/surface_input_dispatcher.h"
+#include "src/server/input/default_event_builder.h"
+#include "src/server/report/null/scene_report.h"
+#include "src/renderers/sw/renderer.h"
+#include "mir/compositor/display_buffer_compositor.h"
+#include "mir/compositor/scene_element.h"
+#include "mir/cookie/authority.h"
+#include "mir/events/event_builders.h"
+#include "mir/graphics/buffer_properties.h"
+#include "mir/graphics/display_buffer.h"
+#include "mir/renderer/sw/pixel_target.h"
+
+#include "mir_test_framework/headless_display_buffer_compositor_factory.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_display_buffer.h"
+
+#include <chrono>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <linux/input.h>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace ms = mir::scene;
+namespace mi = mir::input;
+namespace mev = mir::events;
+namespace mrs = mir::renderer::software;
+namespace mtd = mir::test::doubles;
+namespace mtf = mir_test_framework;
+namespace geom = mir::geometry;
+
+using namespace std::chrono;
+
+namespace
+{
+geom::Rectangle const screen{{0, 0}, {1920, 1080}};
+
+/// Runs a benchmark the given number of times
+using Run = std::function<void(long iterations)>;
+
+struct Benchmark
+{
+    std::string name;
+    std::vector<int> sizes;
+    std::function<Run(int size)> set_up;
+};
+
+struct Result
+{
+    std::string name;
+    long iterations;
+    double real_ns;
+    double cpu_ns;
+};
+
+std::vector<int> const surface_counts{1, 10, 100, 1000, 10000};
+
+auto a_buffer(geom::Size size) -> std::shared_ptr<mg::Buffer>
+{
+    return std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{size, mir_pixel_format_xbgr_8888, mg::BufferUsage::software});
+}
+
+/// A stack of count opaque surfaces scattered over (and overlapping) the screen
+struct Scene
+{
+    explicit Scene(int count)
+    {
+        for (int i = 0; i != count; ++i)
+        {
+            geom::Rectangle const rect{
+                {(i * 397) % screen.size.width.as_int() - 100, (i * 211) % screen.size.height.as_int() - 100},
+                {300, 200}};
+            auto const stream = std::make_shared<mc::Stream>(rect.size, mir_pixel_format_xbgr_8888);
+            stream->submit_buffer(a_buffer(rect.size));
+
+            auto const surface = std::make_shared<ms::BasicSurface>(
+                "surface",
+                rect,
+                mir_pointer_unconfined,
+                std::list<ms::StreamInfo>{{stream, {}, {}}},
+                nullptr,
+                report);
+            stack->add_surface(surface, mi::InputReceptionMode::normal);
+            surfaces.push_back(surface);
+        }
+    }
+
+    std::shared_ptr<ms::SceneReport> const report{std::make_shared<mir::report::null::SceneReport>()};
+    std::shared_ptr<ms::SurfaceStack> const stack{std::make_shared<ms::SurfaceStack>(report)};
+    std::vector<std::shared_ptr<ms::BasicSurface>> surfaces;
+};
+
+/// An output drawn in memory, as a software renderer target
+class MemoryDisplayBuffer :
+    public mg::DisplayBuffer,
+    public mg::NativeDisplayBuffer,
+    public mrs::PixelTarget
+{
+public:
+    explicit MemoryDisplayBuffer(geom::Rectangle const& area)
+        : area{area},
+          frame(area.size.width.as_int() * area.size.height.as_int())
+    {
+    }
+
+    geom::Rectangle view_area() const override { return area; }
+    bool overlay(mg::RenderableList const&) override { return false; }
+    glm::mat2 transformation() const override { return glm::mat2{1}; }
+    mg::NativeDisplayBuffer* native_display_buffer() override { return this; }
+
+    geom::Size size() const override { return area.size; }
+    geom::Stride stride() const override { return geom::Stride{area.size.width.as_int() * 4}; }
+    unsigned char* pixels() override { return reinterpret_cast<unsigned char*>(frame.data()); }
+    unsigned int buffer_age() const override { return 0; }
+    void swap_buffers() override {}
+
+private:
+    geom::Rectangle const area;
+    std::vector<uint32_t> frame;
+};
+
+std::vector<Benchmark> const benchmarks{
+    {"SurfaceStack::scene_elements_for", surface_counts, [](int count) -> Run
+        {
+            auto const scene = std::make_shared<Scene>(count);
+            return [scene](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        scene->stack->scene_elements_for(scene.get());
+                };
+        }},
+
+    {"filter_occlusions_from", surface_counts, [](int count) -> Run
+        {
+            auto const scene = std::make_shared<Scene>(count);
+            return [scene](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                    {
+                        // Taking the elements is measured above; it's the filtering we want here
+                        auto elements = scene->stack->scene_elements_for(scene.get());
+                        mc::filter_occlusions_from(elements, screen);
+                    }
+                };
+        }},
+
+    {"HeadlessDisplayBufferCompositor::composite", {1, 10, 100, 1000}, [](int count) -> Run
+        {
+            auto const scene = std::make_shared<Scene>(count);
+            auto const display_buffer = std::make_shared<mtd::StubDisplayBuffer>(screen);
+            std::shared_ptr<mc::DisplayBufferCompositor> const compositor{
+                mtf::HeadlessDisplayBufferCompositorFactory{}.create_compositor_for(*display_buffer)};
+            return [scene, display_buffer, compositor](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        compositor->composite(scene->stack->scene_elements_for(compositor.get()));
+                };
+        }},
+
+    {"software::Renderer::render", {1, 10, 100}, [](int count) -> Run
+        {
+            auto const scene = std::make_shared<Scene>(count);
+            auto const display_buffer = std::make_shared<MemoryDisplayBuffer>(screen);
+            auto const renderer = std::make_shared<mrs::Renderer>(*display_buffer);
+            renderer->set_viewport(screen);
+
+            auto const renderables = std::make_shared<mg::RenderableList>();
+            for (auto const& element : scene->stack->scene_elements_for(scene.get()))
+                renderables->push_back(element->renderable());
+
+            return [scene, display_buffer, renderer, renderables](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        renderer->render(*renderables);
+                };
+        }},
+
+    {"Stream::submit_buffer+lock_compositor_buffer", {1}, [](int) -> Run
+        {
+            auto const stream = std::make_shared<mc::Stream>(geom::Size{640, 480}, mir_pixel_format_xbgr_8888);
+            auto const buffers = std::make_shared<std::vector<std::shared_ptr<mg::Buffer>>>();
+            for (int i = 0; i != 3; ++i)
+                buffers->push_back(a_buffer({640, 480}));
+
+            return [stream, buffers](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                    {
+                        stream->submit_buffer((*buffers)[i % buffers->size()]);
+                        stream->lock_compositor_buffer(stream.get());
+                    }
+                };
+        }},
+
+    {"MultiMonitorArbiter::compositor_acquire", {1, 2, 4}, [](int monitors) -> Run
+        {
+            auto const schedule = std::make_shared<mc::QueueingSchedule>();
+            auto const arbiter = std::make_shared<mc::MultiMonitorArbiter>(schedule);
+            auto const buffers = std::make_shared<std::vector<std::shared_ptr<mg::Buffer>>>();
+            for (int i = 0; i != 3; ++i)
+                buffers->push_back(a_buffer({640, 480}));
+
+            return [schedule, arbiter, buffers, monitors](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                    {
+                        schedule->schedule((*buffers)[i % buffers->size()]);
+                        for (int monitor = 0; monitor != monitors; ++monitor)
+                            arbiter->compositor_acquire(&(*buffers)[monitor % buffers->size()]);
+                    }
+                };
+        }},
+
+    {"DefaultEventBuilder::key_event", {1}, [](int) -> Run
+        {
+            auto const builder = std::make_shared<mi::DefaultEventBuilder>(
+                MirInputDeviceId{1}, mir::cookie::Authority::create(), nullptr);
+            return [builder](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        builder->key_event(nanoseconds{i}, mir_keyboard_action_down, 0, KEY_A);
+                };
+        }},
+
+    {"DefaultEventBuilder::pointer_event", {1}, [](int) -> Run
+        {
+            auto const builder = std::make_shared<mi::DefaultEventBuilder>(
+                MirInputDeviceId{2}, mir::cookie::Authority::create(), nullptr);
+            return [builder](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        builder->pointer_event(nanoseconds{i}, mir_pointer_action_motion, 0, 0.0f, 0.0f, 1.0f, 1.0f);
+                };
+        }},
+
+    {"DefaultEventBuilder::touch_event", {1, 10}, [](int contacts) -> Run
+        {
+            auto const builder = std::make_shared<mi::DefaultEventBuilder>(
+                MirInputDeviceId{3}, mir::cookie::Authority::create(), nullptr);
+            std::vector<mev::ContactState> touches;
+            for (int i = 0; i != contacts; ++i)
+                touches.push_back({i, mir_touch_action_change, mir_touch_tooltype_finger, 10.0f * i, 10.0f, 1, 5, 5, 0});
+            return [builder, touches](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        builder->touch_event(nanoseconds{i}, touches);
+                };
+        }},
+
+    {"SurfaceInputDispatcher::dispatch", surface_counts, [](int count) -> Run
+        {
+            auto const scene = std::make_shared<Scene>(count);
+            auto const dispatcher = std::make_shared<mi::SurfaceInputDispatcher>(scene->stack);
+            dispatcher->start();
+
+            // Move the pointer over the screen, in and out of surfaces
+            auto const motion = std::make_shared<std::vector<std::shared_ptr<MirEvent const>>>();
+            for (int i = 0; i != 64; ++i)
+            {
+                motion->push_back(mev::make_event(
+                    MirInputDeviceId{2}, nanoseconds{i}, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+                    mir_pointer_action_motion, 0,
+                    (i * 131) % screen.size.width.as_int(), (i * 71) % screen.size.height.as_int(),
+                    0.0f, 0.0f, 1.0f, 1.0f));
+            }
+
+            return [scene, dispatcher, motion](long iterations)
+                {
+                    for (long i = 0; i != iterations; ++i)
+                        dispatcher->dispatch((*motion)[i % motion->size()]);
+                };
+        }},
+};
+
+double cpu_seconds()
+{
+    timespec now;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &now);
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+/// Runs enough iterations to take at least min_time, after a short warm up
+auto measure(std::string const& name, Run const& run, duration<double> min_time) -> Result
+{
+    long iterations = 1;
+    for (;;)
+    {
+        auto const start = steady_clock::now();
+        auto const start_cpu = cpu_seconds();
+        run(iterations);
+        duration<double> const real = steady_clock::now() - start;
+        auto const cpu = cpu_seconds() - start_cpu;
+
+        if (real >= min_time || iterations >= 1000000000)
+            return {name, iterations, real.count() * 1e9 / iterations, cpu * 1e9 / iterations};
+
+        // Aim a bit over, so as not to go round again
+        auto const wanted = real.count() > 0 ? 1.4 * min_time.count() / real.count() * iterations : 10.0 * iterations;
+        iterations = std::max(iterations + 1, std::min(static_cast<long>(wanted), 10 * iterations));
+    }
+}
+
+std::string json_string(std::string const& text)
+{
+    std::string quoted{"\""};
+    for (auto c : text)
+    {
+        if (c == '"' || c == '\\')
+            quoted += '\\';
+        quoted += c;
+    }
+    return quoted + "\"";
+}
+
+void write_json(std::ostream& out, char const* executable, std::vector<Result> const& results)
+{
+    auto const now = std::time(nullptr);
+    char date[64];
+    std::strftime(date, sizeof date, "%FT%T%z", std::localtime(&now));
+
+    out << "{\n"
+        << "  \"context\": {\n"
+        << "    \"date\": " << json_string(date) << ",\n"
+        << "    \"executable\": " << json_string(executable) << ",\n"
+        << "    \"num_cpus\": " << std::thread::hardware_concurrency() << "\n"
+        << "  },\n"
+        << "  \"benchmarks\": [";
+
+    for (auto i = 0u; i != results.size(); ++i)
+    {
+        auto const& result = results[i];
+        out << (i ? ",\n" : "\n")
+            << "    {\n"
+            << "      \"name\": " << json_string(result.name) << ",\n"
+            << "      \"iterations\": " << result.iterations << ",\n"
+            << "      \"real_time\": " << std::fixed << std::setprecision(3) << result.real_ns << ",\n"
+            << "      \"cpu_time\": " << result.cpu_ns << ",\n"
+            << "      \"time_unit\": \"ns\"\n"
+            << "    }";
+    }
+
+    out << "\n  ]\n}" << std::endl;
+}
+}
+
+/*
+ * Times the server's per-frame and per-event hot paths in isolation, on stub
+ * buffers and a headless compositor, at scene sizes from 1 to 10,000
+ * surfaces.
+ *
+ * --benchmark_format=json writes the results in the same layout as Google
+ * Benchmark, so they can be kept and compared between releases with its
+ * tools/compare.py.
+ */
+int main(int argc, char** argv)
+{
+    std::string filter;
+    duration<double> min_time{0.5};
+    bool json = false;
+
+    for (int i = 1; i != argc; ++i)
+    {
+        std::string const arg{argv[i]};
+        if (arg.compare(0, 19, "--benchmark_filter=") == 0)
+            filter = arg.substr(19);
+        else if (arg.compare(0, 21, "--benchmark_min_time=") == 0)
+            min_time = duration<double>{std::atof(arg.substr(21).c_str())};
+        else if (arg == "--benchmark_format=json")
+            json = true;
+        else if (arg != "--benchmark_format=console")
+        {
+            std::cout<<"Usage: "<<argv[0]<<" [--benchmark_filter=<substring of name>] "
+                     <<"[--benchmark_min_time=<seconds>] [--benchmark_format={console,json}]"<<std::endl;
+            exit(1);
+        }
+    }
+
+    std::vector<Result> results;
+    for (auto const& benchmark : benchmarks)
+    {
+        for (auto size : benchmark.sizes)
+        {
+            auto const name = benchmark.name + "/" + std::to_string(size);
+            if (name.find(filter) == std::string::npos)
+                continue;
+
+            results.push_back(measure(name, benchmark.set_up(size), min_time));
+
+            if (!json)
+            {
+                auto const& result = results.back();
+                std::cout<<std::left<<std::setw(56)<<result.name<<std::right
+                         <<std::fixed<<std::setprecision(1)
+                         <<std::setw(14)<<result.real_ns<<" ns"
+                         <<std::setw(14)<<result.cpu_ns<<" ns"
+                         <<std::setw(12)<<result.iterations<<std::endl;
+            }
+        }
+    }
+
+    if (json)
+        write_json(std::cout, argv[0], results);
+
+    exit(0);
+}
@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GEOMETRY_REGION_H_
+#define MIR_GEOMETRY_REGION_H_
+
+#include "mir/geometry/point.h"
+#include "mir/geometry/rectangle.h"
+
+#include <vector>
+#include <initializer_list>
+#include <iosfwd>
+
+namespace mir
+{
+namespace geometry
+{
+
+/**
+ * An arbitrary area made up of rectangles, supporting set operations.
+ *
+ * The area is held as horizontal bands of non-overlapping rectangles,
+ * ordered top-to-bottom and then left-to-right. Vertically adjacent bands
+ * with identical spans are merged, so equal areas compare equal.
+ */
+class Region
+{
+public:
+    Region();
+    Region(Rectangle const& rect);
+    Region(std::initializer_list<Rectangle> const& rects);
+    /* We want to keep implicit copy and move methods */
+
+    bool is_empty() const;
+    bool contains(Point const& point) const;
+    bool contains(Rectangle const& rect) const;
+    bool overlaps(Rectangle const& rect) const;
+    Rectangle bounding_rectangle() const;
+
+    /// The non-overlapping rectangles that make up the region, in band order
+    std::vector<Rectangle> const& rectangles() const;
+
+    void add(Rectangle const& rect);
+    void add(Region const& region);
+    void subtract(Rectangle const& rect);
+    void subtract(Region const& region);
+    void intersect(Rectangle const& rect);
+    void intersect(Region const& region);
+
+    Region intersection_with(Rectangle const& rect) const;
+
+    bool operator==(Region const& other) const;
+    bool operator!=(Region const& other) const;
+
+private:
+    std::vector<Rectangle> rects;
+};
+
+std::ostream& operator<<(std::ostream& out, Region const& value);
+
+}
+}
+
+#endif /* MIR_GEOMETRY_REGION_H_ */
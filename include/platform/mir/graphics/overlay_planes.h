@@ -0,0 +1,54 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_OVERLAY_PLANES_H_
+#define MIR_GRAPHICS_OVERLAY_PLANES_H_
+
+#include <mir/graphics/renderable.h>
+
+namespace mir
+{
+namespace graphics
+{
+
+/**
+ * A NativeDisplayBuffer that can show some renderables on hardware planes,
+ * over the composited frame, when it cannot overlay() all of them.
+ */
+class OverlayPlanes
+{
+public:
+    virtual ~OverlayPlanes() = default;
+
+    /**
+     * Chooses renderables to show on planes when the display buffer is next
+     * posted, and holds their buffers until they are no longer shown.
+     *
+     * \param [in] renderables  What should appear on the screen, bottom to top
+     * \returns  The renderables left to composite, still in order
+     */
+    virtual RenderableList assign_planes(RenderableList const& renderables) = 0;
+
+protected:
+    OverlayPlanes() = default;
+    OverlayPlanes(OverlayPlanes const&) = delete;
+    OverlayPlanes& operator=(OverlayPlanes const&) = delete;
+};
+
+}
+}
+
+#endif /* MIR_GRAPHICS_OVERLAY_PLANES_H_ */
@@ -0,0 +1,64 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_PIXEL_TARGET_H_
+#define MIR_RENDERER_SW_PIXEL_TARGET_H_
+
+#include "mir/geometry/dimensions.h"
+#include "mir/geometry/size.h"
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+
+/**
+ * A display buffer the CPU can draw into directly.
+ *
+ * The pixels are mir_pixel_format_xrgb_8888, and the size is that of the
+ * display buffer's view area after its transformation.
+ */
+class PixelTarget
+{
+public:
+    virtual ~PixelTarget() = default;
+
+    virtual geometry::Size size() const = 0;
+    virtual geometry::Stride stride() const = 0;
+
+    /** The pixels of the frame to be drawn next. */
+    virtual unsigned char* pixels() = 0;
+    /**
+     * How many swaps ago the pixels of the next frame were last drawn, or
+     * zero if they can't be relied on (as for EGL_EXT_buffer_age).
+     */
+    virtual unsigned int buffer_age() const = 0;
+    /** Shows the frame drawn, and moves on to the next. */
+    virtual void swap_buffers() = 0;
+
+protected:
+    PixelTarget() = default;
+    PixelTarget(PixelTarget const&) = delete;
+    PixelTarget& operator=(PixelTarget const&) = delete;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_PIXEL_TARGET_H_ */
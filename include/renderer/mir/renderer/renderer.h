@@ -20,9 +20,12 @@
 #define MIR_RENDERER_RENDERER_H_
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/rectangles.h"
+#include "mir/geometry/region.h"
 #include "mir/graphics/renderable.h"
 #include "mir_toolkit/common.h"
 #include <glm/glm.hpp>
+#include <unordered_map>
 
 namespace mir
 {
@@ -34,10 +37,31 @@ class Renderer
 public:
     virtual ~Renderer() = default;
 
+    /// The parts of renderables (by Renderable::ID) that are not hidden by others
+    typedef std::unordered_map<graphics::Renderable::ID, geometry::Region> VisibleRegions;
+
     virtual void set_viewport(geometry::Rectangle const& rect) = 0;
     virtual void set_output_transform(glm::mat2 const&) = 0;
+    /**
+     * Limits the next render() to the damaged areas of the viewport; the
+     * rest of the output is unchanged since the previous render(). Renderers
+     * are free to redraw more than this, and an empty set of damage means
+     * nothing changed. Without a call to set_damage() everything is redrawn.
+     */
+    virtual void set_damage(geometry::Rectangles const& damage) = 0;
+    /**
+     * Hints that only the given regions (in screen coordinates) of some of
+     * the renderables passed to the next render() can be seen. Renderables
+     * without an entry are drawn in full.
+     */
+    virtual void set_visible_regions(VisibleRegions const& regions) = 0;
     virtual void render(graphics::RenderableList const&) const = 0;
     virtual void suspend() = 0; // called when render() is skipped
+    /**
+     * How many bytes of client pixels the last render() had to copy (to
+     * textures, say) before it could draw them.
+     */
+    virtual size_t bytes_copied() const = 0;
 
 protected:
     Renderer() = default;
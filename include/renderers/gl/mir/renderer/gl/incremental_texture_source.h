@@ -0,0 +1,60 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_GL_INCREMENTAL_TEXTURE_SOURCE_H_
+#define MIR_RENDERER_GL_INCREMENTAL_TEXTURE_SOURCE_H_
+
+#include "mir/graphics/buffer_id.h"
+
+#include <cstddef>
+
+namespace mir
+{
+namespace renderer
+{
+namespace gl
+{
+
+/**
+ * Optional interface of a TextureSource that knows where it differs from
+ * buffers submitted before it, so that a texture still holding one of
+ * those need only be partly updated. Its pixels are copied from memory, so
+ * TextureSource::bind() copies the whole buffer.
+ */
+class IncrementalTextureSource
+{
+public:
+    virtual ~IncrementalTextureSource() = default;
+
+    /**
+     * Uploads to the bound texture, which holds the contents of the buffer
+     * \a texture_contents. Everything is uploaded (as by
+     * TextureSource::bind()) if the difference between the two is unknown.
+     *   \returns the number of bytes uploaded
+     */
+    virtual size_t bind_over(graphics::BufferID texture_contents) = 0;
+
+protected:
+    IncrementalTextureSource() = default;
+    IncrementalTextureSource(IncrementalTextureSource const&) = delete;
+    IncrementalTextureSource& operator=(IncrementalTextureSource const&) = delete;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_GL_INCREMENTAL_TEXTURE_SOURCE_H_ */
@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_GL_PARTIAL_REDRAW_TARGET_H_
+#define MIR_RENDERER_GL_PARTIAL_REDRAW_TARGET_H_
+
+#include "mir/geometry/rectangles.h"
+
+namespace mir
+{
+namespace renderer
+{
+namespace gl
+{
+
+/**
+ * Optional interface of a RenderTarget that preserves the contents of its
+ * buffers between frames, so that only changed regions need to be redrawn.
+ */
+class PartialRedrawTarget
+{
+public:
+    virtual ~PartialRedrawTarget() = default;
+
+    /**
+     * The number of swaps since the current back buffer was last the
+     * front buffer (as EGL_EXT_buffer_age). Zero means the contents of the
+     * back buffer are undefined and everything must be redrawn.
+     */
+    virtual unsigned int buffer_age() = 0;
+
+    /**
+     * Swap buffers, hinting that only damage has changed since the last swap.
+     * The damage is in render target pixels, with the origin top-left.
+     */
+    virtual void swap_buffers_with_damage(geometry::Rectangles const& damage) = 0;
+
+protected:
+    PartialRedrawTarget() = default;
+    PartialRedrawTarget(PartialRedrawTarget const&) = delete;
+    PartialRedrawTarget& operator=(PartialRedrawTarget const&) = delete;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_GL_PARTIAL_REDRAW_TARGET_H_ */
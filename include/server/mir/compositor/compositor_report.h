@@ -21,6 +21,8 @@
 
 #include "mir/graphics/renderable.h"
 
+#include <chrono>
+
 namespace mir
 {
 namespace compositor
@@ -38,6 +40,20 @@ public:
     virtual void started() = 0;
     virtual void stopped() = 0;
     virtual void scheduled() = 0;
+    /**
+     * The compositor expects the next frame of \a id to be shown at
+     * \a vblank, and plans on it taking \a render_time to composite.
+     */
+    virtual void predicted_frame(
+        SubCompositorId id,
+        std::chrono::steady_clock::time_point vblank,
+        std::chrono::nanoseconds refresh_interval,
+        std::chrono::nanoseconds render_time) = 0;
+    /**
+     * Rendering the current frame of \a id copied \a bytes of client
+     * pixels (to textures, say) before drawing them.
+     */
+    virtual void copied_bytes(SubCompositorId id, size_t bytes) = 0;
 protected:
     CompositorReport() = default;
     virtual ~CompositorReport() = default;
@@ -19,6 +19,8 @@
 #ifndef MIR_SCENE_OBSERVER_H_
 #define MIR_SCENE_OBSERVER_H_
 
+#include "mir/geometry/forward.h"
+
 #include <memory>
 
 namespace mir
@@ -41,6 +43,10 @@ public:
     /// and will require full recomposition.
     virtual void scene_changed() = 0;
 
+    /// Used to indicate that only \a damage (in scene coordinates) has changed
+    /// beyond the present surfaces, for example where an input visualization moved.
+    virtual void scene_damaged(geometry::Rectangle const& damage) = 0;
+
     /// Called at observer registration to notify of already existing surfaces.
     virtual void surface_exists(std::shared_ptr<Surface> const& surface) = 0;
 
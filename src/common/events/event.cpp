@@ -26,6 +26,7 @@
 #include "mir/events/keyboard_event.h"
 #include "mir/events/keymap_event.h"
 #include "mir/events/touch_event.h"
+#include "mir/events/pointer_event.h"
 #include "mir/events/orientation_event.h"
 #include "mir/events/prompt_session_event.h"
 #include "mir/events/resize_event.h"
@@ -36,9 +37,58 @@
 
 #include <capnp/serialize.h>
 
+#include <array>
+#include <new>
 
 namespace ml = mir::logging;
 
+namespace
+{
+// Every event is allocated as a MirEvent sized block, so they can all share the free list
+static_assert(sizeof(MirInputEvent) == sizeof(MirEvent), "Events must not add data members");
+static_assert(sizeof(MirKeyboardEvent) == sizeof(MirEvent), "Events must not add data members");
+static_assert(sizeof(MirPointerEvent) == sizeof(MirEvent), "Events must not add data members");
+static_assert(sizeof(MirTouchEvent) == sizeof(MirEvent), "Events must not add data members");
+static_assert(sizeof(MirInputDeviceStateEvent) == sizeof(MirEvent), "Events must not add data members");
+
+size_t const max_free_events = 64;
+
+struct FreeEvents
+{
+    ~FreeEvents();
+
+    std::array<void*, max_free_events> blocks;
+    size_t count{0};
+};
+
+// Events can be freed while a thread exits, after its free list has gone
+thread_local bool free_events_gone{false};
+thread_local FreeEvents free_events;
+
+FreeEvents::~FreeEvents()
+{
+    free_events_gone = true;
+    for (size_t i = 0; i != count; ++i)
+        ::operator delete(blocks[i]);
+}
+}
+
+void* MirEvent::operator new(std::size_t size)
+{
+    if (size == sizeof(MirEvent) && !free_events_gone && free_events.count)
+        return free_events.blocks[--free_events.count];
+
+    return ::operator new(size);
+}
+
+void MirEvent::operator delete(void* block, std::size_t size)
+{
+    if (size == sizeof(MirEvent) && !free_events_gone && free_events.count != max_free_events)
+        free_events.blocks[free_events.count++] = block;
+    else
+        ::operator delete(block);
+}
+
 MirEvent::MirEvent(MirEvent const& e)
 {
     auto reader = e.event.asReader();
@@ -69,10 +119,14 @@ mir::EventUPtr MirEvent::deserialize(std::string const& bytes)
 
 std::string MirEvent::serialize(MirEvent const* event)
 {
-    std::string output;
-    auto flat_event = ::capnp::messageToFlatArray(const_cast<MirEvent*>(event)->message);
+    auto& message = const_cast<MirEvent*>(event)->message;
+
+    // Written straight into the result, rather than through a temporary flat array
+    std::string output(::capnp::computeSerializedSizeInWords(message) * sizeof(::capnp::word), '\0');
+    kj::ArrayOutputStream stream{kj::arrayPtr(reinterpret_cast<kj::byte*>(&output[0]), output.size())};
+    ::capnp::writeMessage(stream, message);
 
-    return {reinterpret_cast<char*>(flat_event.asBytes().begin()), flat_event.asBytes().size()};
+    return output;
 }
 
 MirEventType MirEvent::type() const
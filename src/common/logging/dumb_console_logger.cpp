@@ -42,8 +42,10 @@ void ml::DumbConsoleLogger::log(ml::Severity severity,
 
     struct timespec ts;
     clock_gettime(CLOCK_REALTIME, &ts);
+    struct tm local_time;
+    localtime_r(&ts.tv_sec, &local_time);
     char now[32];
-    auto offset = strftime(now, sizeof(now), "%F %T", localtime(&ts.tv_sec));
+    auto offset = strftime(now, sizeof(now), "%F %T", &local_time);
     snprintf(now+offset, sizeof(now)-offset, ".%06ld", ts.tv_nsec / 1000);
 
     out << "["
@@ -0,0 +1,327 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/geometry/region.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace geom = mir::geometry;
+
+namespace
+{
+using Span = std::pair<int, int>;   // [left, right)
+
+struct Band
+{
+    int top;
+    int bottom;
+    std::vector<Span> spans;
+};
+
+enum class Operation { unite, intersect, subtract };
+
+bool is_empty_rect(geom::Rectangle const& rect)
+{
+    return rect.size.width.as_int() <= 0 || rect.size.height.as_int() <= 0;
+}
+
+std::vector<Band> bands_of(std::vector<geom::Rectangle> const& rects)
+{
+    std::vector<Band> bands;
+    for (auto const& rect : rects)
+    {
+        if (bands.empty() || bands.back().top != rect.top().as_int())
+            bands.push_back({rect.top().as_int(), rect.bottom().as_int(), {}});
+
+        bands.back().spans.emplace_back(rect.left().as_int(), rect.right().as_int());
+    }
+    return bands;
+}
+
+std::vector<geom::Rectangle> rects_of(std::vector<Band> const& bands)
+{
+    std::vector<geom::Rectangle> rects;
+    for (auto const& band : bands)
+    {
+        for (auto const& span : band.spans)
+        {
+            rects.emplace_back(
+                geom::Point{span.first, band.top},
+                geom::Size{span.second - span.first, band.bottom - band.top});
+        }
+    }
+    return rects;
+}
+
+bool keep(Operation op, bool in_a, bool in_b)
+{
+    switch (op)
+    {
+    case Operation::unite:
+        return in_a || in_b;
+    case Operation::intersect:
+        return in_a && in_b;
+    case Operation::subtract:
+        return in_a && !in_b;
+    }
+    return false;
+}
+
+std::vector<Span> combine(std::vector<Span> const& a, std::vector<Span> const& b, Operation op)
+{
+    std::vector<int> edges;
+    edges.reserve(2 * (a.size() + b.size()));
+    for (auto const& span : a)
+    {
+        edges.push_back(span.first);
+        edges.push_back(span.second);
+    }
+    for (auto const& span : b)
+    {
+        edges.push_back(span.first);
+        edges.push_back(span.second);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    std::vector<Span> result;
+    size_t ia = 0, ib = 0;
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        auto const x = edges[i];
+        while (ia < a.size() && a[ia].second <= x) ++ia;
+        while (ib < b.size() && b[ib].second <= x) ++ib;
+
+        bool const in_a = ia < a.size() && a[ia].first <= x;
+        bool const in_b = ib < b.size() && b[ib].first <= x;
+
+        if (!keep(op, in_a, in_b))
+            continue;
+
+        if (!result.empty() && result.back().second == x)
+            result.back().second = edges[i + 1];
+        else
+            result.emplace_back(x, edges[i + 1]);
+    }
+    return result;
+}
+
+/*
+ * Slices both regions at every band edge either has, combines the spans of
+ * each slice, and merges slices that end up the same as the one above.
+ */
+std::vector<geom::Rectangle> combine(
+    std::vector<geom::Rectangle> const& rects_a,
+    std::vector<geom::Rectangle> const& rects_b,
+    Operation op)
+{
+    auto const a = bands_of(rects_a);
+    auto const b = bands_of(rects_b);
+
+    std::vector<int> edges;
+    edges.reserve(2 * (a.size() + b.size()));
+    for (auto const& band : a)
+    {
+        edges.push_back(band.top);
+        edges.push_back(band.bottom);
+    }
+    for (auto const& band : b)
+    {
+        edges.push_back(band.top);
+        edges.push_back(band.bottom);
+    }
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+
+    static std::vector<Span> const nothing;
+    std::vector<Band> result;
+    size_t ia = 0, ib = 0;
+    for (size_t i = 0; i + 1 < edges.size(); ++i)
+    {
+        auto const y = edges[i];
+        while (ia < a.size() && a[ia].bottom <= y) ++ia;
+        while (ib < b.size() && b[ib].bottom <= y) ++ib;
+
+        auto const& spans_a = (ia < a.size() && a[ia].top <= y) ? a[ia].spans : nothing;
+        auto const& spans_b = (ib < b.size() && b[ib].top <= y) ? b[ib].spans : nothing;
+
+        auto spans = combine(spans_a, spans_b, op);
+        if (spans.empty())
+            continue;
+
+        if (!result.empty() && result.back().bottom == y && result.back().spans == spans)
+            result.back().bottom = edges[i + 1];
+        else
+            result.push_back({y, edges[i + 1], std::move(spans)});
+    }
+
+    return rects_of(result);
+}
+}
+
+geom::Region::Region()
+{
+}
+
+geom::Region::Region(Rectangle const& rect)
+{
+    if (!is_empty_rect(rect))
+        rects.push_back(rect);
+}
+
+geom::Region::Region(std::initializer_list<Rectangle> const& rects)
+{
+    for (auto const& rect : rects)
+        add(rect);
+}
+
+bool geom::Region::is_empty() const
+{
+    return rects.empty();
+}
+
+bool geom::Region::contains(Point const& point) const
+{
+    for (auto const& rect : rects)
+    {
+        if (rect.contains(point))
+            return true;
+    }
+    return false;
+}
+
+bool geom::Region::contains(Rectangle const& rect) const
+{
+    if (is_empty_rect(rect))
+        return true;
+
+    int const left = rect.left().as_int();
+    int const right = rect.right().as_int();
+    int const bottom = rect.bottom().as_int();
+    int covered_to = rect.top().as_int();
+
+    // Every band from the top of rect to the bottom needs a span across it
+    auto r = rects.begin();
+    while (r != rects.end() && covered_to < bottom)
+    {
+        int const band_top = r->top().as_int();
+        int const band_bottom = r->bottom().as_int();
+
+        bool spans_rect = false;
+        for (; r != rects.end() && r->top().as_int() == band_top; ++r)
+        {
+            if (r->left().as_int() <= left && r->right().as_int() >= right)
+                spans_rect = true;
+        }
+
+        if (band_bottom <= covered_to)
+            continue;
+
+        if (band_top > covered_to || !spans_rect)
+            return false;
+
+        covered_to = band_bottom;
+    }
+
+    return covered_to >= bottom;
+}
+
+bool geom::Region::overlaps(Rectangle const& rect) const
+{
+    if (is_empty_rect(rect))
+        return false;
+
+    for (auto const& r : rects)
+    {
+        if (r.overlaps(rect))
+            return true;
+    }
+    return false;
+}
+
+geom::Rectangle geom::Region::bounding_rectangle() const
+{
+    if (rects.empty())
+        return {};
+
+    int left = rects.front().left().as_int();
+    int right = rects.front().right().as_int();
+    int const top = rects.front().top().as_int();
+    int const bottom = rects.back().bottom().as_int();
+
+    for (auto const& rect : rects)
+    {
+        left = std::min(left, rect.left().as_int());
+        right = std::max(right, rect.right().as_int());
+    }
+
+    return {Point{left, top}, Size{right - left, bottom - top}};
+}
+
+std::vector<geom::Rectangle> const& geom::Region::rectangles() const
+{
+    return rects;
+}
+
+void geom::Region::add(Rectangle const& rect)
+{
+    if (!is_empty_rect(rect) && !contains(rect))
+        rects = combine(rects, {rect}, Operation::unite);
+}
+
+void geom::Region::add(Region const& region)
+{
+    rects = combine(rects, region.rects, Operation::unite);
+}
+
+void geom::Region::subtract(Rectangle const& rect)
+{
+    if (overlaps(rect))
+        rects = combine(rects, {rect}, Operation::subtract);
+}
+
+void geom::Region::subtract(Region const& region)
+{
+    rects = combine(rects, region.rects, Operation::subtract);
+}
+
+void geom::Region::intersect(Rectangle const& rect)
+{
+    intersect(Region{rect});
+}
+
+void geom::Region::intersect(Region const& region)
+{
+    rects = combine(rects, region.rects, Operation::intersect);
+}
+
+geom::Region geom::Region::intersection_with(Rectangle const& rect) const
+{
+    Region result{*this};
+    result.intersect(rect);
+    return result;
+}
+
+bool geom::Region::operator==(Region const& other) const
+{
+    return rects == other.rects;
+}
+
+bool geom::Region::operator!=(Region const& other) const
+{
+    return rects != other.rects;
+}
@@ -0,0 +1,341 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "atlas_texture_cache.h"
+#include "mir/graphics/buffer.h"
+#include "mir/graphics/gl_format.h"
+#include "mir/renderer/gl/texture_source.h"
+#include "mir/renderer/sw/pixel_source.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace mg = mir::graphics;
+namespace mgl = mir::gl;
+namespace geom = mir::geometry;
+namespace mrgl = mir::renderer::gl;
+namespace mrs = mir::renderer::software;
+
+/*
+ * An atlas texture, divided into shelves: rows of slots filled from the
+ * left. A slot goes on the shortest shelf it fits, or on a new shelf below
+ * the others.
+ */
+class mgl::AtlasTextureCache::Page
+{
+public:
+    Page(GLenum format, GLenum type)
+        : format{format},
+          type{type},
+          texture{std::make_shared<Texture>()}
+    {
+        glTexImage2D(GL_TEXTURE_2D, 0, format, page_size, page_size, 0, format, type, nullptr);
+    }
+
+    bool allocate(int width, int height, geom::Rectangle& slot)
+    {
+        Shelf* best{nullptr};
+        Span* best_span{nullptr};
+
+        for (auto& shelf : shelves)
+        {
+            if (shelf.height < height || (best && shelf.height >= best->height))
+                continue;
+
+            auto const span = std::find_if(
+                shelf.free.begin(), shelf.free.end(),
+                [width](Span const& span) { return span.second - span.first >= width; });
+
+            if (span != shelf.free.end())
+            {
+                best = &shelf;
+                best_span = &*span;
+            }
+        }
+
+        if (!best)
+        {
+            // Rounding shelf heights up lets similar sizes share them
+            auto const top = shelves.empty() ? 0 : shelves.back().top + shelves.back().height;
+            auto const shelf_height = std::min((height + 7) / 8 * 8, page_size - top);
+
+            if (shelf_height < height)
+                return false;
+
+            shelves.push_back({top, shelf_height, {{0, page_size}}});
+            best = &shelves.back();
+            best_span = &best->free.front();
+        }
+
+        slot = {{best_span->first, best->top}, {width, height}};
+
+        best_span->first += width;
+        if (best_span->first == best_span->second)
+            best->free.erase(best->free.begin() + (best_span - best->free.data()));
+
+        ++slots;
+        return true;
+    }
+
+    void free(geom::Rectangle const& slot)
+    {
+        auto const shelf = std::find_if(
+            shelves.begin(), shelves.end(),
+            [&slot](Shelf const& shelf) { return shelf.top == slot.top_left.y.as_int(); });
+
+        if (shelf == shelves.end())
+            return;
+
+        Span const freed{slot.left().as_int(), slot.right().as_int()};
+        auto& spans = shelf->free;
+        auto const next = spans.insert(
+            std::upper_bound(spans.begin(), spans.end(), freed),
+            freed);
+
+        // Merge with the free spans either side
+        auto i = next;
+        if (i + 1 != spans.end() && i->second == (i + 1)->first)
+        {
+            i->second = (i + 1)->second;
+            spans.erase(i + 1);
+        }
+        if (i != spans.begin() && (i - 1)->second == i->first)
+        {
+            (i - 1)->second = i->second;
+            spans.erase(i);
+        }
+
+        --slots;
+
+        // Empty shelves at the bottom give their height back to the page
+        while (!shelves.empty() && shelves.back().free == std::vector<Span>{{0, page_size}})
+            shelves.pop_back();
+    }
+
+    bool empty() const
+    {
+        return slots == 0;
+    }
+
+    GLenum const format;
+    GLenum const type;
+    std::shared_ptr<Texture> const texture;
+
+private:
+    typedef std::pair<int, int> Span;   ///< Free columns [first, second)
+
+    struct Shelf
+    {
+        int top;
+        int height;
+        std::vector<Span> free;         ///< In order
+    };
+
+    std::vector<Shelf> shelves;         ///< Top to bottom
+    int slots{0};
+};
+
+mgl::AtlasTextureCache::AtlasTextureCache() = default;
+
+mgl::AtlasTextureCache::~AtlasTextureCache() = default;
+
+std::shared_ptr<mgl::Texture> mgl::AtlasTextureCache::load(mg::Renderable const& renderable)
+{
+    auto const& buffer = renderable.buffer();
+    auto const size = buffer->size();
+    auto const pixels = dynamic_cast<mrs::PixelSource*>(buffer->native_buffer_base());
+
+    GLenum format, type;
+
+    // Only unscaled pixels in memory are packed; sampling beyond the edge of
+    // a stretched one would see its neighbours
+    Entry* const entry =
+        pixels &&
+        size.width.as_int() > 0 && size.width.as_int() <= max_packed_size &&
+        size.height.as_int() > 0 && size.height.as_int() <= max_packed_size &&
+        size == renderable.screen_position().size &&
+        mg::get_gl_pixel_format(buffer->pixel_format(), format, type) ?
+            entry_for(renderable, format, type) : nullptr;
+
+    if (!entry)
+    {
+        forget(renderable.id());
+        return fallback.load(renderable);
+    }
+
+    auto const buffer_id = buffer->id();
+    if (entry->last_bound_buffer != buffer_id || !entry->valid_binding)
+    {
+        auto const bytes_per_pixel = MIR_BYTES_PER_PIXEL(buffer->pixel_format());
+        auto const width = size.width.as_int();
+        auto const height = size.height.as_int();
+        auto const slot_width = width + 2;
+
+        // The border repeats the edge pixels, so filtering at the edge of the
+        // renderable never blends in its neighbours
+        staging.resize(slot_width * (height + 2) * bytes_per_pixel);
+        pixels->read(
+            [&](unsigned char const* source)
+            {
+                auto const stride = pixels->stride().as_int();
+                for (auto y = -1; y <= height; ++y)
+                {
+                    auto const row = source + std::min(std::max(y, 0), height - 1) * stride;
+                    auto const dest = staging.data() + (y + 1) * slot_width * bytes_per_pixel;
+
+                    memcpy(dest, row, bytes_per_pixel);
+                    memcpy(dest + bytes_per_pixel, row, width * bytes_per_pixel);
+                    memcpy(dest + (width + 1) * bytes_per_pixel, row + (width - 1) * bytes_per_pixel, bytes_per_pixel);
+                }
+            });
+
+        entry->page->texture->bind();
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexSubImage2D(
+            GL_TEXTURE_2D, 0,
+            entry->slot.left().as_int(), entry->slot.top().as_int(),
+            slot_width, height + 2,
+            format, type,
+            staging.data());
+
+        uploaded += staging.size();
+        entry->resource = buffer;
+        entry->last_bound_buffer = buffer_id;
+    }
+
+    if (auto const texture_source = dynamic_cast<mrgl::TextureSource*>(buffer->native_buffer_base()))
+        texture_source->secure_for_render();
+
+    entry->valid_binding = true;
+    entry->used = true;
+
+    return entry->page->texture;
+}
+
+auto mgl::AtlasTextureCache::entry_for(mg::Renderable const& renderable, GLenum format, GLenum type) -> Entry*
+{
+    auto const size = renderable.buffer()->size();
+    geom::Size const slot_size{size.width.as_int() + 2, size.height.as_int() + 2};
+
+    auto existing = entries.find(renderable.id());
+    if (existing != entries.end())
+    {
+        auto& entry = existing->second;
+        if (entry.slot.size == slot_size && entry.page->format == format && entry.page->type == type)
+            return &entry;
+
+        forget(renderable.id());
+    }
+
+    geom::Rectangle slot;
+    Page* page{nullptr};
+    int format_pages{0};
+
+    for (auto const& p : pages)
+    {
+        if (p->format != format || p->type != type)
+            continue;
+
+        ++format_pages;
+        if (p->allocate(slot_size.width.as_int(), slot_size.height.as_int(), slot))
+        {
+            page = p.get();
+            break;
+        }
+    }
+
+    if (!page)
+    {
+        if (format_pages >= max_pages)
+            return nullptr;
+
+        pages.push_back(std::make_unique<Page>(format, type));
+        page = pages.back().get();
+        page->allocate(slot_size.width.as_int(), slot_size.height.as_int(), slot);
+    }
+
+    auto& entry = entries[renderable.id()];
+    entry.page = page;
+    entry.slot = slot;
+    return &entry;
+}
+
+void mgl::AtlasTextureCache::forget(mg::Renderable::ID id)
+{
+    auto const entry = entries.find(id);
+    if (entry != entries.end())
+    {
+        entry->second.page->free(entry->second.slot);
+        entries.erase(entry);
+    }
+}
+
+mgl::TextureRegion mgl::AtlasTextureCache::region(mg::Renderable const& renderable) const
+{
+    auto const entry = entries.find(renderable.id());
+    if (entry == entries.end())
+        return fallback.region(renderable);
+
+    auto const& slot = entry->second.slot;
+    float const scale = 1.0f / page_size;
+
+    return {
+        (slot.left().as_int() + 1) * scale,
+        (slot.top().as_int() + 1) * scale,
+        (slot.right().as_int() - 1) * scale,
+        (slot.bottom().as_int() - 1) * scale};
+}
+
+void mgl::AtlasTextureCache::invalidate()
+{
+    fallback.invalidate();
+
+    for (auto& entry : entries)
+        entry.second.valid_binding = false;
+}
+
+void mgl::AtlasTextureCache::drop_unused()
+{
+    fallback.drop_unused();
+
+    for (auto e = entries.begin(); e != entries.end();)
+    {
+        auto& entry = e->second;
+        entry.resource.reset();
+        if (entry.used)
+        {
+            entry.used = false;
+            ++e;
+        }
+        else
+        {
+            entry.page->free(entry.slot);
+            e = entries.erase(e);
+        }
+    }
+
+    pages.erase(
+        std::remove_if(
+            pages.begin(), pages.end(),
+            [](std::unique_ptr<Page> const& page) { return page->empty(); }),
+        pages.end());
+}
+
+size_t mgl::AtlasTextureCache::uploaded_bytes() const
+{
+    return uploaded + fallback.uploaded_bytes();
+}
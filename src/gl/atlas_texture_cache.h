@@ -0,0 +1,81 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GL_ATLAS_TEXTURE_CACHE_H_
+#define MIR_GL_ATLAS_TEXTURE_CACHE_H_
+
+#include "recently_used_cache.h"
+#include "mir/geometry/rectangle.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace gl
+{
+/**
+ * A TextureCache that packs small renderables whose pixels are in memory
+ * (tooltips, decorations, cursors...) into shared atlas textures. They
+ * don't each need a texture of their own, and the renderer can draw them
+ * without rebinding. Everything else is cached by a RecentlyUsedCache.
+ */
+class AtlasTextureCache : public TextureCache
+{
+public:
+    AtlasTextureCache();
+    ~AtlasTextureCache();
+
+    std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
+    TextureRegion region(graphics::Renderable const& renderable) const override;
+    void invalidate() override;
+    void drop_unused() override;
+    size_t uploaded_bytes() const override;
+
+    /// Renderables no wider or higher than this are packed
+    static int const max_packed_size = 256;
+    /// The width and height of each atlas texture
+    static int const page_size = 1024;
+    /// The most atlas textures kept of each pixel format
+    static int const max_pages = 4;
+
+private:
+    class Page;
+
+    struct Entry
+    {
+        Page* page;
+        geometry::Rectangle slot;   ///< Including a one pixel border
+        graphics::BufferID last_bound_buffer;
+        bool used{true};
+        bool valid_binding{false};
+        std::shared_ptr<graphics::Buffer> resource;
+    };
+
+    Entry* entry_for(graphics::Renderable const& renderable, GLenum format, GLenum type);
+    void forget(graphics::Renderable::ID id);
+
+    RecentlyUsedCache fallback;
+    std::vector<std::unique_ptr<Page>> pages;
+    std::unordered_map<graphics::Renderable::ID, Entry> entries;
+    std::vector<unsigned char> staging;
+    size_t uploaded{0};
+};
+}
+}
+
+#endif /* MIR_GL_ATLAS_TEXTURE_CACHE_H_ */
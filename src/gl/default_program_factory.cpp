@@ -19,7 +19,7 @@
 
 #include "mir/gl/default_program_factory.h"
 #include "mir/gl/program.h"
-#include "recently_used_cache.h"
+#include "atlas_texture_cache.h"
 
 namespace mgl = mir::gl;
 
@@ -35,5 +35,5 @@ mgl::DefaultProgramFactory::create_gl_program(
 
 std::unique_ptr<mgl::TextureCache> mgl::DefaultProgramFactory::create_texture_cache() const
 {
-    return std::make_unique<RecentlyUsedCache>();
+    return std::make_unique<AtlasTextureCache>();
 }
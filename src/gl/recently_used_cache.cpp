@@ -20,6 +20,7 @@
 #include "recently_used_cache.h"
 #include "mir/graphics/buffer.h"
 #include "mir/renderer/gl/texture_source.h"
+#include "mir/renderer/gl/incremental_texture_source.h"
 
 #include <stdexcept>
 #include <boost/throw_exception.hpp>
@@ -42,7 +43,24 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
 
     if ((texture.last_bound_buffer != buffer_id) || (!texture.valid_binding))
     {
-        texture_source->bind();
+        auto const incremental =
+            dynamic_cast<mrgl::IncrementalTextureSource*>(buffer->native_buffer_base());
+
+        // A texture still holding the last buffer bound may only need patching
+        if (incremental && texture.valid_binding)
+        {
+            uploaded += incremental->bind_over(texture.last_bound_buffer);
+        }
+        else
+        {
+            texture_source->bind();
+            if (incremental)
+            {
+                auto const size = buffer->size();
+                uploaded += size.width.as_int() * size.height.as_int() * MIR_BYTES_PER_PIXEL(buffer->pixel_format());
+            }
+        }
+
         texture.resource = buffer;
         texture.last_bound_buffer = buffer_id;
     }
@@ -54,6 +72,11 @@ std::shared_ptr<mgl::Texture> mgl::RecentlyUsedCache::load(mg::Renderable const&
     return texture.texture;
 }
 
+mgl::TextureRegion mgl::RecentlyUsedCache::region(mg::Renderable const&) const
+{
+    return {};
+}
+
 void mgl::RecentlyUsedCache::invalidate()
 {
     for (auto &t : textures)
@@ -78,3 +101,8 @@ void mgl::RecentlyUsedCache::drop_unused()
         }
     }
 }
+
+size_t mgl::RecentlyUsedCache::uploaded_bytes() const
+{
+    return uploaded;
+}
@@ -35,8 +35,10 @@ class RecentlyUsedCache : public TextureCache
 {
 public:
     std::shared_ptr<Texture> load(graphics::Renderable const& renderable) override;
+    TextureRegion region(graphics::Renderable const& renderable) const override;
     void invalidate() override;
     void drop_unused() override;
+    size_t uploaded_bytes() const override;
 
 private:
     struct Entry
@@ -52,6 +54,7 @@ private:
     };
 
     std::unordered_map<graphics::Renderable::ID, Entry> textures;
+    size_t uploaded{0};
 };
 }
 }
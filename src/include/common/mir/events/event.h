@@ -25,6 +25,7 @@
 
 #include <capnp/message.h>
 
+#include <cstddef>
 #include <cstring>
 
 struct MirEvent
@@ -73,10 +74,18 @@ struct MirEvent
     static mir::EventUPtr deserialize(std::string const& bytes);
     static std::string serialize(MirEvent const* event);
 
+    // Events are recycled per thread, as input creates and drops them at a high rate
+    static void* operator new(std::size_t size);
+    static void operator delete(void* block, std::size_t size);
+
 protected:
     MirEvent() = default;
 
-    ::capnp::MallocMessageBuilder message;
+    // Enough for an input event (even one with every touch contact) to need no other storage
+    static std::size_t const first_segment_words = 128;
+
+    ::capnp::word first_segment[first_segment_words]{};
+    ::capnp::MallocMessageBuilder message{kj::arrayPtr(first_segment, first_segment_words)};
     mir::capnp::Event::Builder event{message.initRoot<mir::capnp::Event>()};
 };
 
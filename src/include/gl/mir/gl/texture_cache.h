@@ -28,6 +28,16 @@ namespace graphics { class Renderable; }
 namespace gl
 {
 class Texture;
+
+/// A rectangle of a texture, in texture coordinates
+struct TextureRegion
+{
+    float left{0.0f};
+    float top{0.0f};
+    float right{1.0f};
+    float bottom{1.0f};
+};
+
 class TextureCache
 {
 public:
@@ -43,6 +53,14 @@ public:
      */
     virtual std::shared_ptr<Texture> load(graphics::Renderable const&) = 0;
 
+    /**
+     * Where the pixels of the renderable lie within the texture load()
+     * last returned for it. A cache may pack several renderables into one
+     * texture, so texture coordinates for the renderable must be mapped
+     * into this region.
+     */
+    virtual TextureRegion region(graphics::Renderable const&) const = 0;
+
     /**
      * Mark all entries in the cache as out-of-date to ensure fresh textures
      * are loaded next time. This function _must_ be implemented in a way that
@@ -57,6 +75,12 @@ public:
      */
     virtual void drop_unused() = 0;
 
+    /**
+     * How many bytes of pixels load() has copied into textures so far.
+     * Buffers bound without copying (such as EGLImages) add nothing.
+     */
+    virtual size_t uploaded_bytes() const = 0;
+
 protected:
     TextureCache() = default;
 private:
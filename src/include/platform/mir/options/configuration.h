@@ -44,13 +44,17 @@ extern char const* const connector_report_opt;
 extern char const* const scene_report_opt;
 extern char const* const input_report_opt;
 extern char const* const seat_report_opt;
+extern char const* const input_trace_opt;
 extern char const* const host_socket_opt;
 extern char const* const nested_passthrough_opt;
 extern char const* const frontend_threads_opt;
+extern char const* const wayland_coalesce_pointer_motion_opt;
 extern char const* const touchspots_opt;
 extern char const* const cursor_opt;
 extern char const* const fatal_except_opt;
 extern char const* const debug_opt;
+extern char const* const async_logging_opt;
+extern char const* const log_rate_limit_opt;
 extern char const* const composite_delay_opt;
 extern char const* const enable_key_repeat_opt;
 extern char const* const x11_display_opt;
@@ -59,6 +63,7 @@ extern char const* const enable_mirclient_opt;
 
 extern char const* const name_opt;
 extern char const* const offscreen_opt;
+extern char const* const renderer_opt;
 
 extern char const* const enable_key_repeat_opt;
 
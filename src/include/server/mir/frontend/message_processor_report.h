@@ -22,6 +22,7 @@
 
 #include "mir_toolkit/event.h"
 
+#include <cstddef>
 #include <string>
 
 namespace mir
@@ -45,6 +46,9 @@ public:
 
     virtual void exception_handled(void const* mediator, std::exception const& error) = 0;
 
+    /// The client on \a connection has stopped reading, or caught up: \a depth messages wait for it
+    virtual void send_queue_depth(void const* connection, size_t depth) = 0;
+
 private:
     MessageProcessorReport(MessageProcessorReport const&) = delete;
     MessageProcessorReport& operator=(MessageProcessorReport const&) = delete;
@@ -42,17 +42,22 @@ char const* const mo::connector_report_opt        = "connector-report";
 char const* const mo::scene_report_opt            = "scene-report";
 char const* const mo::input_report_opt            = "input-report";
 char const* const mo::seat_report_opt            = "seat-report";
+char const* const mo::input_trace_opt            = "input-trace";
 char const* const mo::shared_library_prober_report_opt = "shared-library-prober-report";
 char const* const mo::shell_report_opt            = "shell-report";
 char const* const mo::host_socket_opt             = "host-socket";
 char const* const mo::nested_passthrough_opt      = "nested-passthrough";
 char const* const mo::frontend_threads_opt        = "ipc-thread-pool";
+char const* const mo::wayland_coalesce_pointer_motion_opt = "wayland-coalesce-pointer-motion";
 char const* const mo::name_opt                    = "name";
 char const* const mo::offscreen_opt               = "offscreen";
+char const* const mo::renderer_opt                = "renderer";
 char const* const mo::touchspots_opt              = "enable-touchspots";
 char const* const mo::cursor_opt                  = "cursor";
 char const* const mo::fatal_except_opt            = "on-fatal-error-except";
 char const* const mo::debug_opt                   = "debug";
+char const* const mo::async_logging_opt           = "async-logging";
+char const* const mo::log_rate_limit_opt          = "log-rate-limit";
 char const* const mo::composite_delay_opt         = "composite-delay";
 char const* const mo::enable_key_repeat_opt       = "enable-key-repeat";
 char const* const mo::x11_display_opt             = "x11-display-experimental";
@@ -154,6 +159,9 @@ mo::DefaultConfiguration::DefaultConfiguration(
     add_options()
         (wayland_socket_name_opt, po::value<std::string>(),
          "Overrides the default socket name used for communicating with clients")
+        (wayland_coalesce_pointer_motion_opt, po::value<std::string>()->default_value(""),
+         "Clients to send only the latest pointer motion to while they are drawing a frame: "
+         "\"all\", or a comma separated list of executable names (as in /proc/<pid>/comm)")
         (host_socket_opt, po::value<std::string>(),
             "Host socket filename")
         (server_socket_opt, po::value<std::string>()->default_value(::mir::default_server_socket),
@@ -181,6 +189,8 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "How to handle the Legacy Input report. [{log,off}]")
         (seat_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle to Seat report. [{log,off}]")
+        (input_trace_opt, po::value<std::string>(),
+            "File to record all input from devices to, for replaying with mir_performance_tests")
         (session_mediator_report_opt, po::value<std::string>()->default_value(off_opt_value),
             "How to handle the SessionMediator report. [{log,lttng,off}]")
         (msg_processor_report_opt, po::value<std::string>()->default_value(off_opt_value),
@@ -203,6 +213,9 @@ mo::DefaultConfiguration::DefaultConfiguration(
             " to avoid a composition pass")
         (offscreen_opt,
             "Render to offscreen buffers instead of the real outputs.")
+        (renderer_opt, po::value<std::string>()->default_value("gl"),
+            "Renderer to composite with [{gl,software}]. The software renderer "
+            "draws with the CPU, and needs --offscreen")
         (touchspots_opt,
             "Display visualization of touchspots (e.g. for screencasting).")
         (cursor_opt,
@@ -214,6 +227,10 @@ mo::DefaultConfiguration::DefaultConfiguration(
             "in unexpected ways] throw an exception (instead of a core dump)")
         (debug_opt, "Enable extra development debugging. "
             "This is only interesting for people doing Mir server or client development.")
+        (async_logging_opt, "Write log messages from a thread of their own, so logging never holds up "
+            "the compositor or input. Messages are dropped (and counted) if they can't be written fast enough")
+        (log_rate_limit_opt, po::value<int>()->default_value(100),
+            "With --async-logging, the most times a second any one message is logged. 0 for no limit")
         (enable_mirclient_opt, "Enable deprecated mirclient socket (for running old clients)")
         (console_provider,
             po::value<std::string>()->default_value("auto"),
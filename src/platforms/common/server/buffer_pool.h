@@ -0,0 +1,115 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_COMMON_BUFFER_POOL_H_
+#define MIR_GRAPHICS_COMMON_BUFFER_POOL_H_
+
+#include <cstddef>
+#include <iterator>
+#include <list>
+#include <mutex>
+
+namespace mir
+{
+namespace graphics
+{
+namespace common
+{
+/**
+ * Keeps the storage behind released buffers so that allocating another
+ * buffer of the same kind can reuse it.
+ *
+ * Handle owns the storage and is null when default constructed (a
+ * std::unique_ptr, typically). Once the pool holds more than its budget the
+ * least recently released storage is freed.
+ */
+template<typename Key, typename Handle>
+class BufferPool
+{
+public:
+    explicit BufferPool(size_t budget_in_bytes)
+        : budget{budget_in_bytes}
+    {
+    }
+
+    /// \returns the most recently released storage for key, or null
+    Handle take(Key const& key)
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+
+        for (auto i = released.begin(); i != released.end(); ++i)
+        {
+            if (i->key == key)
+            {
+                auto handle = std::move(i->handle);
+                held -= i->bytes;
+                released.erase(i);
+                return handle;
+            }
+        }
+
+        return Handle{};
+    }
+
+    void give(Key const& key, Handle handle, size_t bytes)
+    {
+        if (bytes > budget)
+            return;
+
+        // Free whatever is evicted outside the lock
+        std::list<Entry> evicted;
+        {
+            std::lock_guard<decltype(mutex)> lock{mutex};
+
+            released.push_front({key, std::move(handle), bytes});
+            held += bytes;
+
+            while (held > budget)
+            {
+                held -= released.back().bytes;
+                evicted.splice(evicted.begin(), released, std::prev(released.end()));
+            }
+        }
+    }
+
+    size_t size_in_bytes() const
+    {
+        std::lock_guard<decltype(mutex)> lock{mutex};
+        return held;
+    }
+
+private:
+    BufferPool(BufferPool const&) = delete;
+    BufferPool& operator=(BufferPool const&) = delete;
+
+    struct Entry
+    {
+        Key key;
+        Handle handle;
+        size_t bytes;
+    };
+
+    size_t const budget;
+
+    std::mutex mutable mutex;
+    std::list<Entry> released;      ///< Most recently released first
+    size_t held{0};
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_COMMON_BUFFER_POOL_H_ */
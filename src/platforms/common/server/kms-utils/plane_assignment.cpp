@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "plane_assignment.h"
+#include "drm_mode_resources.h"
+
+#include <algorithm>
+
+namespace mgk = mir::graphics::kms;
+namespace geom = mir::geometry;
+
+namespace
+{
+mgk::PlaneInfo::Type type_of(int drm_fd, mgk::DRMModePlaneUPtr const& plane)
+{
+    mgk::ObjectProperties const props{drm_fd, plane};
+    if (!props.has_property("type"))
+        return mgk::PlaneInfo::Type::overlay;
+
+    switch (props["type"])
+    {
+    case DRM_PLANE_TYPE_PRIMARY:
+        return mgk::PlaneInfo::Type::primary;
+    case DRM_PLANE_TYPE_CURSOR:
+        return mgk::PlaneInfo::Type::cursor;
+    default:
+        return mgk::PlaneInfo::Type::overlay;
+    }
+}
+
+bool overlaps_any(geom::Rectangle const& area, std::vector<geom::Rectangle> const& others)
+{
+    return std::any_of(
+        others.begin(), others.end(),
+        [&area](geom::Rectangle const& other) { return area.overlaps(other); });
+}
+}
+
+bool mgk::PlaneInfo::supports(uint32_t format) const
+{
+    return std::find(formats.begin(), formats.end(), format) != formats.end();
+}
+
+auto mgk::planes_for_crtc(int drm_fd, int crtc_index) -> std::vector<PlaneInfo>
+{
+    std::vector<PlaneInfo> planes;
+
+    PlaneResources const resources{drm_fd};
+    for (auto& plane : resources.planes())
+    {
+        if (plane->possible_crtcs & (1 << crtc_index))
+        {
+            planes.push_back({
+                plane->plane_id,
+                type_of(drm_fd, plane),
+                {plane->formats, plane->formats + plane->count_formats}});
+        }
+    }
+
+    return planes;
+}
+
+auto mgk::assign_overlay_planes(
+    std::vector<PlaneInfo> const& planes,
+    std::vector<PlaneLayer> const& layers,
+    geom::Rectangle const& output,
+    std::function<bool(PlaneUses const&)> const& test) -> PlaneUses
+{
+    std::vector<PlaneInfo const*> free_planes;
+    for (auto const& plane : planes)
+    {
+        if (plane.type == PlaneInfo::Type::overlay)
+            free_planes.push_back(&plane);
+    }
+
+    PlaneUses uses;
+    std::vector<geom::Rectangle> above;
+
+    for (auto i = layers.size(); i-- != 0 && !free_planes.empty();)
+    {
+        auto const& layer = layers[i];
+
+        // Layers off this output don't stop anything beneath them
+        if (!layer.area.overlaps(output))
+            continue;
+
+        if (layer.can_scanout &&
+            output.contains(layer.area) &&
+            !overlaps_any(layer.area, above))
+        {
+            auto const plane = std::find_if(
+                free_planes.begin(), free_planes.end(),
+                [&layer](PlaneInfo const* plane) { return plane->supports(layer.format); });
+
+            if (plane != free_planes.end())
+            {
+                uses.push_back({(*plane)->id, i});
+                if (test(uses))
+                {
+                    free_planes.erase(plane);
+                    above.push_back(layer.area);
+                    continue;
+                }
+                uses.pop_back();
+            }
+        }
+
+        above.push_back(layer.area);
+    }
+
+    return uses;
+}
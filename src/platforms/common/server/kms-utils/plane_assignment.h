@@ -0,0 +1,100 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_COMMON_KMS_UTILS_PLANE_ASSIGNMENT_H_
+#define MIR_GRAPHICS_COMMON_KMS_UTILS_PLANE_ASSIGNMENT_H_
+
+#include "mir/geometry/rectangle.h"
+
+#include <cstdint>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace mir
+{
+namespace graphics
+{
+namespace kms
+{
+struct PlaneInfo
+{
+    enum class Type
+    {
+        overlay,
+        primary,
+        cursor
+    };
+
+    uint32_t id;
+    Type type;
+    std::vector<uint32_t> formats;     ///< DRM fourcc codes
+
+    bool supports(uint32_t format) const;
+};
+
+/**
+ * Lists the planes that can show images on a CRTC.
+ *
+ * Planes on kernels without universal planes have no "type" property; these
+ * are all overlay planes.
+ *
+ * \param [in] drm_fd       File descriptor to DRM node
+ * \param [in] crtc_index   Index of the CRTC in the DRM resources
+ */
+std::vector<PlaneInfo> planes_for_crtc(int drm_fd, int crtc_index);
+
+/// Something that might be shown on a plane instead of being composited
+struct PlaneLayer
+{
+    geometry::Rectangle area;
+    uint32_t format;            ///< DRM fourcc code
+    bool can_scanout;           ///< Unscaled, untransformed, unfaded and in displayable memory
+};
+
+struct PlaneUse
+{
+    uint32_t plane_id;
+    size_t layer;               ///< Index into the layers assigned
+};
+
+typedef std::vector<PlaneUse> PlaneUses;
+
+/**
+ * Chooses layers to show on overlay planes, over whatever is composited
+ * onto the primary plane.
+ *
+ * Layers are ordered bottom to top. Working down from the top, each layer
+ * takes the first free overlay plane that supports its format so long as
+ * it lies within the output and overlaps no layer above it: neither one left
+ * to be composited beneath all the overlays, nor one on another overlay,
+ * whose stacking order legacy KMS leaves undefined. Before a layer is given
+ * a plane the whole assignment is offered to test, which may reject it (for
+ * example, after a test-only atomic commit).
+ *
+ * \returns The planes used, from the top layer down. Every layer not listed
+ *          still needs to be composited.
+ */
+PlaneUses assign_overlay_planes(
+    std::vector<PlaneInfo> const& planes,
+    std::vector<PlaneLayer> const& layers,
+    geometry::Rectangle const& output,
+    std::function<bool(PlaneUses const&)> const& test);
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_COMMON_KMS_UTILS_PLANE_ASSIGNMENT_H_ */
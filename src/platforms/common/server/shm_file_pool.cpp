@@ -0,0 +1,97 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "shm_file_pool.h"
+#include "mir/anonymous_shm_file.h"
+
+#include <cstring>
+#include <unistd.h>
+
+namespace mgc = mir::graphics::common;
+
+class mgc::ShmFilePool::PooledFile : public ShmFile
+{
+public:
+    PooledFile(std::unique_ptr<ShmFile> file, size_t size, std::weak_ptr<Pool> const& pool)
+        : file{std::move(file)},
+          size{size},
+          pool{pool}
+    {
+    }
+
+    ~PooledFile() noexcept
+    {
+        if (auto const live_pool = pool.lock())
+            live_pool->give(size, std::move(file), size);
+    }
+
+    void* base_ptr() const override
+    {
+        return file->base_ptr();
+    }
+
+    int fd() const override
+    {
+        return file->fd();
+    }
+
+private:
+    std::unique_ptr<ShmFile> file;
+    size_t const size;
+    std::weak_ptr<Pool> const pool;
+};
+
+mgc::ShmFilePool::ShmFilePool(size_t budget_in_bytes)
+    : pool{std::make_shared<Pool>(budget_in_bytes)}
+{
+}
+
+auto mgc::ShmFilePool::take(size_t size) -> std::unique_ptr<ShmFile>
+{
+    auto const file_size = size_class(size);
+
+    auto file = pool->take(file_size);
+    if (file)
+    {
+        // Don't show one client what another left behind
+        memset(file->base_ptr(), 0, file_size);
+    }
+    else
+    {
+        file = std::make_unique<AnonymousShmFile>(file_size);
+    }
+
+    return std::make_unique<PooledFile>(std::move(file), file_size, pool);
+}
+
+size_t mgc::ShmFilePool::size_in_bytes() const
+{
+    return pool->size_in_bytes();
+}
+
+size_t mgc::ShmFilePool::size_class(size_t size)
+{
+    static size_t const page_size = sysconf(_SC_PAGESIZE);
+
+    // Step by a quarter of the power of two at or below size, but by no less
+    // than a page: a class is never more than a quarter larger than what is
+    // asked for, once that is more than a few pages
+    auto step = page_size;
+    while (step * 8 <= size)
+        step *= 2;
+
+    return (size + step - 1) / step * step;
+}
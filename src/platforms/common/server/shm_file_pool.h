@@ -0,0 +1,65 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU Lesser General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Lesser General Public License for more details.
+ *
+ * You should have received a copy of the GNU Lesser General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_GRAPHICS_COMMON_SHM_FILE_POOL_H_
+#define MIR_GRAPHICS_COMMON_SHM_FILE_POOL_H_
+
+#include "buffer_pool.h"
+
+#include <memory>
+
+namespace mir
+{
+class ShmFile;
+
+namespace graphics
+{
+namespace common
+{
+/**
+ * Hands out anonymous shared memory files, taking each back to reuse its
+ * file and mapping once it is destroyed.
+ *
+ * Files come in size classes, so a buffer resized by a few pixels still
+ * reuses storage. A reused file is zeroed before it is handed out again, but
+ * a client that kept a mapping of the buffer it released can still see
+ * what the file is used for next; a budget of 0 keeps every file private.
+ */
+class ShmFilePool
+{
+public:
+    explicit ShmFilePool(size_t budget_in_bytes);
+
+    /// \returns a zero-filled file of at least size bytes
+    std::unique_ptr<ShmFile> take(size_t size);
+
+    /// \returns the bytes held in released files
+    size_t size_in_bytes() const;
+
+    /// \returns the size of the files allocated to hold size bytes
+    static size_t size_class(size_t size);
+
+private:
+    class PooledFile;
+    typedef BufferPool<size_t, std::unique_ptr<ShmFile>> Pool;
+
+    std::shared_ptr<Pool> const pool;
+};
+}
+}
+}
+
+#endif /* MIR_GRAPHICS_COMMON_SHM_FILE_POOL_H_ */
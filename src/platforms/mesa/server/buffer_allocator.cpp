@@ -20,8 +20,10 @@
 #include "buffer_allocator.h"
 #include "gbm_buffer.h"
 #include "buffer_texture_binder.h"
-#include "mir/anonymous_shm_file.h"
 #include "shm_buffer.h"
+#include "shm_file_pool.h"
+#include "mir/shm_file.h"
+#include "buffer_pool.h"
 #include "display_helpers.h"
 #include "software_buffer.h"
 #include "gbm_format_conversions.h"
@@ -50,6 +52,7 @@
 #include <system_error>
 #include <gbm.h>
 #include <cassert>
+#include <cstdlib>
 #include <fcntl.h>
 
 #include <wayland-server.h>
@@ -201,6 +204,36 @@ struct GBMBODeleter
     }
 };
 
+struct BOKey
+{
+    geom::Size size;
+    uint32_t format;
+    uint32_t flags;
+
+    bool operator==(BOKey const& other) const
+    {
+        return size == other.size && format == other.format && flags == other.flags;
+    }
+};
+
+/*
+ * Storage kept by each of the hardware and software buffer pools, from
+ * MIR_MESA_BUFFER_POOL_MB. Pooling is off unless that is set: we can't tell
+ * which client a buffer belongs to, so storage one client released could
+ * otherwise be handed to another (bos are not cleared, and a client may keep
+ * a mapping of a released SHM file). 64 is enough for a couple of
+ * fullscreen windows being resized.
+ */
+size_t pool_budget()
+{
+    size_t const mebibyte = 1024 * 1024;
+
+    if (auto const budget = getenv("MIR_MESA_BUFFER_POOL_MB"))
+        return strtoul(budget, nullptr, 10) * mebibyte;
+
+    return 0;
+}
+
 auto make_texture_binder(
     mgm::BufferImportMethod const buffer_import_method,
     std::shared_ptr<gbm_bo> const& bo,
@@ -243,6 +276,12 @@ std::unique_ptr<mir::renderer::gl::Context> context_for_output(mg::Display const
 }
 }
 
+class mgm::BufferAllocator::BOPool : public mgc::BufferPool<BOKey, std::unique_ptr<gbm_bo, GBMBODeleter>>
+{
+public:
+    using BufferPool::BufferPool;
+};
+
 mgm::BufferAllocator::BufferAllocator(
     mg::Display const& output,
     gbm_device* device,
@@ -254,7 +293,9 @@ mgm::BufferAllocator::BufferAllocator(
       bypass_option(buffer_import_method == mgm::BufferImportMethod::dma_buf ?
                         mgm::BypassOption::prohibited :
                         bypass_option),
-      buffer_import_method(buffer_import_method)
+      buffer_import_method(buffer_import_method),
+      bo_pool{std::make_shared<BOPool>(pool_budget())},
+      shm_pool{std::make_shared<mgc::ShmFilePool>(pool_budget())}
 {
 }
 
@@ -304,17 +345,34 @@ std::shared_ptr<mg::Buffer> mgm::BufferAllocator::alloc_hardware_buffer(
 std::shared_ptr<mg::Buffer> mgm::BufferAllocator::alloc_buffer(
     geom::Size size, uint32_t native_format, uint32_t native_flags)
 {
-    gbm_bo *bo_raw = gbm_bo_create(
-        device,
-        size.width.as_uint32_t(),
-        size.height.as_uint32_t(),
-        native_format,
-        native_flags);
+    BOKey const key{size, native_format, native_flags};
+
+    gbm_bo* bo_raw = bo_pool->take(key).release();
+    if (!bo_raw)
+    {
+        bo_raw = gbm_bo_create(
+            device,
+            size.width.as_uint32_t(),
+            size.height.as_uint32_t(),
+            native_format,
+            native_flags);
+    }
 
     if (!bo_raw)
         BOOST_THROW_EXCEPTION(std::runtime_error("Failed to create GBM buffer object"));
 
-    std::shared_ptr<gbm_bo> bo{bo_raw, GBMBODeleter()};
+    std::weak_ptr<BOPool> const pool{bo_pool};
+    std::shared_ptr<gbm_bo> bo{
+        bo_raw,
+        [pool, key](gbm_bo* released)
+        {
+            std::unique_ptr<gbm_bo, GBMBODeleter> handle{released};
+            if (auto const live_pool = pool.lock())
+            {
+                size_t const bytes = gbm_bo_get_stride(released) * key.size.height.as_uint32_t();
+                live_pool->give(key, std::move(handle), bytes);
+            }
+        }};
 
     return std::make_shared<GBMBuffer>(
         bo, native_flags, make_texture_binder(buffer_import_method, bo, egl_extensions));
@@ -332,8 +390,7 @@ std::shared_ptr<mg::Buffer> mgm::BufferAllocator::alloc_software_buffer(
 
     auto const stride = geom::Stride{MIR_BYTES_PER_PIXEL(format) * size.width.as_uint32_t()};
     size_t const size_in_bytes = stride.as_int() * size.height.as_int();
-    return std::make_shared<mgm::SoftwareBuffer>(
-        std::make_unique<mir::AnonymousShmFile>(size_in_bytes), size, format);
+    return std::make_shared<mgm::SoftwareBuffer>(shm_pool->take(size_in_bytes), size, format);
 }
 
 std::vector<MirPixelFormat> mgm::BufferAllocator::supported_pixel_formats()
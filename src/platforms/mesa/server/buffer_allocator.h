@@ -49,6 +49,11 @@ namespace graphics
 class Display;
 struct EGLExtensions;
 
+namespace common
+{
+class ShmFilePool;
+}
+
 namespace mesa
 {
 
@@ -84,6 +89,8 @@ private:
     std::shared_ptr<Buffer> alloc_hardware_buffer(
         graphics::BufferProperties const& buffer_properties);
 
+    class BOPool;
+
     std::shared_ptr<renderer::gl::Context> const ctx;
     std::shared_ptr<Executor> wayland_executor;
     gbm_device* const device;
@@ -91,6 +98,10 @@ private:
 
     BypassOption const bypass_option;
     BufferImportMethod const buffer_import_method;
+
+    // Released buffer storage, reused by later allocations
+    std::shared_ptr<BOPool> const bo_pool;
+    std::shared_ptr<common::ShmFilePool> const shm_pool;
 };
 
 }
@@ -100,6 +100,7 @@ gbm_device* gbm_create_device_checked(int fd)
 }
 
 mgm::Cursor::GBMBOWrapper::GBMBOWrapper(int fd, MirOrientation orientation) :
+    holds_image{false},
     device{gbm_create_device_checked(fd)},
     buffer{
         gbm_bo_create(
@@ -127,7 +128,8 @@ inline mgm::Cursor::GBMBOWrapper::~GBMBOWrapper()
 }
 
 mgm::Cursor::GBMBOWrapper::GBMBOWrapper(GBMBOWrapper&& from)
-    : device{from.device},
+    : holds_image{from.holds_image},
+      device{from.device},
       buffer{from.buffer},
       current_orientation{from.current_orientation}
 {
@@ -273,6 +275,7 @@ void mgm::Cursor::pad_and_write_image_data_locked(
     }
 
     write_buffer_data_locked(lg, buffer, &padded[0], padded_size);
+    buffer.holds_image = true;
 }
 
 void mgm::Cursor::show()
@@ -290,12 +293,27 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
 {
     std::lock_guard<std::mutex> lg(guard);
 
-    size = cursor_image.size();
+    auto const new_size = cursor_image.size();
+    auto const new_hotspot = cursor_image.hotspot();
+    auto const image_bytes = new_size.width.as_uint32_t() * new_size.height.as_uint32_t() * 4;
 
-    argb8888.resize(size.width.as_uint32_t() * size.height.as_uint32_t() * 4);
+    // The same image is often shown again (e.g. as the pointer crosses
+    // between surfaces using the default cursor): the buffers already hold it
+    if (new_size == size && new_hotspot == hotspot && image_bytes == argb8888.size() &&
+        memcmp(argb8888.data(), cursor_image.as_argb_8888(), image_bytes) == 0)
+    {
+        auto const was_visible = visible;
+        visible = true;
+        place_cursor_at_locked(lg, current_position, was_visible ? UpdateState : ForceState);
+        return;
+    }
+
+    size = new_size;
+
+    argb8888.resize(image_bytes);
     memcpy(argb8888.data(), cursor_image.as_argb_8888(), argb8888.size());
 
-    hotspot = cursor_image.hotspot();
+    hotspot = new_hotspot;
     {
         auto locked_buffers = buffers.lock();
         for (auto& tuple : *locked_buffers)
@@ -312,7 +330,12 @@ void mgm::Cursor::show(CursorImage const& cursor_image)
 
 void mgm::Cursor::move_to(geometry::Point position)
 {
-    place_cursor_at(position, UpdateState);
+    std::lock_guard<std::mutex> lg(guard);
+
+    if (position == current_position)
+        return;
+
+    place_cursor_at_locked(lg, position, UpdateState);
 }
 
 void mir::graphics::mesa::Cursor::suspend()
@@ -398,7 +421,7 @@ void mgm::Cursor::place_cursor_at_locked(
 
             auto const changed_orientation = buffer.change_orientation(orientation);
 
-            if (changed_orientation)
+            if (changed_orientation || !buffer.holds_image)
                 pad_and_write_image_data_locked(lg, buffer);
 
             if (force_state || !output.has_cursor() || changed_orientation)
@@ -120,6 +120,10 @@ private:
         auto orientation() const -> MirOrientation { return current_orientation; }
         auto change_orientation(MirOrientation new_orientation) -> bool;
 
+        // False until the current cursor image has been written (e.g. for
+        // a buffer created when an output appears after the image was shown)
+        bool holds_image;
+
         ~GBMBOWrapper();
 
         GBMBOWrapper(GBMBOWrapper&& from);
@@ -164,6 +164,17 @@ bool needs_bounce_buffer(mgm::KMSOutput const& destination, gbm_bo* source)
     return destination.buffer_requires_migration(source);
 }
 
+uint32_t scanout_format(gbm_bo* bo)
+{
+    // As in KMSOutput::fb_for(), KMS needs fourcc formats
+    auto const format = gbm_bo_get_format(bo);
+    if (format == GBM_BO_FORMAT_XRGB8888)
+        return GBM_FORMAT_XRGB8888;
+    else if (format == GBM_BO_FORMAT_ARGB8888)
+        return GBM_FORMAT_ARGB8888;
+    return format;
+}
+
 const GLchar* const vshader =
     {
         "attribute vec4 position;\n"
@@ -550,6 +561,10 @@ mgm::DisplayBuffer::DisplayBuffer(
 
     set_crtc(*outputs.front()->fb_for(visible_composite_frame));
 
+    // Planes would need showing on every output in clone mode
+    if (outputs.size() == 1)
+        planes = outputs.front()->planes();
+
     release_current();
 
     listener->report_successful_drm_mode_set_crtc_on_construction();
@@ -563,6 +578,11 @@ mgm::DisplayBuffer::DisplayBuffer(
 
 mgm::DisplayBuffer::~DisplayBuffer()
 {
+    // Don't leave client buffers on the screen
+    for (auto const& frame : visible_plane_frames)
+        outputs.front()->clear_plane(frame.plane_id);
+    for (auto const& frame : scheduled_plane_frames)
+        outputs.front()->clear_plane(frame.plane_id);
 }
 
 geom::Rectangle mgm::DisplayBuffer::view_area() const
@@ -583,6 +603,8 @@ void mgm::DisplayBuffer::set_transformation(glm::mat2 const& t, geometry::Rectan
 
 bool mgm::DisplayBuffer::overlay(RenderableList const& renderable_list)
 {
+    plane_frames.clear();
+
     glm::mat2 static const no_transformation(1);
     if (transform == no_transformation &&
        (bypass_option == mgm::BypassOption::allowed))
@@ -612,6 +634,78 @@ bool mgm::DisplayBuffer::overlay(RenderableList const& renderable_list)
     return false;
 }
 
+mg::RenderableList mgm::DisplayBuffer::assign_planes(RenderableList const& renderables)
+{
+    plane_frames.clear();
+
+    glm::mat2 static const no_transformation(1);
+    if (planes.empty() ||
+        transform != no_transformation ||
+        bypass_option != mgm::BypassOption::allowed)
+    {
+        return renderables;
+    }
+
+    glm::mat4 static const identity(1);
+    auto& output = *outputs.front();
+
+    std::vector<kms::PlaneLayer> layers;
+    std::vector<gbm_bo*> bos;
+    layers.reserve(renderables.size());
+    bos.reserve(renderables.size());
+    for (auto const& renderable : renderables)
+    {
+        auto const buffer = renderable->buffer();
+        auto const native = std::dynamic_pointer_cast<mgm::NativeBuffer>(buffer->native_buffer_handle());
+        auto const position = renderable->screen_position();
+
+        bool const can_scanout =
+            native && native->flags & mir_buffer_flag_can_scanout &&
+            buffer->size() == position.size &&
+            renderable->alpha() == 1.0f &&
+            renderable->transformation() == identity &&
+            !needs_bounce_buffer(output, native->bo);
+
+        layers.push_back({position, can_scanout ? scanout_format(native->bo) : 0, can_scanout});
+        bos.push_back(can_scanout ? native->bo : nullptr);
+    }
+
+    std::vector<FBHandle*> fbs(renderables.size(), nullptr);
+    auto const uses = kms::assign_overlay_planes(
+        planes, layers, area,
+        [&](kms::PlaneUses const& uses)
+        {
+            // Legacy KMS has no test-only commit; the nearest check is that KMS takes the buffer
+            auto const layer = uses.back().layer;
+            fbs[layer] = output.fb_for(bos[layer]);
+            return fbs[layer] != nullptr;
+        });
+
+    if (uses.empty())
+        return renderables;
+
+    std::vector<bool> on_plane(renderables.size(), false);
+    for (auto const& use : uses)
+    {
+        auto const& position = layers[use.layer].area;
+        plane_frames.push_back({
+            use.plane_id,
+            renderables[use.layer]->buffer(),
+            fbs[use.layer],
+            {geom::Point{} + (position.top_left - area.top_left), position.size}});
+        on_plane[use.layer] = true;
+    }
+
+    RenderableList composited;
+    composited.reserve(renderables.size() - uses.size());
+    for (auto i = 0u; i != renderables.size(); ++i)
+    {
+        if (!on_plane[i])
+            composited.push_back(renderables[i]);
+    }
+    return composited;
+}
+
 void mgm::DisplayBuffer::for_each_display_buffer(
     std::function<void(graphics::DisplayBuffer&)> const& f)
 {
@@ -625,6 +719,18 @@ void mgm::DisplayBuffer::swap_buffers()
     bypass_bufobj = nullptr;
 }
 
+unsigned int mgm::DisplayBuffer::buffer_age()
+{
+    return surface.buffer_age();
+}
+
+void mgm::DisplayBuffer::swap_buffers_with_damage(geom::Rectangles const& damage)
+{
+    surface.swap_buffers_with_damage(damage);
+    bypass_buf = nullptr;
+    bypass_bufobj = nullptr;
+}
+
 void mgm::DisplayBuffer::set_crtc(FBHandle const& forced_frame)
 {
     for (auto& output : outputs)
@@ -683,6 +789,8 @@ void mgm::DisplayBuffer::post()
         needs_set_crtc = false;
     }
 
+    show_planes();
+
     using namespace std;  // For operator""ms()
 
     // Predicted worst case render time for the next frame...
@@ -744,6 +852,40 @@ std::chrono::milliseconds mgm::DisplayBuffer::recommended_sleep() const
     return recommend_sleep;
 }
 
+void mgm::DisplayBuffer::show_planes()
+{
+    if (plane_frames.empty() && visible_plane_frames.empty())
+        return;
+
+    auto& output = *outputs.front();
+
+    for (auto const& shown : visible_plane_frames)
+    {
+        auto const still_used = std::any_of(
+            plane_frames.begin(), plane_frames.end(),
+            [&shown](PlaneFrame const& frame) { return frame.plane_id == shown.plane_id; });
+        if (!still_used)
+            output.clear_plane(shown.plane_id);
+    }
+
+    for (auto const& frame : plane_frames)
+    {
+        if (!output.set_plane(frame.plane_id, *frame.fb, frame.position))
+        {
+            /*
+             * The renderable is missing from this frame. Rather than risk
+             * that again, composite everything from now on.
+             */
+            mir::log_warning("Failed to show a buffer on an overlay plane; no longer using overlay planes");
+            planes.clear();
+        }
+    }
+
+    // Plane buffer lifetimes are managed exclusively by scheduled*/visible* now
+    scheduled_plane_frames = std::move(plane_frames);
+    plane_frames.clear();
+}
+
 bool mgm::DisplayBuffer::schedule_page_flip(FBHandle const& bufobj)
 {
     /*
@@ -769,7 +911,7 @@ void mgm::DisplayBuffer::wait_for_page_flip()
         page_flips_pending = false;
     }
 
-    if (scheduled_bypass_frame || scheduled_composite_frame)
+    if (scheduled_bypass_frame || scheduled_composite_frame || !scheduled_plane_frames.empty())
     {
         // Why are both of these grouped into a single statement?
         // Because in either case both types of frame need releasing each time.
@@ -779,6 +921,9 @@ void mgm::DisplayBuffer::wait_for_page_flip()
 
         visible_composite_frame = std::move(scheduled_composite_frame);
         scheduled_composite_frame = nullptr;
+
+        visible_plane_frames = std::move(scheduled_plane_frames);
+        scheduled_plane_frames.clear();
     }
 }
 
@@ -850,6 +995,28 @@ void mgm::GBMOutputSurface::swap_buffers()
         fatal_error("Failed to perform buffer swap");
 }
 
+unsigned int mgm::GBMOutputSurface::buffer_age()
+{
+    return egl.buffer_age();
+}
+
+void mgm::GBMOutputSurface::swap_buffers_with_damage(geom::Rectangles const& damage)
+{
+    // EGL wants the damage relative to the bottom-left of the surface
+    std::vector<EGLint> rects;
+    rects.reserve(damage.size() * 4);
+    for (auto const& r : damage)
+    {
+        rects.push_back(r.left().as_int());
+        rects.push_back(static_cast<EGLint>(height) - r.bottom().as_int());
+        rects.push_back(r.size.width.as_int());
+        rects.push_back(r.size.height.as_int());
+    }
+
+    if (!egl.swap_buffers_with_damage(rects))
+        fatal_error("Failed to perform buffer swap");
+}
+
 void mgm::GBMOutputSurface::bind()
 {
 
@@ -21,10 +21,13 @@
 
 #include "mir/graphics/display_buffer.h"
 #include "mir/graphics/display.h"
+#include "mir/graphics/overlay_planes.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/renderer/gl/partial_redraw_target.h"
 #include "display_helpers.h"
 #include "egl_helper.h"
 #include "platform_common.h"
+#include "kms-utils/plane_assignment.h"
 
 #include <vector>
 #include <memory>
@@ -83,6 +86,9 @@ public:
     void swap_buffers() override;
     void bind() override;
 
+    unsigned int buffer_age();
+    void swap_buffers_with_damage(geometry::Rectangles const& damage);
+
     FrontBuffer lock_front();
     void report_egl_configuration(std::function<void(EGLDisplay, EGLConfig)> const& to);
     geometry::Size size() const { return {width, height}; }
@@ -96,7 +102,9 @@ private:
 class DisplayBuffer : public graphics::DisplayBuffer,
                       public graphics::DisplaySyncGroup,
                       public graphics::NativeDisplayBuffer,
-                      public renderer::gl::RenderTarget
+                      public graphics::OverlayPlanes,
+                      public renderer::gl::RenderTarget,
+                      public renderer::gl::PartialRedrawTarget
 {
 public:
     DisplayBuffer(BypassOption bypass_options,
@@ -112,6 +120,9 @@ public:
     void release_current() override;
     void swap_buffers() override;
     bool overlay(RenderableList const& renderlist) override;
+    RenderableList assign_planes(RenderableList const& renderables) override;
+    unsigned int buffer_age() override;
+    void swap_buffers_with_damage(geometry::Rectangles const& damage) override;
     void bind() override;
 
     void for_each_display_buffer(
@@ -129,6 +140,20 @@ public:
 private:
     bool schedule_page_flip(FBHandle const& bufobj);
     void set_crtc(FBHandle const&);
+    void show_planes();
+
+    /// A buffer shown on an overlay plane
+    struct PlaneFrame
+    {
+        uint32_t plane_id;
+        std::shared_ptr<graphics::Buffer> buffer;
+        FBHandle* fb;
+        geometry::Rectangle position;   ///< Relative to the output
+    };
+
+    std::vector<kms::PlaneInfo> planes;
+    std::vector<PlaneFrame> plane_frames;   ///< Chosen by assign_planes() for the next post()
+    std::vector<PlaneFrame> visible_plane_frames, scheduled_plane_frames;
 
     std::shared_ptr<graphics::Buffer> visible_bypass_frame, scheduled_bypass_frame;
     std::shared_ptr<Buffer> bypass_buf{nullptr};
@@ -21,6 +21,7 @@
 #include "mir/graphics/egl_error.h"
 #include <boost/exception/errinfo_errno.hpp>
 #include <boost/throw_exception.hpp>
+#include <cstring>
 
 #define MIR_LOG_COMPONENT "EGL"
 #include "mir/log.h"
@@ -55,7 +56,9 @@ mgmh::EGLHelper::EGLHelper(EGLHelper&& from)
       egl_config{from.egl_config},
       egl_context{from.egl_context},
       egl_surface{from.egl_surface},
-      should_terminate_egl{from.should_terminate_egl}
+      should_terminate_egl{from.should_terminate_egl},
+      has_buffer_age{from.has_buffer_age},
+      swap_buffers_with_damage_fn{from.swap_buffers_with_damage_fn}
 {
     from.should_terminate_egl = false;
     from.egl_display = EGL_NO_DISPLAY;
@@ -124,6 +127,8 @@ void mgmh::EGLHelper::setup(GBMHelper const& gbm, gbm_surface* surface_gbm,
     if(egl_surface == EGL_NO_SURFACE)
         BOOST_THROW_EXCEPTION(mg::egl_error("Failed to create EGL window surface"));
 
+    query_partial_redraw_support();
+
     egl_context = eglCreateContext(egl_display, egl_config, shared_context, context_attr);
     if (egl_context == EGL_NO_CONTEXT)
         BOOST_THROW_EXCEPTION(mg::egl_error("Failed to create EGL context"));
@@ -152,6 +157,24 @@ bool mgmh::EGLHelper::swap_buffers()
     return (ret == EGL_TRUE);
 }
 
+bool mgmh::EGLHelper::swap_buffers_with_damage(std::vector<EGLint> const& rects)
+{
+    if (!swap_buffers_with_damage_fn)
+        return swap_buffers();
+
+    auto ret = swap_buffers_with_damage_fn(
+        egl_display, egl_surface, rects.data(), static_cast<EGLint>(rects.size() / 4));
+    return (ret == EGL_TRUE);
+}
+
+EGLint mgmh::EGLHelper::buffer_age() const
+{
+    EGLint age = 0;
+    if (!has_buffer_age || eglQuerySurface(egl_display, egl_surface, EGL_BUFFER_AGE_EXT, &age) != EGL_TRUE)
+        return 0;
+    return age;
+}
+
 bool mgmh::EGLHelper::make_current() const
 {
     auto ret = eglMakeCurrent(egl_display, egl_surface, egl_surface, egl_context);
@@ -255,6 +278,32 @@ void mgmh::EGLHelper::setup_internal(GBMHelper const& gbm, bool initialize, EGLi
         std::runtime_error{std::string{"Failed to find EGL config matching "} + std::to_string(gbm_format)}));
 }
 
+void mgmh::EGLHelper::query_partial_redraw_support()
+{
+    auto const* extensions = eglQueryString(egl_display, EGL_EXTENSIONS);
+    if (!extensions)
+        return;
+
+    has_buffer_age = strstr(extensions, "EGL_EXT_buffer_age") != nullptr;
+
+    // The KHR and EXT variants have the same signature and semantics
+    if (strstr(extensions, "EGL_KHR_swap_buffers_with_damage"))
+    {
+        swap_buffers_with_damage_fn = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageKHR"));
+    }
+    else if (strstr(extensions, "EGL_EXT_swap_buffers_with_damage"))
+    {
+        swap_buffers_with_damage_fn = reinterpret_cast<PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC>(
+            eglGetProcAddress("eglSwapBuffersWithDamageEXT"));
+    }
+
+    mir::log_info(
+        "Partial redraw: buffer age %s, swap with damage %s",
+        has_buffer_age ? "supported" : "unsupported",
+        swap_buffers_with_damage_fn ? "supported" : "unsupported");
+}
+
 void mgmh::EGLHelper::report_egl_configuration(std::function<void(EGLDisplay, EGLConfig)> f)
 {
     f(egl_display, egl_config);
@@ -23,6 +23,8 @@
 #include "mir/graphics/egl_extensions.h"
 #include <EGL/egl.h>
 
+#include <vector>
+
 namespace mir
 {
 namespace graphics
@@ -53,6 +55,10 @@ public:
                EGLContext shared_context);
 
     bool swap_buffers();
+    /// Rects are {x, y, width, height} quadruples, with the origin bottom-left
+    bool swap_buffers_with_damage(std::vector<EGLint> const& rects);
+    /// 0 (unknown) unless EGL_EXT_buffer_age is supported
+    EGLint buffer_age() const;
     bool make_current() const;
     bool release_current() const;
 
@@ -61,6 +67,7 @@ public:
     void report_egl_configuration(std::function<void(EGLDisplay, EGLConfig)>);
 private:
     void setup_internal(GBMHelper const& gbm, bool initialize, EGLint gbm_format);
+    void query_partial_redraw_support();
 
     EGLint const depth_buffer_bits;
     EGLint const stencil_buffer_bits;
@@ -70,6 +77,8 @@ private:
     EGLSurface egl_surface;
     bool should_terminate_egl;
     EGLExtensions::PlatformBaseEXT platform_base;
+    bool has_buffer_age{false};
+    PFNEGLSWAPBUFFERSWITHDAMAGEKHRPROC swap_buffers_with_damage_fn{nullptr};
 };
 }
 }
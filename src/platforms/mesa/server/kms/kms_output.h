@@ -22,11 +22,13 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/point.h"
 #include "mir/geometry/displacement.h"
+#include "mir/geometry/rectangle.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/graphics/frame.h"
 #include "mir_toolkit/common.h"
 
 #include "kms-utils/drm_mode_resources.h"
+#include "kms-utils/plane_assignment.h"
 
 #include <gbm.h>
 
@@ -74,6 +76,24 @@ public:
     virtual bool clear_cursor() = 0;
     virtual bool has_cursor() const = 0;
 
+    /**
+     * The planes that can show images on this output's CRTC.
+     *
+     * Overlay planes are shown over the framebuffer given to set_crtc()
+     * or schedule_page_flip().
+     */
+    virtual std::vector<kms::PlaneInfo> planes() const = 0;
+    /**
+     * Shows fb, unscaled, on an overlay plane.
+     *
+     * \param [in] plane_id   One of the overlay planes()
+     * \param [in] fb         The framebuffer to show
+     * \param [in] position   Where to show it, relative to the top left of the output
+     * \return  True if the plane now shows fb
+     */
+    virtual bool set_plane(uint32_t plane_id, FBHandle const& fb, geometry::Rectangle const& position) = 0;
+    virtual void clear_plane(uint32_t plane_id) = 0;
+
     virtual void set_power_mode(MirPowerMode mode) = 0;
     virtual void set_gamma(GammaCurves const& gamma) = 0;
     virtual Frame last_frame() const = 0;
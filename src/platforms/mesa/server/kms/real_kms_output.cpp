@@ -324,6 +324,63 @@ bool mgm::RealKMSOutput::has_cursor() const
     return has_cursor_;
 }
 
+auto mgm::RealKMSOutput::planes() const -> std::vector<mgk::PlaneInfo>
+{
+    if (!current_crtc)
+        return {};
+
+    try
+    {
+        mgk::DRMModeResources const resources{drm_fd_};
+
+        int crtc_index = 0;
+        for (auto& crtc : resources.crtcs())
+        {
+            if (crtc->crtc_id == current_crtc->crtc_id)
+                return mgk::planes_for_crtc(drm_fd_, crtc_index);
+            ++crtc_index;
+        }
+    }
+    catch (std::exception const& error)
+    {
+        // Kernels without plane support still drive the CRTC itself
+        mir::log_info("Couldn't list planes of output %s (%s)",
+                      mgk::connector_name(connector).c_str(),
+                      error.what());
+    }
+
+    return {};
+}
+
+bool mgm::RealKMSOutput::set_plane(uint32_t plane_id, FBHandle const& fb, geom::Rectangle const& position)
+{
+    if (!current_crtc)
+        return false;
+
+    auto const width = position.size.width.as_uint32_t();
+    auto const height = position.size.height.as_uint32_t();
+
+    // The source rectangle is in 16.16 fixed point
+    auto const result = drmModeSetPlane(
+        drm_fd_, plane_id, current_crtc->crtc_id, fb.get_drm_fb_id(), 0,
+        position.top_left.x.as_int(), position.top_left.y.as_int(), width, height,
+        0, 0, width << 16, height << 16);
+    if (result)
+    {
+        mir::log_warning("set_plane: drmModeSetPlane failed (%s)", strerror(-result));
+        return false;
+    }
+    return true;
+}
+
+void mgm::RealKMSOutput::clear_plane(uint32_t plane_id)
+{
+    if (auto const result = drmModeSetPlane(drm_fd_, plane_id, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0))
+    {
+        mir::log_warning("clear_plane: drmModeSetPlane failed (%s)", strerror(-result));
+    }
+}
+
 bool mgm::RealKMSOutput::ensure_crtc()
 {
     /* Nothing to do if we already have a crtc */
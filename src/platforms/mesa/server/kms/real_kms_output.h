@@ -61,6 +61,10 @@ public:
     bool clear_cursor() override;
     bool has_cursor() const override;
 
+    std::vector<kms::PlaneInfo> planes() const override;
+    bool set_plane(uint32_t plane_id, FBHandle const& fb, geometry::Rectangle const& position) override;
+    void clear_plane(uint32_t plane_id) override;
+
     void set_power_mode(MirPowerMode mode) override;
     void set_gamma(GammaCurves const& gamma) override;
 
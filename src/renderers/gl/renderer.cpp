@@ -33,6 +33,7 @@
 #include "mir/graphics/texture.h"
 #include "mir/graphics/program_factory.h"
 #include "mir/graphics/program.h"
+#include "mir/renderer/gl/partial_redraw_target.h"
 
 #define GLM_FORCE_RADIANS
 #include <glm/gtc/matrix_transform.hpp>
@@ -42,6 +43,7 @@
 #include <boost/throw_exception.hpp>
 #include <stdexcept>
 #include <cmath>
+#include <cstddef>
 #include <sstream>
 
 namespace mg = mir::graphics;
@@ -49,9 +51,17 @@ namespace mgl = mir::gl;
 namespace mrg = mir::renderer::gl;
 namespace geom = mir::geometry;
 
+namespace
+{
+// Enough to cover triple buffering with a frame to spare
+size_t const max_tracked_buffer_age = 4;
+}
+
 mrg::CurrentRenderTarget::CurrentRenderTarget(mg::DisplayBuffer* display_buffer)
     : render_target{
-        dynamic_cast<renderer::gl::RenderTarget*>(display_buffer->native_display_buffer())}
+        dynamic_cast<renderer::gl::RenderTarget*>(display_buffer->native_display_buffer())},
+      partial_redraw_target{
+        dynamic_cast<renderer::gl::PartialRedrawTarget*>(display_buffer->native_display_buffer())}
 {
     if (!render_target)
         BOOST_THROW_EXCEPTION(std::logic_error("DisplayBuffer does not support GL rendering"));
@@ -80,6 +90,20 @@ void mrg::CurrentRenderTarget::swap_buffers()
     render_target->swap_buffers();
 }
 
+unsigned int mrg::CurrentRenderTarget::buffer_age()
+{
+    return partial_redraw_target ? partial_redraw_target->buffer_age() : 0;
+}
+
+void mrg::CurrentRenderTarget::swap_buffers_with_damage(geom::Rectangles const& damage)
+{
+    // An empty damage list means "everything" to EGL, so just swap
+    if (partial_redraw_target && damage.size() > 0)
+        partial_redraw_target->swap_buffers_with_damage(damage);
+    else
+        render_target->swap_buffers();
+}
+
 const GLchar* const mrg::Renderer::vshader =
 {
     "attribute vec3 position;\n"
@@ -396,6 +420,9 @@ mrg::Renderer::Renderer(graphics::DisplayBuffer& display_buffer)
 mrg::Renderer::~Renderer()
 {
     render_target.ensure_current();
+
+    if (vertex_buffer)
+        glDeleteBuffers(1, &vertex_buffer);
 }
 
 void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
@@ -405,21 +432,115 @@ void mrg::Renderer::tessellate(std::vector<mgl::Primitive>& primitives,
     primitives[0] = mgl::tessellate_renderable_into_rectangle(renderable, geom::Displacement{0,0});
 }
 
+void mrg::Renderer::set_damage(geom::Rectangles const& damage)
+{
+    this->damage = damage;
+    damage_set = true;
+}
+
+void mrg::Renderer::set_visible_regions(VisibleRegions const& regions)
+{
+    visible_regions = regions;
+}
+
 void mrg::Renderer::render(mg::RenderableList const& renderables) const
 {
     render_target.bind();
 
+    geom::Rectangles const frame_damage = damage_set ? damage : geom::Rectangles{viewport};
+    damage_set = false;
+
+    /*
+     * The back buffer holds the frame rendered "age" swaps ago. So it is
+     * only stale where something changed in this frame or any of the frames
+     * rendered since. If we don't know what changed over that time, we have
+     * to redraw everything.
+     */
+    auto const age = partial_redraw_possible ? render_target.buffer_age() : 0u;
+    bool const partial = age > 0 && age <= damage_history.size();
+
+    geom::Rectangle redraw = viewport;
+    if (partial)
+    {
+        geom::Rectangles stale = frame_damage;
+        for (auto i = 0u; i + 1 < age; ++i)
+        {
+            for (auto const& r : damage_history[i])
+                stale.add(r);
+        }
+
+        redraw = stale.size() > 0 ?
+            stale.bounding_rectangle().intersection_with(viewport) :
+            geom::Rectangle{};
+    }
+
+    damage_history.push_front(frame_damage);
+    if (damage_history.size() > max_tracked_buffer_age)
+        damage_history.pop_back();
+
+    if (partial)
+    {
+        glEnable(GL_SCISSOR_TEST);
+        scissor(to_framebuffer(redraw));
+    }
+
     glClearColor(clear_color[0], clear_color[1], clear_color[2], clear_color[3]);
     glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
     glClear(GL_COLOR_BUFFER_BIT);
 
+    // Everything is still drawn (keeping textures current in the cache), but
+    // the scissor test discards the fragments outside the redrawn area.
     ++frameno;
+    auto const uploaded_before = texture_cache->uploaded_bytes();
+    batches.clear();
+    batch_vertices.clear();
+    batch_clip_rects.clear();
     for (auto const& r : renderables)
     {
+        /*
+         * Where we know the renderable is partly hidden, only draw what
+         * can be seen (and needs redrawing). As with the redrawn area, the
+         * renderable is still drawn even if that leaves nothing.
+         */
+        auto const visible = visible_regions.find(r->id());
+        clipping = partial_redraw_possible &&
+                   visible != visible_regions.end() &&
+                   r->transformation() == glm::mat4(1);
+
+        if (clipping)
+        {
+            auto const clip = visible->second.intersection_with(redraw);
+            clip_rects.clear();
+            for (auto const& rect : clip.rectangles())
+                clip_rects.push_back(to_framebuffer(rect));
+        }
+
         draw(*r);
     }
+    clipping = false;
+    visible_regions.clear();
+
+    draw_batches(partial, redraw);
+    last_bytes_copied = texture_cache->uploaded_bytes() - uploaded_before;
+
+    if (partial)
+    {
+        glDisable(GL_SCISSOR_TEST);
 
-    render_target.swap_buffers();
+        geom::Rectangles framebuffer_damage;
+        for (auto const& r : frame_damage)
+        {
+            auto const visible = r.intersection_with(viewport);
+            if (visible.size.width.as_int() > 0 && visible.size.height.as_int() > 0)
+                framebuffer_damage.add(to_framebuffer(visible));
+        }
+
+        render_target.swap_buffers_with_damage(framebuffer_damage);
+    }
+    else
+    {
+        render_target.swap_buffers();
+    }
 
     // Deleting unused textures only requires the GL context. This clean-up
     // does not affect screen contents so can happen after swap_buffers...
@@ -429,6 +550,20 @@ void mrg::Renderer::render(mg::RenderableList const& renderables) const
         mir::log_debug("GL error: %d", gl_error);
 }
 
+geom::Rectangle mrg::Renderer::to_framebuffer(geom::Rectangle const& screen_rect) const
+{
+    return {screen_rect.top_left - as_displacement(viewport.top_left), screen_rect.size};
+}
+
+void mrg::Renderer::scissor(geom::Rectangle const& framebuffer_rect) const
+{
+    // GL window coordinates have the origin bottom-left
+    glScissor(framebuffer_rect.left().as_int(),
+              framebuffer_height - framebuffer_rect.bottom().as_int(),
+              framebuffer_rect.size.width.as_int(),
+              framebuffer_rect.size.height.as_int());
+}
+
 void mrg::Renderer::draw(mg::Renderable const& renderable) const
 {
     auto const texture = std::dynamic_pointer_cast<mg::gl::Texture>(renderable.buffer());
@@ -474,34 +609,16 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
         return;
     }
 
-    auto const& prog = *maybe_prog;
-
-    glUseProgram(prog.id);
-    if (prog.last_used_frameno != frameno)
-    {   // Avoid reloading the screen-global uniforms on every renderable
-        // TODO: We actually only need to bind these *once*, right? Not once per frame?
-        prog.last_used_frameno = frameno;
-        for (auto i = 0u; i < prog.tex_uniforms.size(); ++i)
-        {
-            if (prog.tex_uniforms[i] != -1)
-            {
-                glUniform1i(prog.tex_uniforms[i], i);
-            }
-        }
-        glUniformMatrix4fv(prog.display_transform_uniform, 1, GL_FALSE,
-                           glm::value_ptr(display_transform));
-        glUniformMatrix4fv(prog.screen_to_gl_coords_uniform, 1, GL_FALSE,
-                           glm::value_ptr(screen_to_gl_coords));
-    }
-
-    glActiveTexture(GL_TEXTURE0);
+    Batch batch;
+    batch.program = maybe_prog;
+    batch.surface_tex = surface_tex.get();
+    batch.texture = texture.get();
+    batch.alpha = renderable.alpha();
 
     auto const& rect = renderable.screen_position();
-    GLfloat centrex = rect.top_left.x.as_int() +
-                      rect.size.width.as_int() / 2.0f;
-    GLfloat centrey = rect.top_left.y.as_int() +
-                      rect.size.height.as_int() / 2.0f;
-    glUniform2f(prog.centre_uniform, centrex, centrey);
+    GLfloat const centre[2] = {
+        rect.top_left.x.as_int() + rect.size.width.as_int() / 2.0f,
+        rect.top_left.y.as_int() + rect.size.height.as_int() / 2.0f};
 
     glm::mat4 transform = renderable.transformation();
     if (texture && (texture->layout() == mg::gl::Texture::Layout::TopRowFirst))
@@ -516,96 +633,318 @@ void mrg::Renderer::draw(mg::Renderable const& renderable) const
         };
     }
 
-    glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
-                       glm::value_ptr(transform));
+    /*
+     * Affine transformations are applied to the vertices here, leaving the
+     * transform uniform as identity, so that renderables don't need their
+     * own uniforms (or draw calls). Projective ones are left to the vertex
+     * shader as they need perspective-correct texturing.
+     */
+    bool const affine =
+        transform[0][3] == 0.0f && transform[1][3] == 0.0f &&
+        transform[2][3] == 0.0f && transform[3][3] == 1.0f;
 
-    if (prog.alpha_uniform >= 0)
-        glUniform1f(prog.alpha_uniform, renderable.alpha());
+    if (affine)
+    {
+        batch.transform = glm::mat4(1);
+        batch.centre[0] = 0.0f;
+        batch.centre[1] = 0.0f;
+    }
+    else
+    {
+        batch.transform = transform;
+        batch.centre[0] = centre[0];
+        batch.centre[1] = centre[1];
+    }
 
-    glEnableVertexAttribArray(prog.position_attr);
-    glEnableVertexAttribArray(prog.texcoord_attr);
+    // These renderable method names could be better (see LP: #1236224)
+    if (renderable.shaped())  // Client is RGBA:
+    {
+        batch.blend = {GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
+                       GL_ONE, GL_ONE_MINUS_SRC_ALPHA, 1.0f};
+    }
+    else if (renderable.alpha() == 1.0f)  // RGBX and no window translucency:
+    {
+        batch.blend = {GL_ONE,  GL_ZERO,
+                       GL_ZERO, GL_ONE, 1.0f};  // Avoid using src_alpha!
+    }
+    else
+    {   // Client is RGBX but we also have window translucency.
+        // The texture alpha channel is possibly uninitialized so we must be
+        // careful and avoid using SRC_ALPHA (LP: #1423462).
+        batch.blend = {GL_ONE,  GL_ONE_MINUS_CONSTANT_ALPHA,
+                       GL_ZERO, GL_ONE, renderable.alpha()};
+    }
+
+    batch.clipped = clipping;
+    batch.first_clip_rect = batch_clip_rects.size();
+    batch.clip_rect_count = clipping ? clip_rects.size() : 0;
+    if (clipping)
+        batch_clip_rects.insert(batch_clip_rects.end(), clip_rects.begin(), clip_rects.end());
 
     primitives.clear();
     tessellate(primitives, renderable);
 
-    // if we fail to load the texture, we need to carry on (part of lp:1629275)
-    try
+    if (surface_tex)
     {
-        typedef struct  // Represents parameters of glBlendFuncSeparate()
+        // The renderable may be packed into part of a shared (atlas) texture
+        auto const region = texture_cache->region(renderable);
+        for (auto& p : primitives)
         {
-            GLenum src_rgb, dst_rgb, src_alpha, dst_alpha;
-        } BlendSeparate;
+            for (auto i = 0; i != p.nvertices; ++i)
+            {
+                auto& texcoord = p.vertices[i].texcoord;
+                texcoord[0] = region.left + texcoord[0] * (region.right - region.left);
+                texcoord[1] = region.top + texcoord[1] * (region.bottom - region.top);
+            }
+        }
+    }
 
-        BlendSeparate client_blend;
+    for (auto const& p : primitives)
+    {
+        batch.mode = (p.type == GL_TRIANGLE_STRIP || p.type == GL_TRIANGLE_FAN) ? GL_TRIANGLES : p.type;
+        batch.first = batch_vertices.size();
+        add_vertices(p, affine ? &transform : nullptr, centre);
+        batch.count = batch_vertices.size() - batch.first;
 
-        // These renderable method names could be better (see LP: #1236224)
-        if (renderable.shaped())  // Client is RGBA:
+        if (!batches.empty() && batches.back().can_extend_with(batch))
+            batches.back().count += batch.count;
+        else
+            batches.push_back(batch);
+    }
+}
+
+void mrg::Renderer::add_vertices(
+    mgl::Primitive const& primitive,
+    glm::mat4 const* transform,
+    GLfloat const centre[2]) const
+{
+    auto const add =
+        [&](int i)
         {
-            client_blend = {GL_ONE, GL_ONE_MINUS_SRC_ALPHA,
-                            GL_ONE, GL_ONE_MINUS_SRC_ALPHA};
-        }
-        else if (renderable.alpha() == 1.0f)  // RGBX and no window translucency:
+            auto vertex = primitive.vertices[i];
+            if (transform)
+            {
+                auto const transformed = (*transform) * glm::vec4{
+                    vertex.position[0] - centre[0],
+                    vertex.position[1] - centre[1],
+                    vertex.position[2],
+                    1.0f};
+                vertex.position[0] = transformed[0] + centre[0];
+                vertex.position[1] = transformed[1] + centre[1];
+                vertex.position[2] = transformed[2];
+            }
+            batch_vertices.push_back(vertex);
+        };
+
+    // Strips and fans become lists of triangles, so that they can be batched
+    switch (primitive.type)
+    {
+    case GL_TRIANGLE_STRIP:
+        for (auto i = 0; i + 2 < primitive.nvertices; ++i)
         {
-            client_blend = {GL_ONE,  GL_ZERO,
-                            GL_ZERO, GL_ONE};  // Avoid using src_alpha!
-        }
-        else
-        {   // Client is RGBX but we also have window translucency.
-            // The texture alpha channel is possibly uninitialized so we must be
-            // careful and avoid using SRC_ALPHA (LP: #1423462).
-            client_blend = {GL_ONE,  GL_ONE_MINUS_CONSTANT_ALPHA,
-                            GL_ZERO, GL_ONE};
-            glBlendColor(0.0f, 0.0f, 0.0f, renderable.alpha());
+            // Every other triangle of a strip is wound the other way round
+            add(i % 2 ? i + 1 : i);
+            add(i % 2 ? i : i + 1);
+            add(i + 2);
         }
+        break;
 
-        for (auto const& p : primitives)
+    case GL_TRIANGLE_FAN:
+        for (auto i = 1; i + 1 < primitive.nvertices; ++i)
         {
-            BlendSeparate blend;
+            add(0);
+            add(i);
+            add(i + 1);
+        }
+        break;
+
+    default:
+        for (auto i = 0; i != primitive.nvertices; ++i)
+            add(i);
+        break;
+    }
+}
 
-            blend = client_blend;
-            if (surface_tex)
+bool mrg::Renderer::BlendSeparate::operator==(BlendSeparate const& other) const
+{
+    return src_rgb == other.src_rgb && dst_rgb == other.dst_rgb &&
+           src_alpha == other.src_alpha && dst_alpha == other.dst_alpha &&
+           constant_alpha == other.constant_alpha;
+}
+
+bool mrg::Renderer::Batch::can_extend_with(Batch const& next) const
+{
+    return mode == GL_TRIANGLES && next.mode == GL_TRIANGLES &&
+           !clipped && !next.clipped &&
+           program == next.program &&
+           surface_tex == next.surface_tex &&
+           texture == next.texture &&
+           alpha == next.alpha &&
+           blend == next.blend &&
+           centre[0] == next.centre[0] && centre[1] == next.centre[1] &&
+           transform == next.transform &&
+           first + count == next.first;
+}
+
+void mrg::Renderer::draw_batches(bool partial, geom::Rectangle const& redraw) const
+{
+    if (batches.empty())
+        return;
+
+    // A single upload of the whole frame's vertices
+    if (!vertex_buffer)
+        glGenBuffers(1, &vertex_buffer);
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
+    glBufferData(GL_ARRAY_BUFFER,
+                 batch_vertices.size() * sizeof(mgl::Vertex),
+                 batch_vertices.data(),
+                 GL_STREAM_DRAW);
+
+    glActiveTexture(GL_TEXTURE0);
+
+    Program const* current_program = nullptr;
+    BlendSeparate current_blend{};
+    bool blend_known = false;
+
+    for (auto const& batch : batches)
+    {
+        auto const& prog = *batch.program;
+
+        if (&prog != current_program)
+        {
+            if (current_program)
             {
-                surface_tex->bind();
+                glDisableVertexAttribArray(current_program->texcoord_attr);
+                glDisableVertexAttribArray(current_program->position_attr);
             }
-            else
-            {
-                texture->bind();
+            current_program = &prog;
+
+            glUseProgram(prog.id);
+            if (prog.last_used_frameno != frameno)
+            {   // Avoid reloading the screen-global uniforms on every renderable
+                // TODO: We actually only need to bind these *once*, right? Not once per frame?
+                prog.last_used_frameno = frameno;
+                for (auto i = 0u; i < prog.tex_uniforms.size(); ++i)
+                {
+                    if (prog.tex_uniforms[i] != -1)
+                    {
+                        glUniform1i(prog.tex_uniforms[i], i);
+                    }
+                }
+                glUniformMatrix4fv(prog.display_transform_uniform, 1, GL_FALSE,
+                                   glm::value_ptr(display_transform));
+                glUniformMatrix4fv(prog.screen_to_gl_coords_uniform, 1, GL_FALSE,
+                                   glm::value_ptr(screen_to_gl_coords));
+
+                prog.transform = batch.transform;
+                glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
+                                   glm::value_ptr(prog.transform));
+                prog.centre[0] = batch.centre[0];
+                prog.centre[1] = batch.centre[1];
+                glUniform2f(prog.centre_uniform, prog.centre[0], prog.centre[1]);
+                prog.alpha = batch.alpha;
+                if (prog.alpha_uniform >= 0)
+                    glUniform1f(prog.alpha_uniform, prog.alpha);
             }
 
+            glEnableVertexAttribArray(prog.position_attr);
+            glEnableVertexAttribArray(prog.texcoord_attr);
             glVertexAttribPointer(prog.position_attr, 3, GL_FLOAT,
                                   GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].position);
+                                  reinterpret_cast<void const*>(offsetof(mgl::Vertex, position)));
             glVertexAttribPointer(prog.texcoord_attr, 2, GL_FLOAT,
                                   GL_FALSE, sizeof(mgl::Vertex),
-                                  &p.vertices[0].texcoord);
+                                  reinterpret_cast<void const*>(offsetof(mgl::Vertex, texcoord)));
+        }
 
-            if (blend.dst_rgb == GL_ZERO)
+        if (batch.transform != prog.transform)
+        {
+            prog.transform = batch.transform;
+            glUniformMatrix4fv(prog.transform_uniform, 1, GL_FALSE,
+                               glm::value_ptr(prog.transform));
+        }
+
+        if (batch.centre[0] != prog.centre[0] || batch.centre[1] != prog.centre[1])
+        {
+            prog.centre[0] = batch.centre[0];
+            prog.centre[1] = batch.centre[1];
+            glUniform2f(prog.centre_uniform, prog.centre[0], prog.centre[1]);
+        }
+
+        if (prog.alpha_uniform >= 0 && batch.alpha != prog.alpha)
+        {
+            prog.alpha = batch.alpha;
+            glUniform1f(prog.alpha_uniform, prog.alpha);
+        }
+
+        // if we fail to load the texture, we need to carry on (part of lp:1629275)
+        try
+        {
+            if (batch.surface_tex)
             {
-                glDisable(GL_BLEND);
+                batch.surface_tex->bind();
             }
             else
             {
-                glEnable(GL_BLEND);
-                glBlendFuncSeparate(blend.src_rgb,   blend.dst_rgb,
-                                    blend.src_alpha, blend.dst_alpha);
+                batch.texture->bind();
             }
 
-            glDrawArrays(p.type, 0, p.nvertices);
+            if (!blend_known || !(batch.blend == current_blend))
+            {
+                if (batch.blend.dst_rgb == GL_ZERO)
+                {
+                    glDisable(GL_BLEND);
+                }
+                else
+                {
+                    glEnable(GL_BLEND);
+                    glBlendFuncSeparate(batch.blend.src_rgb,   batch.blend.dst_rgb,
+                                        batch.blend.src_alpha, batch.blend.dst_alpha);
+                    if (batch.blend.dst_rgb == GL_ONE_MINUS_CONSTANT_ALPHA)
+                        glBlendColor(0.0f, 0.0f, 0.0f, batch.blend.constant_alpha);
+                }
+                current_blend = batch.blend;
+                blend_known = true;
+            }
 
-            if (texture)
+            if (batch.clipped)
+            {
+                glEnable(GL_SCISSOR_TEST);
+
+                auto const clip_rects_begin = batch_clip_rects.begin() + batch.first_clip_rect;
+                auto const clip_rects_end = clip_rects_begin + batch.clip_rect_count;
+                for (auto clip = clip_rects_begin; clip != clip_rects_end; ++clip)
+                {
+                    scissor(*clip);
+                    glDrawArrays(batch.mode, batch.first, batch.count);
+                }
+
+                if (partial)
+                    scissor(to_framebuffer(redraw));
+                else
+                    glDisable(GL_SCISSOR_TEST);
+            }
+            else
+            {
+                glDrawArrays(batch.mode, batch.first, batch.count);
+            }
+
+            if (batch.texture)
             {
                 // We're done with the texture for now
-                texture->add_syncpoint();
+                batch.texture->add_syncpoint();
             }
         }
-    }
-    catch (std::exception const& ex)
-    {
-        report_exception();
+        catch (std::exception const& ex)
+        {
+            report_exception();
+        }
     }
 
-    glDisableVertexAttribArray(prog.texcoord_attr);
-    glDisableVertexAttribArray(prog.position_attr);
+    glDisableVertexAttribArray(current_program->texcoord_attr);
+    glDisableVertexAttribArray(current_program->position_attr);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void mrg::Renderer::set_viewport(geometry::Rectangle const& rect)
@@ -669,6 +1008,10 @@ void mrg::Renderer::update_gl_viewport()
     auto surf = eglGetCurrentSurface(EGL_DRAW);
     EGLint buf_width = 0, buf_height = 0;
 
+    // Whatever we drew before no longer lines up with the new viewport
+    invalidate_damage_history();
+    partial_redraw_possible = false;
+
     if (viewport_width > 0.0f && viewport_height > 0.0f &&
         eglQuerySurface(dpy, surf, EGL_WIDTH, &buf_width) && buf_width > 0 &&
         eglQuerySurface(dpy, surf, EGL_HEIGHT, &buf_height) && buf_height > 0)
@@ -684,9 +1027,20 @@ void mrg::Renderer::update_gl_viewport()
         GLint offset_y = (buf_height - reduced_height) / 2;
 
         glViewport(offset_x, offset_y, reduced_width, reduced_height);
+
+        framebuffer_height = buf_height;
+        partial_redraw_possible =
+            display_transform == glm::mat4(1) &&
+            reduced_width == viewport.size.width.as_int() &&
+            reduced_height == viewport.size.height.as_int();
     }
 }
 
+void mrg::Renderer::invalidate_damage_history()
+{
+    damage_history.clear();
+}
+
 void mrg::Renderer::set_output_transform(glm::mat2 const& t)
 {
     auto const new_display_transform = glm::mat4(t);
@@ -700,5 +1054,11 @@ void mrg::Renderer::set_output_transform(glm::mat2 const& t)
 void mrg::Renderer::suspend()
 {
     texture_cache->invalidate();
+    invalidate_damage_history();
+}
+
+size_t mrg::Renderer::bytes_copied() const
+{
+    return last_bytes_copied;
 }
 
@@ -23,24 +23,27 @@
 
 #include <mir/renderer/renderer.h>
 #include <mir/geometry/rectangle.h>
+#include <mir/geometry/rectangles.h>
 #include <mir/graphics/buffer_id.h>
 #include <mir/graphics/renderable.h>
 #include <mir/gl/primitive.h>
 #include "mir/renderer/gl/render_target.h"
 
 #include MIR_SERVER_GL_H
+#include <deque>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 namespace mir
 {
-namespace gl { class TextureCache; }
-namespace graphics { class DisplayBuffer; }
+namespace gl { class TextureCache; class Texture; }
+namespace graphics { class DisplayBuffer; namespace gl { class Texture; } }
 namespace renderer
 {
 namespace gl
 {
+class PartialRedrawTarget;
 
 class CurrentRenderTarget
 {
@@ -52,8 +55,13 @@ public:
     void bind();
     void swap_buffers();
 
+    /// Zero (meaning unknown) unless the target preserves its buffers
+    unsigned int buffer_age();
+    void swap_buffers_with_damage(geometry::Rectangles const& damage);
+
 private:
     renderer::gl::RenderTarget* const render_target;
+    renderer::gl::PartialRedrawTarget* const partial_redraw_target;
 };
 
 class Renderer : public renderer::Renderer
@@ -65,11 +73,15 @@ public:
     // These are called with a valid GL context:
     void set_viewport(geometry::Rectangle const& rect) override;
     void set_output_transform(glm::mat2 const&) override;
+    void set_damage(geometry::Rectangles const& damage) override;
+    void set_visible_regions(VisibleRegions const& regions) override;
     void render(graphics::RenderableList const&) const override;
 
     // This is called _without_ a GL context:
     void suspend() override;
 
+    size_t bytes_copied() const override;
+
     struct Program
     {
         GLuint id = 0;
@@ -87,6 +99,11 @@ public:
         GLint alpha_uniform = -1;
         mutable long long last_used_frameno = 0;
 
+        // The per-draw uniforms as last uploaded (valid when used this frame)
+        mutable glm::mat4 transform;
+        mutable GLfloat centre[2];
+        mutable GLfloat alpha = 1.0f;
+
         Program(GLuint program_id);
     };
 private:
@@ -123,10 +140,53 @@ protected:
     static const GLchar* const default_fshader;
     static const GLchar* const alpha_fshader;
 
+    /**
+     * Adds the renderable to the frame being built. Nothing is submitted to
+     * GL until every renderable has been added, so that consecutive
+     * primitives sharing the same GL state can be drawn together.
+     */
     virtual void draw(graphics::Renderable const& renderable) const;
 
 private:
+    struct BlendSeparate  // Represents parameters of glBlendFuncSeparate()
+    {
+        GLenum src_rgb, dst_rgb, src_alpha, dst_alpha;
+        GLfloat constant_alpha;
+
+        bool operator==(BlendSeparate const& other) const;
+    };
+
+    /**
+     * A run of vertices in the frame's vertex buffer drawn with one set of
+     * GL state. The textures are owned by the texture cache and the
+     * renderables, which both outlive the frame.
+     */
+    struct Batch
+    {
+        Program const* program;
+        mir::gl::Texture* surface_tex;
+        graphics::gl::Texture* texture;
+        glm::mat4 transform;
+        GLfloat centre[2];
+        GLfloat alpha;
+        BlendSeparate blend;
+        GLenum mode;
+        GLint first;
+        GLsizei count;
+        bool clipped;
+        size_t first_clip_rect;
+        size_t clip_rect_count;
+
+        bool can_extend_with(Batch const& next) const;
+    };
+
+    void add_vertices(mir::gl::Primitive const& primitive, glm::mat4 const* transform, GLfloat const centre[2]) const;
+    void draw_batches(bool partial, geometry::Rectangle const& redraw) const;
+
     void update_gl_viewport();
+    void invalidate_damage_history();
+    geometry::Rectangle to_framebuffer(geometry::Rectangle const& screen_rect) const;
+    void scissor(geometry::Rectangle const& framebuffer_rect) const;
 
     class ProgramFactory;
     std::unique_ptr<ProgramFactory> const program_factory;
@@ -135,6 +195,30 @@ private:
     glm::mat4 screen_to_gl_coords;
     glm::mat4 display_transform;
     std::vector<mir::gl::Primitive> mutable primitives;
+
+    /// The frame being built by draw(), submitted by draw_batches()
+    std::vector<Batch> mutable batches;
+    std::vector<mir::gl::Vertex> mutable batch_vertices;
+    std::vector<geometry::Rectangle> mutable batch_clip_rects;
+    GLuint mutable vertex_buffer{0};
+
+    /*
+     * Partial redraw is only attempted when screen pixels map 1:1 onto
+     * framebuffer pixels (no output transform or letterbox scaling).
+     */
+    bool partial_redraw_possible{false};
+    GLint framebuffer_height{0};
+    geometry::Rectangles mutable damage;
+    bool mutable damage_set{false};
+    /// Damage of the frames rendered since the history was last invalidated, newest first
+    std::deque<geometry::Rectangles> mutable damage_history;
+
+    VisibleRegions mutable visible_regions;
+    /// When clipping, draw() only touches these (framebuffer) rectangles
+    bool mutable clipping{false};
+    std::vector<geometry::Rectangle> mutable clip_rects;
+
+    size_t mutable last_bytes_copied{0};
 };
 
 }
@@ -0,0 +1,301 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pixel_kernels.h"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define MIR_SW_HAVE_AVX2 1
+#endif
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace mrs = mir::renderer::software;
+
+namespace
+{
+uint32_t const opaque_alpha = 0xff000000;
+
+/// x * y / 255, rounded, for x and y in 0-255
+inline uint32_t mul_div_255(uint32_t x, uint32_t y)
+{
+    auto const t = x * y + 128;
+    return (t + (t >> 8)) >> 8;
+}
+
+inline uint32_t blend_pixel(uint32_t dest, uint32_t src, uint32_t alpha)
+{
+    if (alpha != 255)
+    {
+        src = mul_div_255(src & 0xff, alpha) |
+              mul_div_255((src >> 8) & 0xff, alpha) << 8 |
+              mul_div_255((src >> 16) & 0xff, alpha) << 16 |
+              mul_div_255(src >> 24, alpha) << 24;
+    }
+
+    auto const remaining = 255 - (src >> 24);
+    if (remaining == 0)
+        return src;
+
+    return src +
+          (mul_div_255(dest & 0xff, remaining) |
+           mul_div_255((dest >> 8) & 0xff, remaining) << 8 |
+           mul_div_255((dest >> 16) & 0xff, remaining) << 16 |
+           mul_div_255(dest >> 24, remaining) << 24);
+}
+
+void blend_line_scalar(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, uint32_t force_alpha)
+{
+    for (int i = 0; i != count; ++i)
+        dest[i] = blend_pixel(dest[i], src[i] | force_alpha, alpha);
+}
+
+#if defined(__SSE2__)
+/// x / 255, rounded, for each 16 bit x no greater than 255 * 255
+inline __m128i div_255(__m128i x)
+{
+    auto const t = _mm_add_epi16(x, _mm_set1_epi16(128));
+    return _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+}
+
+/// Blends two pixels, widened to 16 bits a channel
+inline __m128i blend_pixels(__m128i dest, __m128i src, __m128i alpha, bool scale)
+{
+    if (scale)
+        src = div_255(_mm_mullo_epi16(src, alpha));
+
+    auto const src_alpha =
+        _mm_shufflehi_epi16(_mm_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    auto const remaining = _mm_sub_epi16(_mm_set1_epi16(255), src_alpha);
+
+    return _mm_add_epi16(src, div_255(_mm_mullo_epi16(dest, remaining)));
+}
+
+void blend_line_sse2(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, uint32_t force_alpha)
+{
+    auto const zero = _mm_setzero_si128();
+    auto const alpha16 = _mm_set1_epi16(alpha);
+    auto const force = _mm_set1_epi32(force_alpha);
+    bool const scale = alpha != 255;
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const s = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i)), force);
+        auto const d = _mm_loadu_si128(reinterpret_cast<__m128i const*>(dest + i));
+
+        auto const lo = blend_pixels(_mm_unpacklo_epi8(d, zero), _mm_unpacklo_epi8(s, zero), alpha16, scale);
+        auto const hi = blend_pixels(_mm_unpackhi_epi8(d, zero), _mm_unpackhi_epi8(s, zero), alpha16, scale);
+
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+    }
+
+    blend_line_scalar(dest + i, src + i, count - i, alpha, force_alpha);
+}
+#endif
+
+#if defined(MIR_SW_HAVE_AVX2)
+__attribute__((target("avx2")))
+inline __m256i div_255_avx2(__m256i x)
+{
+    auto const t = _mm256_add_epi16(x, _mm256_set1_epi16(128));
+    return _mm256_srli_epi16(_mm256_add_epi16(t, _mm256_srli_epi16(t, 8)), 8);
+}
+
+__attribute__((target("avx2")))
+inline __m256i blend_pixels_avx2(__m256i dest, __m256i src, __m256i alpha, bool scale)
+{
+    if (scale)
+        src = div_255_avx2(_mm256_mullo_epi16(src, alpha));
+
+    auto const src_alpha =
+        _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(src, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    auto const remaining = _mm256_sub_epi16(_mm256_set1_epi16(255), src_alpha);
+
+    return _mm256_add_epi16(src, div_255_avx2(_mm256_mullo_epi16(dest, remaining)));
+}
+
+__attribute__((target("avx2")))
+void blend_line_avx2(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, uint32_t force_alpha)
+{
+    auto const zero = _mm256_setzero_si256();
+    auto const alpha16 = _mm256_set1_epi16(alpha);
+    auto const force = _mm256_set1_epi32(force_alpha);
+    bool const scale = alpha != 255;
+
+    // Unpacking works within each 128 bit half, and packing undoes it
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto const s = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<__m256i const*>(src + i)), force);
+        auto const d = _mm256_loadu_si256(reinterpret_cast<__m256i const*>(dest + i));
+
+        auto const lo = blend_pixels_avx2(_mm256_unpacklo_epi8(d, zero), _mm256_unpacklo_epi8(s, zero), alpha16, scale);
+        auto const hi = blend_pixels_avx2(_mm256_unpackhi_epi8(d, zero), _mm256_unpackhi_epi8(s, zero), alpha16, scale);
+
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(dest + i), _mm256_packus_epi16(lo, hi));
+    }
+
+    blend_line_scalar(dest + i, src + i, count - i, alpha, force_alpha);
+}
+#endif
+
+#if defined(__ARM_NEON)
+/// x * y / 255, rounded, for eight channels
+inline uint8x8_t mul_div_255(uint8x8_t x, uint8x8_t y)
+{
+    auto const t = vmull_u8(x, y);
+    return vraddhn_u16(t, vrshrq_n_u16(t, 8));
+}
+
+void blend_line_neon(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, uint32_t force_alpha)
+{
+    auto const alpha8 = vdup_n_u8(alpha);
+    bool const scale = alpha != 255;
+
+    // Eight pixels at a time, with their channels in separate registers
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        auto s = vld4_u8(reinterpret_cast<uint8_t const*>(src + i));
+        auto d = vld4_u8(reinterpret_cast<uint8_t const*>(dest + i));
+
+        if (force_alpha)
+            s.val[3] = vdup_n_u8(255);
+
+        if (scale)
+        {
+            for (int c = 0; c != 4; ++c)
+                s.val[c] = mul_div_255(s.val[c], alpha8);
+        }
+
+        auto const remaining = vmvn_u8(s.val[3]);
+        for (int c = 0; c != 4; ++c)
+            d.val[c] = vqadd_u8(s.val[c], mul_div_255(d.val[c], remaining));
+
+        vst4_u8(reinterpret_cast<uint8_t*>(dest + i), d);
+    }
+
+    blend_line_scalar(dest + i, src + i, count - i, alpha, force_alpha);
+}
+#endif
+
+using BlendLine = void(*)(uint32_t*, uint32_t const*, int, uint32_t, uint32_t);
+
+BlendLine select_blend_line()
+{
+#if defined(MIR_SW_HAVE_AVX2)
+    // We may be running before libgcc has looked at the CPU
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2"))
+        return &blend_line_avx2;
+#endif
+#if defined(__SSE2__)
+    return &blend_line_sse2;
+#elif defined(__ARM_NEON)
+    return &blend_line_neon;
+#else
+    return &blend_line_scalar;
+#endif
+}
+
+BlendLine const blend_line_impl = select_blend_line();
+}
+
+void mrs::fill_line(uint32_t* dest, uint32_t colour, int count)
+{
+    std::fill_n(dest, count, colour);
+}
+
+void mrs::copy_line(uint32_t* dest, uint32_t const* src, int count)
+{
+    memcpy(dest, src, count * sizeof *dest);
+}
+
+void mrs::copy_swapping_red_and_blue_line(uint32_t* dest, uint32_t const* src, int count)
+{
+    int i = 0;
+#if defined(__SSE2__)
+    auto const alpha_green = _mm_set1_epi32(0xff00ff00);
+    auto const blue = _mm_set1_epi32(0x000000ff);
+    for (; i + 4 <= count; i += 4)
+    {
+        auto const p = _mm_loadu_si128(reinterpret_cast<__m128i const*>(src + i));
+        auto const swapped = _mm_or_si128(
+            _mm_and_si128(p, alpha_green),
+            _mm_or_si128(
+                _mm_slli_epi32(_mm_and_si128(p, blue), 16),
+                _mm_and_si128(_mm_srli_epi32(p, 16), blue)));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), swapped);
+    }
+#elif defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8)
+    {
+        auto p = vld4_u8(reinterpret_cast<uint8_t const*>(src + i));
+        std::swap(p.val[0], p.val[2]);
+        vst4_u8(reinterpret_cast<uint8_t*>(dest + i), p);
+    }
+#endif
+    for (; i != count; ++i)
+    {
+        auto const p = src[i];
+        dest[i] = (p & 0xff00ff00) | (p & 0xff) << 16 | ((p >> 16) & 0xff);
+    }
+}
+
+void mrs::blend_line(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, bool opaque)
+{
+    blend_line_impl(dest, src, count, alpha, opaque ? opaque_alpha : 0);
+}
+
+void mrs::copy_block_transformed(
+    uint32_t* dest, int dest_stride,
+    uint32_t const* src, int x_step, int y_step,
+    int width, int height)
+{
+    if (x_step == 1)
+    {
+        for (int y = 0; y != height; ++y)
+            copy_line(dest + y * dest_stride, src + y * y_step, width);
+        return;
+    }
+
+    // Turning a block means reading down columns, so work in tiles small
+    // enough that the rows read stay in the cache
+    int const tile = 32;
+    for (int tile_y = 0; tile_y < height; tile_y += tile)
+    {
+        auto const tile_height = std::min(tile, height - tile_y);
+        for (int tile_x = 0; tile_x < width; tile_x += tile)
+        {
+            auto const tile_width = std::min(tile, width - tile_x);
+            for (int y = tile_y; y != tile_y + tile_height; ++y)
+            {
+                auto* const out = dest + y * dest_stride;
+                auto const* in = src + y * y_step + tile_x * x_step;
+                for (int x = tile_x; x != tile_x + tile_width; ++x, in += x_step)
+                    out[x] = *in;
+            }
+        }
+    }
+}
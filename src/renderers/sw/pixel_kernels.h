@@ -0,0 +1,61 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_PIXEL_KERNELS_H_
+#define MIR_RENDERER_SW_PIXEL_KERNELS_H_
+
+#include <cstdint>
+
+namespace mir
+{
+namespace renderer
+{
+namespace software
+{
+/*
+ * The inner loops of the software renderer. Pixels are 32 bit ARGB with
+ * premultiplied alpha, as for the GL renderer. Where the CPU has them,
+ * these use SSE2, AVX2 or NEON.
+ */
+
+void fill_line(uint32_t* dest, uint32_t colour, int count);
+
+void copy_line(uint32_t* dest, uint32_t const* src, int count);
+
+/// Copies ABGR to ARGB (or vice versa)
+void copy_swapping_red_and_blue_line(uint32_t* dest, uint32_t const* src, int count);
+
+/**
+ * Draws src over dest, first scaling src by alpha (0-255). If opaque the
+ * alpha channel of src is ignored and taken to be 255.
+ */
+void blend_line(uint32_t* dest, uint32_t const* src, int count, uint32_t alpha, bool opaque);
+
+/**
+ * Fills a width x height block of dest, reading src as it goes. src moves
+ * on by x_step pixels for each pixel along a dest row, and by y_step pixels
+ * from one dest row to the next: so a block can be copied turned through
+ * any multiple of 90 degrees, or flipped.
+ */
+void copy_block_transformed(
+    uint32_t* dest, int dest_stride,
+    uint32_t const* src, int x_step, int y_step,
+    int width, int height);
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_PIXEL_KERNELS_H_ */
@@ -0,0 +1,427 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define MIR_LOG_COMPONENT "SoftwareRenderer"
+
+#include "renderer.h"
+#include "pixel_kernels.h"
+
+#include "mir/renderer/sw/pixel_source.h"
+#include "mir/renderer/sw/pixel_target.h"
+#include "mir/graphics/display_buffer.h"
+#include "mir/graphics/buffer.h"
+#include "mir/thread/basic_thread_pool.h"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <future>
+#include <stdexcept>
+#include <thread>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace geom = mir::geometry;
+
+namespace
+{
+uint32_t const black = 0xff000000;
+
+// As for the GL renderer: older frames aren't worth tracking
+unsigned const max_tracked_buffer_age = 3;
+
+// Below this it costs more to hand work to another thread than to do it
+int const min_pixels_per_band = 128 * 128;
+
+bool can_draw(MirPixelFormat format)
+{
+    switch (format)
+    {
+    case mir_pixel_format_argb_8888:
+    case mir_pixel_format_xrgb_8888:
+    case mir_pixel_format_abgr_8888:
+    case mir_pixel_format_xbgr_8888:
+        return true;
+
+    default:
+        return false;
+    }
+}
+
+int area_of(geom::Region const& region)
+{
+    int area = 0;
+    for (auto const& r : region.rectangles())
+        area += r.size.width.as_int() * r.size.height.as_int();
+    return area;
+}
+}
+
+mrs::Renderer::Renderer(mg::DisplayBuffer& display_buffer) :
+    target{dynamic_cast<PixelTarget*>(display_buffer.native_display_buffer())},
+    workers{std::thread::hardware_concurrency() > 1 ? std::make_unique<mir::thread::BasicThreadPool>(0) : nullptr},
+    max_bands{std::max(1u, std::thread::hardware_concurrency())},
+    viewport{display_buffer.view_area()},
+    output_transform{1},
+    transform{{1, 0}, {0, 1}}
+{
+    if (!target)
+        BOOST_THROW_EXCEPTION(std::logic_error("DisplayBuffer does not support software rendering"));
+
+    set_output_transform(display_buffer.transformation());
+}
+
+mrs::Renderer::~Renderer() = default;
+
+void mrs::Renderer::set_viewport(geom::Rectangle const& rect)
+{
+    if (rect == viewport)
+        return;
+
+    viewport = rect;
+    untransformed_valid = false;
+    damage_history.clear();
+}
+
+void mrs::Renderer::set_output_transform(glm::mat2 const& t)
+{
+    if (t == output_transform)
+        return;
+
+    output_transform = t;
+
+    // Only quarter turns and flips keep pixels whole
+    int whole[2][2];
+    bool valid = true;
+    for (int col = 0; col != 2; ++col)
+    {
+        for (int row = 0; row != 2; ++row)
+        {
+            whole[col][row] = static_cast<int>(std::lround(t[col][row]));
+            valid = valid && whole[col][row] == t[col][row];
+        }
+        valid = valid && std::abs(whole[col][0]) + std::abs(whole[col][1]) == 1;
+    }
+    valid = valid && std::abs(whole[0][0] * whole[1][1] - whole[1][0] * whole[0][1]) == 1;
+
+    if (!valid)
+    {
+        mir::log_warning("Software renderer can only turn outputs through multiples of 90 degrees");
+        whole[0][0] = whole[1][1] = 1;
+        whole[0][1] = whole[1][0] = 0;
+    }
+
+    std::copy(&whole[0][0], &whole[0][0] + 4, &transform[0][0]);
+    transformed = !(transform[0][0] == 1 && transform[1][1] == 1);
+    untransformed_valid = false;
+    damage_history.clear();
+}
+
+void mrs::Renderer::set_damage(geom::Rectangles const& damage)
+{
+    this->damage = damage;
+    damage_set = true;
+}
+
+void mrs::Renderer::set_visible_regions(VisibleRegions const& regions)
+{
+    visible_regions = regions;
+}
+
+void mrs::Renderer::render(mg::RenderableList const& renderables) const
+{
+    geom::Region frame_damage;
+    if (damage_set)
+    {
+        for (auto const& r : damage)
+            frame_damage.add(r.intersection_with(viewport));
+    }
+    else
+    {
+        frame_damage.add(viewport);
+    }
+    damage_set = false;
+
+    Frame frame;
+    geom::Region redraw;
+
+    if (transformed)
+    {
+        // We keep our own copy of the frame, so only need to redraw what changed
+        size_t const pixels = viewport.size.width.as_int() * viewport.size.height.as_int();
+        if (untransformed.size() != pixels)
+        {
+            untransformed.assign(pixels, black);
+            untransformed_valid = false;
+        }
+
+        frame = {untransformed.data(), viewport.size.width.as_int()};
+        redraw = untransformed_valid ? frame_damage : geom::Region{viewport};
+        untransformed_valid = true;
+    }
+    else
+    {
+        /*
+         * As for the GL renderer, the target's pixels are those drawn "age"
+         * frames ago, so they are stale where anything changed since.
+         */
+        auto const age = target->buffer_age();
+        if (age > 0 && age <= damage_history.size())
+        {
+            redraw = frame_damage;
+            for (auto i = 0u; i + 1 < age; ++i)
+                redraw.add(damage_history[i]);
+        }
+        else
+        {
+            redraw = viewport;
+        }
+
+        damage_history.push_front(frame_damage);
+        if (damage_history.size() > max_tracked_buffer_age)
+            damage_history.pop_back();
+
+        redraw.intersect({viewport.top_left, target->size()});
+        frame = {reinterpret_cast<uint32_t*>(target->pixels()), target->stride().as_int() / 4};
+    }
+
+    auto const origin = viewport.top_left;
+
+    in_bands(redraw, [&](geom::Region const& band)
+        {
+            for (auto const& r : band.rectangles())
+            {
+                for (int y = r.top().as_int(); y != r.bottom().as_int(); ++y)
+                {
+                    fill_line(
+                        frame.pixels + (y - origin.y.as_int()) * frame.stride + (r.left().as_int() - origin.x.as_int()),
+                        black,
+                        r.size.width.as_int());
+                }
+            }
+        });
+
+    for (auto const& renderable : renderables)
+    {
+        auto area = redraw.intersection_with(renderable->screen_position());
+
+        auto const visible = visible_regions.find(renderable->id());
+        if (visible != visible_regions.end())
+            area.intersect(visible->second);
+
+        if (!area.is_empty())
+            draw(*renderable, area, frame);
+    }
+    visible_regions.clear();
+
+    if (transformed)
+        copy_transformed(frame);
+
+    target->swap_buffers();
+}
+
+void mrs::Renderer::draw(mg::Renderable const& renderable, geom::Region const& area, Frame const& frame) const
+{
+    auto const buffer = renderable.buffer();
+    auto const format = buffer->pixel_format();
+    auto const source = dynamic_cast<PixelSource*>(buffer->native_buffer_base());
+
+    if (!source || !can_draw(format))
+        return;
+
+    auto const alpha = static_cast<uint32_t>(std::lround(std::min(std::max(renderable.alpha(), 0.0f), 1.0f) * 255));
+    if (alpha == 0)
+        return;
+
+    auto const position = renderable.screen_position().top_left;
+    auto const clipped = area.intersection_with({position, buffer->size()});
+    if (clipped.is_empty())
+        return;
+
+    bool const swap_red_and_blue =
+        format == mir_pixel_format_abgr_8888 || format == mir_pixel_format_xbgr_8888;
+    bool const opaque =
+        !renderable.shaped() || format == mir_pixel_format_xrgb_8888 || format == mir_pixel_format_xbgr_8888;
+    bool const copy = opaque && alpha == 255;
+
+    auto const source_stride = source->stride().as_int();
+    auto const origin = viewport.top_left;
+
+    source->read([&](unsigned char const* pixels)
+        {
+            in_bands(clipped, [&](geom::Region const& band)
+                {
+                    std::vector<uint32_t> swapped;
+
+                    for (auto const& r : band.rectangles())
+                    {
+                        auto const width = r.size.width.as_int();
+                        auto const x = r.left().as_int();
+
+                        if (swap_red_and_blue && !copy)
+                            swapped.resize(width);
+
+                        for (int y = r.top().as_int(); y != r.bottom().as_int(); ++y)
+                        {
+                            auto in = reinterpret_cast<uint32_t const*>(
+                                pixels + (y - position.y.as_int()) * source_stride) + (x - position.x.as_int());
+                            auto const out =
+                                frame.pixels + (y - origin.y.as_int()) * frame.stride + (x - origin.x.as_int());
+
+                            if (swap_red_and_blue)
+                            {
+                                if (copy)
+                                {
+                                    copy_swapping_red_and_blue_line(out, in, width);
+                                    continue;
+                                }
+
+                                copy_swapping_red_and_blue_line(swapped.data(), in, width);
+                                in = swapped.data();
+                            }
+
+                            if (copy)
+                                copy_line(out, in, width);
+                            else
+                                blend_line(out, in, width, alpha, opaque);
+                        }
+                    }
+                });
+        });
+}
+
+void mrs::Renderer::copy_transformed(Frame const& from) const
+{
+    auto const width = viewport.size.width.as_int();
+    auto const height = viewport.size.height.as_int();
+
+    // The transform works in GL coordinates: centred, with y up
+    bool const quarter_turn = transform[0][0] == 0;
+    auto const target_width = quarter_turn ? height : width;
+    auto const target_height = quarter_turn ? width : height;
+
+    // Where the target's top left comes from (working in halves to stay whole)
+    auto const u2 = -(target_width - 1);
+    auto const v2 = target_height - 1;
+    auto const x = (transform[0][0] * u2 + transform[0][1] * v2 + width - 1) / 2;
+    auto const y = (height - 1 - (transform[1][0] * u2 + transform[1][1] * v2)) / 2;
+
+    // ...and how far through our frame each step across or down the target is
+    auto const x_step = transform[0][0] - transform[1][0] * from.stride;
+    auto const y_step = transform[1][1] * from.stride - transform[0][1];
+
+    auto const size = target->size();
+    auto const copy_width = std::min(target_width, size.width.as_int());
+    auto const copy_height = std::min(target_height, size.height.as_int());
+    auto const target_stride = target->stride().as_int() / 4;
+    auto const target_pixels = reinterpret_cast<uint32_t*>(target->pixels());
+    auto const first = from.pixels + y * from.stride + x;
+
+    auto const bands = std::max(1, std::min<int>(max_bands, copy_width * copy_height / min_pixels_per_band));
+    auto const band_height = (copy_height + bands - 1) / bands;
+
+    in_parallel(bands, [&](unsigned band)
+        {
+            auto const top = static_cast<int>(band) * band_height;
+            auto const rows = std::min(band_height, copy_height - top);
+            if (rows > 0)
+            {
+                copy_block_transformed(
+                    target_pixels + top * target_stride, target_stride,
+                    first + top * y_step, x_step, y_step,
+                    copy_width, rows);
+            }
+        });
+}
+
+void mrs::Renderer::in_bands(
+    geom::Region const& area,
+    std::function<void(geom::Region const&)> const& draw_band) const
+{
+    auto const bounds = area.bounding_rectangle();
+    auto const height = bounds.size.height.as_int();
+    auto const bands = std::min(
+        height,
+        std::max(1, std::min<int>(max_bands, area_of(area) / min_pixels_per_band)));
+
+    if (bands <= 1)
+    {
+        draw_band(area);
+        return;
+    }
+
+    auto const band_height = (height + bands - 1) / bands;
+
+    in_parallel(bands, [&](unsigned band)
+        {
+            geom::Rectangle const rows{
+                {bounds.left(), bounds.top() + geom::DeltaY{static_cast<int>(band) * band_height}},
+                {bounds.size.width, geom::Height{band_height}}};
+
+            auto const band_area = area.intersection_with(rows);
+            if (!band_area.is_empty())
+                draw_band(band_area);
+        });
+}
+
+void mrs::Renderer::in_parallel(unsigned tasks, std::function<void(unsigned task)> const& run_task) const
+{
+    if (!workers || tasks <= 1)
+    {
+        for (auto task = 0u; task != tasks; ++task)
+            run_task(task);
+        return;
+    }
+
+    std::vector<std::future<void>> done;
+    done.reserve(tasks - 1);
+    for (auto task = 1u; task != tasks; ++task)
+        done.push_back(workers->run([&run_task, task] { run_task(task); }));
+
+    // The other tasks use run_task, so they must finish even if this one throws
+    std::exception_ptr failure;
+    try
+    {
+        run_task(0);
+    }
+    catch (...)
+    {
+        failure = std::current_exception();
+    }
+
+    for (auto& task : done)
+        task.wait();
+
+    if (failure)
+        std::rethrow_exception(failure);
+
+    for (auto& task : done)
+        task.get();
+}
+
+void mrs::Renderer::suspend()
+{
+    untransformed_valid = false;
+    damage_history.clear();
+}
+
+size_t mrs::Renderer::bytes_copied() const
+{
+    return 0;
+}
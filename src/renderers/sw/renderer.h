@@ -0,0 +1,103 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_RENDERER_SW_RENDERER_H_
+#define MIR_RENDERER_SW_RENDERER_H_
+
+#include <mir/renderer/renderer.h>
+#include <mir/geometry/rectangle.h>
+#include <mir/geometry/rectangles.h>
+#include <mir/geometry/region.h>
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace mir
+{
+namespace graphics { class DisplayBuffer; }
+namespace thread { class BasicThreadPool; }
+namespace renderer
+{
+namespace software
+{
+class PixelTarget;
+
+/**
+ * Draws with the CPU, for display buffers with a PixelTarget.
+ *
+ * Only buffers with a PixelSource (SHM and software buffers) in the 8888
+ * formats can be drawn, and they are drawn unscaled at their screen
+ * position: renderable transformations are not applied. The output
+ * transformation can be any multiple of 90 degrees, or a flip.
+ *
+ * Large areas are split into bands drawn on different cores. Buffers are
+ * read where they lie, so nothing is copied before drawing.
+ */
+class Renderer : public renderer::Renderer
+{
+public:
+    Renderer(graphics::DisplayBuffer& display_buffer);
+    ~Renderer();
+
+    void set_viewport(geometry::Rectangle const& rect) override;
+    void set_output_transform(glm::mat2 const&) override;
+    void set_damage(geometry::Rectangles const& damage) override;
+    void set_visible_regions(VisibleRegions const& regions) override;
+    void render(graphics::RenderableList const&) const override;
+    void suspend() override;
+    size_t bytes_copied() const override;
+
+private:
+    /// Pixels laid out as the viewport, with its top left at the origin
+    struct Frame
+    {
+        uint32_t* pixels;
+        int stride;     ///< In pixels
+    };
+
+    void draw(graphics::Renderable const& renderable, geometry::Region const& area, Frame const& frame) const;
+    void copy_transformed(Frame const& from) const;
+    void in_bands(geometry::Region const& area, std::function<void(geometry::Region const&)> const& draw_band) const;
+    void in_parallel(unsigned tasks, std::function<void(unsigned task)> const& run_task) const;
+
+    PixelTarget* const target;
+    std::unique_ptr<thread::BasicThreadPool> const workers;
+    unsigned const max_bands;
+
+    geometry::Rectangle viewport;
+    glm::mat2 output_transform;
+    /// The output transformation as whole numbers, for 90 degree turns
+    int transform[2][2];
+    bool transformed = false;
+
+    mutable geometry::Rectangles damage;
+    mutable bool damage_set = false;
+    mutable VisibleRegions visible_regions;
+    mutable std::deque<geometry::Region> damage_history;
+
+    /// Where we draw before turning the result onto the target
+    mutable std::vector<uint32_t> untransformed;
+    mutable bool untransformed_valid = false;
+};
+
+}
+}
+}
+
+#endif /* MIR_RENDERER_SW_RENDERER_H_ */
@@ -0,0 +1,135 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "damage_tracker.h"
+#include "mir/graphics/buffer.h"
+
+#include <unordered_map>
+
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+
+geom::Rectangles mc::DamageTracker::damage_for(
+    mg::RenderableList const& renderables,
+    geom::Rectangle const& area,
+    mir::renderer::Renderer::VisibleRegions const& clips)
+{
+    static glm::mat4 const identity(1);
+    static geom::Rectangle const empty{};
+
+    std::vector<Snapshot> current;
+    current.reserve(renderables.size());
+    for (auto const& renderable : renderables)
+    {
+        auto const buffer = renderable->buffer();
+        auto const clip = clips.find(renderable->id());
+        current.push_back({
+            renderable->id(),
+            buffer ? buffer->id() : mg::BufferID{},
+            renderable->screen_position(),
+            renderable->transformation(),
+            renderable->alpha(),
+            renderable->shaped(),
+            clip != clips.end(),
+            clip != clips.end() ? clip->second : geom::Region{}});
+    }
+
+    bool everything = !valid || area != previous_area;
+    geom::Rectangles damage;
+
+    auto const damage_at = [&](Snapshot const& snapshot)
+        {
+            if (snapshot.transformation != identity)
+            {   // Weirdly transformed. We can't tell where it ends up.
+                everything = true;
+                return;
+            }
+
+            auto const clipped = snapshot.position.intersection_with(area);
+            if (clipped != empty)
+                damage.add(clipped);
+        };
+
+    if (!everything)
+    {
+        std::unordered_map<mg::Renderable::ID, size_t> previous_index;
+        for (size_t i = 0; i != previous.size(); ++i)
+            previous_index[previous[i].id] = i;
+
+        std::vector<bool> still_present(previous.size(), false);
+        size_t highest_index_seen = 0;
+        bool seen_any = false;
+
+        for (auto const& now : current)
+        {
+            auto const found = previous_index.find(now.id);
+            if (found == previous_index.end())
+            {
+                damage_at(now);
+                continue;
+            }
+
+            auto const index = found->second;
+            auto const& then = previous[index];
+            still_present[index] = true;
+
+            /*
+             * A renderable that is now above something it used to be below
+             * changes the pixels where the two overlap, which is within its
+             * own bounds (and those are damaged below).
+             */
+            bool const restacked = seen_any && index < highest_index_seen;
+            if (!seen_any || index > highest_index_seen)
+                highest_index_seen = index;
+            seen_any = true;
+
+            if (restacked ||
+                now.buffer != then.buffer ||
+                now.position != then.position ||
+                now.transformation != then.transformation ||
+                now.alpha != then.alpha ||
+                now.shaped != then.shaped ||
+                now.clipped != then.clipped ||
+                now.clip != then.clip)
+            {
+                damage_at(then);
+                damage_at(now);
+            }
+        }
+
+        for (size_t i = 0; i != previous.size(); ++i)
+        {
+            if (!still_present[i])
+                damage_at(previous[i]);
+        }
+    }
+
+    previous = std::move(current);
+    previous_area = area;
+    valid = true;
+
+    if (everything)
+        return geom::Rectangles{area};
+
+    return damage;
+}
+
+void mc::DamageTracker::reset()
+{
+    valid = false;
+    previous.clear();
+}
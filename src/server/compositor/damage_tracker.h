@@ -0,0 +1,73 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+#define MIR_COMPOSITOR_DAMAGE_TRACKER_H_
+
+#include "mir/geometry/rectangles.h"
+#include "mir/graphics/buffer_id.h"
+#include "mir/graphics/renderable.h"
+#include "mir/renderer/renderer.h"
+
+#include <vector>
+
+namespace mir
+{
+namespace compositor
+{
+
+/**
+ * Works out which parts of an output changed between consecutive frames by
+ * comparing what each renderable looked like when last composited.
+ */
+class DamageTracker
+{
+public:
+    /**
+     * The areas of \a area that differ from the previously tracked frame.
+     * The renderables, and the regions they are clipped to, are remembered
+     * for comparison with the next frame.
+     */
+    geometry::Rectangles damage_for(
+        graphics::RenderableList const& renderables,
+        geometry::Rectangle const& area,
+        renderer::Renderer::VisibleRegions const& clips = {});
+
+    /// Forgets the previous frame, so that the next frame is fully damaged.
+    void reset();
+
+private:
+    struct Snapshot
+    {
+        graphics::Renderable::ID id;
+        graphics::BufferID buffer;
+        geometry::Rectangle position;
+        glm::mat4 transformation;
+        float alpha;
+        bool shaped;
+        bool clipped;
+        geometry::Region clip;
+    };
+
+    std::vector<Snapshot> previous;
+    geometry::Rectangle previous_area;
+    bool valid{false};
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_DAMAGE_TRACKER_H_ */
@@ -23,6 +23,7 @@
 #include "default_display_buffer_compositor_factory.h"
 #include "multi_threaded_compositor.h"
 #include "gl/renderer_factory.h"
+#include "sw/renderer_factory.h"
 #include "compositing_screencast.h"
 #include "mir/main_loop.h"
 
@@ -30,6 +31,7 @@
 #include "mir/options/configuration.h"
 
 #include <boost/throw_exception.hpp>
+#include <stdexcept>
 
 namespace mc = mir::compositor;
 namespace ms = mir::scene;
@@ -86,9 +88,23 @@ mir::DefaultServerConfiguration::the_compositor()
 std::shared_ptr<mir::renderer::RendererFactory> mir::DefaultServerConfiguration::the_renderer_factory()
 {
     return renderer_factory(
-        []()
+        [this]() -> std::shared_ptr<mir::renderer::RendererFactory>
         {
-            return std::make_shared<mir::renderer::gl::RendererFactory>();
+            auto const choice = the_options()->get<std::string>(options::renderer_opt);
+
+            if (choice == "gl")
+                return std::make_shared<mir::renderer::gl::RendererFactory>();
+
+            if (choice == "software")
+            {
+                // Only the offscreen display has buffers the CPU can draw into
+                if (!the_options()->is_set(options::offscreen_opt))
+                    BOOST_THROW_EXCEPTION(std::runtime_error("The software renderer needs --offscreen"));
+
+                return std::make_shared<mir::renderer::software::RendererFactory>();
+            }
+
+            BOOST_THROW_EXCEPTION(std::runtime_error("Unknown renderer: " + choice));
         });
 }
 
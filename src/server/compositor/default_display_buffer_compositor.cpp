@@ -23,6 +23,7 @@
 #include "mir/compositor/scene_element.h"
 #include "mir/graphics/renderable.h"
 #include "mir/graphics/display_buffer.h"
+#include "mir/graphics/overlay_planes.h"
 #include "mir/graphics/buffer.h"
 #include "mir/compositor/buffer_stream.h"
 #include "mir/renderer/renderer.h"
@@ -49,7 +50,8 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
     report->began_frame(this);
 
     auto const& view_area = display_buffer.view_area();
-    auto const& occlusions = mc::filter_occlusions_from(scene_elements, view_area);
+    mir::renderer::Renderer::VisibleRegions partially_visible;
+    auto const& occlusions = mc::filter_occlusions_from(scene_elements, view_area, partially_visible);
 
     for (auto const& element : occlusions)
         element->occluded();
@@ -76,13 +78,23 @@ void mc::DefaultDisplayBufferCompositor::composite(mc::SceneElementSequence&& sc
     {
         report->renderables_in_frame(this, renderable_list);
         renderer->suspend();
+
+        // The next composited frame can't build on the one before this.
+        damage_tracker.reset();
     }
     else
     {
+        // Whatever the hardware can show on its own planes needn't be drawn
+        if (auto const planes = dynamic_cast<mg::OverlayPlanes*>(display_buffer.native_display_buffer()))
+            renderable_list = planes->assign_planes(renderable_list);
+
         renderer->set_output_transform(display_buffer.transformation());
         renderer->set_viewport(view_area);
+        renderer->set_damage(damage_tracker.damage_for(renderable_list, view_area, partially_visible));
+        renderer->set_visible_regions(partially_visible);
         renderer->render(renderable_list);
 
+        report->copied_bytes(this, renderer->bytes_copied());
         report->renderables_in_frame(this, renderable_list);
         report->rendered_frame(this);
 
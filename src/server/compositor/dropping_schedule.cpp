@@ -31,15 +31,12 @@ void mc::DroppingSchedule::schedule(std::shared_ptr<mg::Buffer> const& buffer)
 {
     std::lock_guard<decltype(mutex)> lk(mutex);
     the_only_buffer = buffer;
+    have_buffer = static_cast<bool>(buffer);
 }
 
 unsigned int mc::DroppingSchedule::num_scheduled()
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
-    if (the_only_buffer)
-        return 1;
-    else
-        return 0;
+    return have_buffer ? 1 : 0;
 }
 
 std::shared_ptr<mg::Buffer> mc::DroppingSchedule::next_buffer()
@@ -49,5 +46,6 @@ std::shared_ptr<mg::Buffer> mc::DroppingSchedule::next_buffer()
         BOOST_THROW_EXCEPTION(std::logic_error("no buffer scheduled"));
     auto buffer = the_only_buffer;
     the_only_buffer = nullptr;
+    have_buffer = false;
     return buffer;
 }
@@ -0,0 +1,137 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "frame_scheduler.h"
+
+#include <algorithm>
+
+namespace mc = mir::compositor;
+
+using namespace std::literals::chrono_literals;
+
+namespace
+{
+// A post() returning quicker than this didn't wait for anything
+auto const min_blocking = 500us;
+
+// Refresh rates outside 10-250Hz are noise (or missed frames)
+auto const min_interval = 4ms;
+auto const max_interval = 100ms;
+
+// Intervals spanning more frames than this are too coarse to learn from
+int const max_frames_per_interval = 8;
+
+int const required_consistent_intervals = 3;
+
+// Our idea of the phase drifts if not corrected now and then
+auto const max_prediction_age = 500ms;
+}
+
+mc::FrameScheduler::FrameScheduler(Duration margin)
+    : margin{margin}
+{
+    render_times.fill(Duration::zero());
+}
+
+void mc::FrameScheduler::frame_posted(TimePoint began, TimePoint posting, TimePoint posted)
+{
+    render_times[next_render_time] = posting - began;
+    next_render_time = (next_render_time + 1) % render_times.size();
+
+    if (posted - posting < min_blocking)
+        return;
+
+    if (seen_vblank)
+    {
+        auto const since = posted - last_vblank;
+
+        if (since < min_interval)
+        {
+            // Too close to be separate vblanks
+        }
+        else if (interval == Duration::zero())
+        {
+            if (since <= max_interval)
+                interval = since;
+        }
+        else
+        {
+            auto const frames = (since + interval / 2) / interval;
+
+            if (frames == 0)
+            {
+                // What we took to be one frame was several
+                interval = since;
+                consistent_intervals = 0;
+            }
+            else if (frames <= max_frames_per_interval)
+            {
+                auto const sample = since / frames;
+                auto const error = sample - interval;
+
+                if (error < interval / 8 && -error < interval / 8)
+                {
+                    interval += error / 8;
+                    ++consistent_intervals;
+                }
+                else
+                {
+                    interval = sample;
+                    consistent_intervals = 0;
+                }
+            }
+        }
+    }
+
+    last_vblank = posted;
+    seen_vblank = true;
+}
+
+bool mc::FrameScheduler::has_prediction(TimePoint now) const
+{
+    return consistent_intervals >= required_consistent_intervals &&
+           now - last_vblank < max_prediction_age;
+}
+
+mc::FrameScheduler::TimePoint mc::FrameScheduler::next_vblank(TimePoint time) const
+{
+    if (time <= last_vblank || interval == Duration::zero())
+        return last_vblank;
+
+    auto const frames = (time - last_vblank + interval - Duration{1}) / interval;
+    return last_vblank + frames * interval;
+}
+
+mc::FrameScheduler::TimePoint mc::FrameScheduler::target_vblank(TimePoint now) const
+{
+    return next_vblank(now + lead_time());
+}
+
+mc::FrameScheduler::Duration mc::FrameScheduler::lead_time() const
+{
+    return render_time() + margin;
+}
+
+mc::FrameScheduler::Duration mc::FrameScheduler::refresh_interval() const
+{
+    return interval;
+}
+
+mc::FrameScheduler::Duration mc::FrameScheduler::render_time() const
+{
+    // Planning for the slowest recent frame rather than the average is what avoids dropping frames
+    return *std::max_element(render_times.begin(), render_times.end());
+}
@@ -0,0 +1,80 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_COMPOSITOR_FRAME_SCHEDULER_H_
+#define MIR_COMPOSITOR_FRAME_SCHEDULER_H_
+
+#include <array>
+#include <chrono>
+
+namespace mir
+{
+namespace compositor
+{
+
+/**
+ * Predicts the vblanks of a DisplaySyncGroup from when its post() returns,
+ * so that compositing can start just in time for the next one.
+ *
+ * Only a post() that blocked is taken to have returned at a vblank. Groups
+ * that never block (or don't block at vblank) never get a prediction.
+ */
+class FrameScheduler
+{
+public:
+    typedef std::chrono::steady_clock::time_point TimePoint;
+    typedef std::chrono::steady_clock::duration Duration;
+
+    /// \param margin   Time to allow on top of the longest recent render
+    explicit FrameScheduler(Duration margin);
+
+    /**
+     * Records a frame that started compositing at \a began and was passed
+     * to post() at \a posting, which returned at \a posted.
+     */
+    void frame_posted(TimePoint began, TimePoint posting, TimePoint posted);
+
+    /// Whether the vblanks are known well enough to schedule by at \a now
+    bool has_prediction(TimePoint now) const;
+
+    /// The first vblank predicted at or after \a time
+    TimePoint next_vblank(TimePoint time) const;
+
+    /// The earliest vblank a frame started at \a now can still make
+    TimePoint target_vblank(TimePoint now) const;
+
+    /// How long before its vblank compositing a frame should start
+    Duration lead_time() const;
+
+    Duration refresh_interval() const;
+    Duration render_time() const;
+
+private:
+    Duration const margin;
+
+    TimePoint last_vblank;
+    bool seen_vblank{false};
+    Duration interval{Duration::zero()};
+    int consistent_intervals{0};
+
+    std::array<Duration, 16> render_times;
+    size_t next_render_time{0};
+};
+
+}
+}
+
+#endif /* MIR_COMPOSITOR_FRAME_SCHEDULER_H_ */
@@ -23,6 +23,7 @@
 #include "schedule.h"
 #include <boost/throw_exception.hpp>
 #include <algorithm>
+#include <vector>
 
 namespace mg = mir::graphics;
 namespace mc = mir::compositor;
@@ -32,8 +33,8 @@ mc::MultiMonitorArbiter::MultiMonitorArbiter(
     std::shared_ptr<Schedule> const& schedule) :
     schedule(schedule)
 {
-    // We're highly unlikely to have more than 6 outputs
-    current_buffer_users.reserve(6);
+    for (auto& user : users)
+        user = nullptr;
 }
 
 mc::MultiMonitorArbiter::~MultiMonitorArbiter()
@@ -42,115 +43,127 @@ mc::MultiMonitorArbiter::~MultiMonitorArbiter()
 
 std::shared_ptr<mg::Buffer> mc::MultiMonitorArbiter::compositor_acquire(compositor::CompositorID id)
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
+    auto const user_bit = user_bit_for(id);
+    auto frame = current_frame();
 
     // If there is no current buffer or there is, but this compositor is already using it...
-    if (!current_buffer || is_user_of_current_buffer(id))
+    if (!frame || (frame->users & user_bit))
     {
-        // And if there is a scheduled buffer
-        if (schedule->num_scheduled() > 0)
-        {
-            // Advance the current buffer
-            current_buffer = schedule->next_buffer();
-            clear_current_users();
-        }
-        // Otherwise leave the current buffer alone
+        // ...advance the current buffer, if there is a scheduled buffer
+        frame = advance_from(frame);
     }
 
     // If there was no current buffer and we weren't able to set one, throw and exception
-    if (!current_buffer)
+    if (!frame)
         BOOST_THROW_EXCEPTION(std::logic_error("no buffer to give to compositor"));
 
     // The compositor is now a user of the current buffer
     // This means we will try to give it a new buffer next time it asks
-    add_current_buffer_user(id);
-    return current_buffer;
+    frame->users |= user_bit;
+    return frame->buffer;
 }
 
 std::shared_ptr<mg::Buffer> mc::MultiMonitorArbiter::snapshot_acquire()
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
+    auto frame = current_frame();
 
-    if (!current_buffer)
-    {
-        if (schedule->num_scheduled() > 0)
-        {
-            current_buffer = schedule->next_buffer();
-            clear_current_users();
-        }
-        else
-        {
-            BOOST_THROW_EXCEPTION(std::logic_error("no buffer to give to snapshotter"));
-        }
-    }
+    if (!frame)
+        frame = advance_from(frame);
+
+    if (!frame)
+        BOOST_THROW_EXCEPTION(std::logic_error("no buffer to give to snapshotter"));
 
-    return current_buffer;
+    return frame->buffer;
 }
 
 void mc::MultiMonitorArbiter::set_schedule(std::shared_ptr<Schedule> const& new_schedule)
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
-    schedule = new_schedule;
+    std::lock_guard<decltype(advance_mutex)> lk(advance_mutex);
+    std::atomic_store(&schedule, new_schedule);
+}
+
+void mc::MultiMonitorArbiter::transition_schedule(std::shared_ptr<Schedule> const& new_schedule)
+{
+    // Draining under advance_mutex keeps compositors from taking a buffer
+    // between our seeing it scheduled and taking it ourselves
+    std::lock_guard<decltype(advance_mutex)> lk(advance_mutex);
+    while (schedule->num_scheduled() > 0)
+        new_schedule->schedule(schedule->next_buffer());
+    std::atomic_store(&schedule, new_schedule);
 }
 
 bool mc::MultiMonitorArbiter::buffer_ready_for(mc::CompositorID id)
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
     // If there are scheduled buffers then there is one ready for any compositor
-    if (schedule->num_scheduled() > 0)
+    if (std::atomic_load(&schedule)->num_scheduled() > 0)
         return true;
+
     // If we have a current buffer that the compositor isn't yet using, it is ready
-    else if (current_buffer && !is_user_of_current_buffer(id))
-        return true;
-    // There are no scheduled buffers and either no current buffer, or a current buffer already used by this compositor
-    else
-        return false;
+    auto const frame = current_frame();
+    return frame && !(frame->users & user_bit_for(id));
 }
 
 void mc::MultiMonitorArbiter::advance_schedule()
 {
-    std::lock_guard<decltype(mutex)> lk(mutex);
+    std::lock_guard<decltype(advance_mutex)> lk(advance_mutex);
     if (schedule->num_scheduled() > 0)
-    {
-        current_buffer = schedule->next_buffer();
-        clear_current_users();
-    } 
+        std::atomic_store(&current, std::make_shared<Frame const>(schedule->next_buffer()));
 }
 
-void mc::MultiMonitorArbiter::add_current_buffer_user(mc::CompositorID id)
+void mc::MultiMonitorArbiter::advance_to_latest()
 {
-    // First try and find an empty slot in our vector…
-    for (auto& slot : current_buffer_users)
+    // Released (to their clients) once we're no longer holding advance_mutex
+    std::vector<std::shared_ptr<mg::Buffer>> dropped;
+
+    std::lock_guard<decltype(advance_mutex)> lk(advance_mutex);
+    while (schedule->num_scheduled() > 0)
+        dropped.push_back(schedule->next_buffer());
+
+    if (!dropped.empty())
     {
-        if (!slot)
-        {
-            slot = id;
-            return;
-        }
+        std::atomic_store(&current, std::make_shared<Frame const>(dropped.back()));
+        dropped.pop_back();
     }
-    //…no empty slot, so we'll need to grow the vector.
-    current_buffer_users.push_back({id});
 }
 
-bool mc::MultiMonitorArbiter::is_user_of_current_buffer(mir::compositor::CompositorID id)
+std::shared_ptr<mc::MultiMonitorArbiter::Frame const> mc::MultiMonitorArbiter::current_frame() const
 {
-    return std::any_of(
-        current_buffer_users.begin(),
-        current_buffer_users.end(),
-        [id](auto const& slot)
-        {
-            if (slot)
-            {
-                return *slot == id;
-            }
-            return false;
-        });
+    return std::atomic_load(&current);
 }
 
-void mc::MultiMonitorArbiter::clear_current_users()
+std::shared_ptr<mc::MultiMonitorArbiter::Frame const> mc::MultiMonitorArbiter::advance_from(
+    std::shared_ptr<Frame const> const& frame)
 {
-    for (auto& slot : current_buffer_users)
+    std::lock_guard<decltype(advance_mutex)> lk(advance_mutex);
+
+    // Another compositor may have got here first, in which case it's their buffer we want
+    auto const latest = current_frame();
+    if (latest != frame || schedule->num_scheduled() == 0)
+        return latest;
+
+    auto const next = std::make_shared<Frame const>(schedule->next_buffer());
+    std::atomic_store(&current, next);
+    return next;
+}
+
+mc::MultiMonitorArbiter::UserMask mc::MultiMonitorArbiter::user_bit_for(mc::CompositorID id)
+{
+    // Slots are only ever claimed, so each compositor's stays put (barring eviction below)
+    for (size_t i = 0; i != users.size(); ++i)
     {
-        slot = {};
+        auto user = users[i].load();
+        if (!user && (users[i].compare_exchange_strong(user, id) || user == id))
+            return UserMask{1} << i;
+        if (user == id)
+            return UserMask{1} << i;
     }
+
+    /*
+     * All taken, presumably mostly by compositors that have since gone
+     * (display configuration changes replace them). Should one still be
+     * around it loses track of which buffer it used, so may miss a frame.
+     */
+    auto const evicted = next_evicted_user++ % users.size();
+    users[evicted] = id;
+    return UserMask{1} << evicted;
 }
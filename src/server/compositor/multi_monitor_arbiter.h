@@ -21,10 +21,11 @@
 #include "mir/compositor/compositor_id.h"
 #include "mir/graphics/buffer_id.h"
 #include "buffer_acquisition.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
-#include <vector>
-#include <experimental/optional>
 
 namespace mir
 {
@@ -34,6 +35,13 @@ namespace compositor
 {
 class Schedule;
 
+/**
+ * Hands the buffers of a schedule out to the compositors showing them.
+ *
+ * Compositors find the current buffer, and whether they've already used it,
+ * without locking. Only taking the next buffer from the schedule, which
+ * happens once per buffer, is serialised.
+ */
 class MultiMonitorArbiter : public BufferAcquisition 
 {
 public:
@@ -44,18 +52,37 @@ public:
     std::shared_ptr<graphics::Buffer> compositor_acquire(compositor::CompositorID id) override;
     std::shared_ptr<graphics::Buffer> snapshot_acquire() override;
     void set_schedule(std::shared_ptr<Schedule> const& schedule);
+    /// Moves the buffers still scheduled onto \a new_schedule, then uses that
+    void transition_schedule(std::shared_ptr<Schedule> const& new_schedule);
     bool buffer_ready_for(compositor::CompositorID id);
     void advance_schedule();
+    /// Makes the most recently scheduled buffer current, dropping any older
+    void advance_to_latest();
 
 private:
-    void add_current_buffer_user(compositor::CompositorID id);
-    bool is_user_of_current_buffer(compositor::CompositorID id);
-    void clear_current_users();
+    typedef uint64_t UserMask;
+
+    /// The current buffer, and which compositors have used it
+    struct Frame
+    {
+        Frame(std::shared_ptr<graphics::Buffer> const& buffer) : buffer{buffer} {}
+
+        std::shared_ptr<graphics::Buffer> const buffer;
+        std::atomic<UserMask> mutable users{0};
+    };
 
-    std::mutex mutable mutex;
-    std::shared_ptr<graphics::Buffer> current_buffer;
-    std::vector<std::experimental::optional<compositor::CompositorID>> current_buffer_users;
+    UserMask user_bit_for(compositor::CompositorID id);
+    std::shared_ptr<Frame const> current_frame() const;
+    std::shared_ptr<Frame const> advance_from(std::shared_ptr<Frame const> const& frame);
+
+    // Accessed only through std::atomic_load()/atomic_store()
+    std::shared_ptr<Frame const> current;
     std::shared_ptr<Schedule> schedule;
+
+    std::mutex advance_mutex;
+
+    std::array<std::atomic<compositor::CompositorID>, 8 * sizeof(UserMask)> users;
+    std::atomic<unsigned> next_evicted_user{0};
 };
 
 }
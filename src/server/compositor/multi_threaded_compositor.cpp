@@ -17,6 +17,7 @@
  */
 
 #include "multi_threaded_compositor.h"
+#include "frame_scheduler.h"
 #include "mir/graphics/display.h"
 #include "mir/graphics/display_buffer.h"
 #include "mir/compositor/display_buffer_compositor.h"
@@ -43,6 +44,12 @@ namespace mc = mir::compositor;
 namespace mg = mir::graphics;
 namespace ms = mir::scene;
 
+namespace
+{
+// Slack between compositing finishing and the vblank it is meant for
+auto const vblank_margin = 2ms;
+}
+
 namespace mir
 {
 namespace compositor
@@ -66,7 +73,8 @@ public:
         force_sleep{fixed_composite_delay},
         display_listener{display_listener},
         report{report},
-        started_future{started.get_future()}
+        started_future{started.get_future()},
+        scheduler{vblank_margin}
     {
     }
 
@@ -118,6 +126,29 @@ public:
                 /* Wait until compositing has been scheduled or we are stopped */
                 run_cv.wait(lock, [&]{ return (frames_scheduled > 0) || !running; });
 
+                /*
+                 * Once we know when the outputs refresh, start compositing
+                 * just in time for the next vblank we can make. Finishing any
+                 * earlier only means showing staler client content.
+                 */
+                auto const now = std::chrono::steady_clock::now();
+                if (running && force_sleep < std::chrono::milliseconds::zero() &&
+                    scheduler.has_prediction(now))
+                {
+                    auto const vblank = scheduler.target_vblank(now);
+
+                    for (auto const& compositor : compositors)
+                    {
+                        report->predicted_frame(
+                            std::get<1>(compositor).get(),
+                            vblank,
+                            scheduler.refresh_interval(),
+                            scheduler.render_time());
+                    }
+
+                    run_cv.wait_until(lock, vblank - scheduler.lead_time(), [this]{ return !running; });
+                }
+
                 /*
                  * Check if we are running before compositing, since we may have
                  * been stopped while waiting for the run_cv above.
@@ -135,12 +166,17 @@ public:
                     not_posted_yet = false;
                     lock.unlock();
 
+                    auto const began = std::chrono::steady_clock::now();
                     for (auto& tuple : compositors)
                     {
                         auto& compositor = std::get<1>(tuple);
                         compositor->composite(scene->scene_elements_for(compositor.get()));
                     }
+
+                    auto const posting = std::chrono::steady_clock::now();
                     group.post();
+                    auto const posted = std::chrono::steady_clock::now();
+                    scheduler.frame_posted(began, posting, posted);
 
                     /*
                      * "Predictive bypass" optimization: If the last frame was
@@ -148,10 +184,14 @@ public:
                      * beneficial to sleep for most of the next frame. This reduces
                      * the latency between snapshotting the scene and post()
                      * completing by almost a whole frame.
+                     *
+                     * The scheduler does this more precisely when it can, just
+                     * before compositing the next frame.
                      */
-                    auto delay = force_sleep >= std::chrono::milliseconds::zero() ?
-                                 force_sleep : group.recommended_sleep();
-                    std::this_thread::sleep_for(delay);
+                    if (force_sleep >= std::chrono::milliseconds::zero())
+                        std::this_thread::sleep_for(force_sleep);
+                    else if (!scheduler.has_prediction(posted))
+                        std::this_thread::sleep_for(group.recommended_sleep());
 
                     lock.lock();
 
@@ -244,6 +284,7 @@ private:
     std::promise<void> started;
     std::future<void> started_future;
     bool not_posted_yet = true;
+    FrameScheduler scheduler;
 };
 
 }
@@ -17,11 +17,12 @@
  */
 
 #include "mir/geometry/rectangle.h"
+#include "mir/geometry/region.h"
 #include "mir/compositor/scene_element.h"
 #include "mir/graphics/renderable.h"
 #include "occlusion.h"
 
-#include <vector>
+#include <algorithm>
 
 using namespace mir::geometry;
 using namespace mir::graphics;
@@ -32,7 +33,8 @@ namespace
 bool renderable_is_occluded(
     Renderable const& renderable, 
     Rectangle const& area,
-    std::vector<Rectangle>& coverage)
+    Region& coverage,
+    mir::renderer::Renderer::VisibleRegions* partially_visible)
 {
     static glm::mat4 const identity(1);
     static Rectangle const empty{};
@@ -46,44 +48,60 @@ bool renderable_is_occluded(
     if (clipped_window == empty)
         return true;  // Not in the area; definitely occluded.
 
-    bool occluded = false;
-    for (auto const& r : coverage)
+    if (coverage.contains(clipped_window))
+        return true;
+
+    if (partially_visible && coverage.overlaps(clipped_window))
     {
-        if (r.contains(clipped_window))
-        {
-            occluded = true;
-            break;
-        }
+        Region visible{clipped_window};
+        visible.subtract(coverage);
+        (*partially_visible)[renderable.id()] = std::move(visible);
     }
 
-    if (!occluded && renderable.alpha() == 1.0f && !renderable.shaped())
-        coverage.push_back(clipped_window);
+    if (renderable.alpha() == 1.0f && !renderable.shaped())
+        coverage.add(clipped_window);
 
-    return occluded;
-}
+    return false;
 }
 
-SceneElementSequence mir::compositor::filter_occlusions_from(
+SceneElementSequence filter(
     SceneElementSequence& elements,
-    Rectangle const& area)
+    Rectangle const& area,
+    mir::renderer::Renderer::VisibleRegions* partially_visible)
 {
     SceneElementSequence occluded;
-    std::vector<Rectangle> coverage;
+    SceneElementSequence unoccluded;
+    unoccluded.reserve(elements.size());
+    Region coverage;
 
-    auto it = elements.rbegin();
-    while (it != elements.rend())
+    // Top-down, so both sequences are built back to front
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it)
     {
-        auto const renderable = (*it)->renderable();
-        if (renderable_is_occluded(*renderable, area, coverage))
-        {
-            occluded.insert(occluded.begin(), *it);
-            it = SceneElementSequence::reverse_iterator(elements.erase(std::prev(it.base())));
-        }
+        if (renderable_is_occluded(*(*it)->renderable(), area, coverage, partially_visible))
+            occluded.push_back(*it);
         else
-        {
-            it++;
-        }
+            unoccluded.push_back(*it);
     }
 
+    std::reverse(occluded.begin(), occluded.end());
+    std::reverse(unoccluded.begin(), unoccluded.end());
+    elements.swap(unoccluded);
+
     return occluded;
 }
+}
+
+SceneElementSequence mir::compositor::filter_occlusions_from(
+    SceneElementSequence& elements,
+    Rectangle const& area)
+{
+    return filter(elements, area, nullptr);
+}
+
+SceneElementSequence mir::compositor::filter_occlusions_from(
+    SceneElementSequence& elements,
+    Rectangle const& area,
+    mir::renderer::Renderer::VisibleRegions& partially_visible)
+{
+    return filter(elements, area, &partially_visible);
+}
@@ -20,6 +20,7 @@
 #define MIR_COMPOSITOR_OCCLUSION_H_
 
 #include "mir/compositor/scene.h"
+#include "mir/renderer/renderer.h"
 
 namespace mir
 {
@@ -28,6 +29,15 @@ namespace compositor
 
 SceneElementSequence filter_occlusions_from(SceneElementSequence& list, geometry::Rectangle const& area);
 
+/**
+ * As above, also recording the visible parts of the remaining elements that
+ * are partly hidden by opaque elements above them in \a partially_visible.
+ */
+SceneElementSequence filter_occlusions_from(
+    SceneElementSequence& list,
+    geometry::Rectangle const& area,
+    renderer::Renderer::VisibleRegions& partially_visible);
+
 } // namespace compositor
 } // namespace mir
 
@@ -68,7 +68,6 @@ void mc::Stream::submit_buffer(std::shared_ptr<mg::Buffer> const& buffer)
 
 void mc::Stream::with_most_recent_buffer_do(std::function<void(mg::Buffer&)> const& fn)
 {
-    std::lock_guard<decltype(mutex)> lk(mutex); 
     fn(*arbiter->snapshot_acquire());
 }
 
@@ -119,18 +118,13 @@ bool mc::Stream::framedropping() const
 void mc::Stream::transition_schedule(
     std::shared_ptr<mc::Schedule>&& new_schedule, std::lock_guard<std::mutex> const&)
 {
-    std::vector<std::shared_ptr<mg::Buffer>> transferred_buffers;
-    while(schedule->num_scheduled())
-        transferred_buffers.emplace_back(schedule->next_buffer());
-    for(auto& buffer : transferred_buffers)
-        new_schedule->schedule(buffer);
+    // The arbiter drains the old schedule, as compositors may be taking from it
+    arbiter->transition_schedule(new_schedule);
     schedule = new_schedule;
-    arbiter->set_schedule(schedule);
 }
 
 int mc::Stream::buffers_ready_for_compositor(void const* id) const
 {
-    std::lock_guard<decltype(mutex)> lk(mutex); 
     if (arbiter->buffer_ready_for(id))
         return 1;
     return 0;
@@ -139,17 +133,7 @@ int mc::Stream::buffers_ready_for_compositor(void const* id) const
 void mc::Stream::drop_old_buffers()
 {
     std::lock_guard<decltype(mutex)> lk(mutex); 
-    std::vector<std::shared_ptr<mg::Buffer>> transferred_buffers;
-    while(schedule->num_scheduled())
-        transferred_buffers.emplace_back(schedule->next_buffer());
-
-    if (!transferred_buffers.empty())
-    {
-        schedule->schedule(transferred_buffers.back());
-        transferred_buffers.pop_back();
-    }
-
-    arbiter->advance_schedule();
+    arbiter->advance_to_latest();
 }
 
 bool mc::Stream::has_submitted_buffer() const
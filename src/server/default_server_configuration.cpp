@@ -42,10 +42,12 @@
 #include "mir/default_configuration.h"
 #include "mir/scene/null_prompt_session_listener.h"
 #include "default_emergency_cleanup.h"
+#include "report/logging/async_logger.h"
 #include "mir/graphics/platform.h"
 #include "mir/scene/coordinate_translator.h"
 #include "mir/console_services.h"
 
+#include <algorithm>
 #include <type_traits>
 
 namespace mc = mir::compositor;
@@ -226,9 +228,17 @@ auto mir::DefaultServerConfiguration::the_logger()
     -> std::shared_ptr<ml::Logger>
 {
     return logger(
-        []() -> std::shared_ptr<ml::Logger>
+        [this]() -> std::shared_ptr<ml::Logger>
         {
-            return std::make_shared<ml::DumbConsoleLogger>();
+            auto const console = std::make_shared<ml::DumbConsoleLogger>();
+
+            if (the_options()->is_set(options::async_logging_opt))
+            {
+                return std::make_shared<mir::report::logging::AsyncLogger>(
+                    console, std::max(the_options()->get<int>(options::log_rate_limit_opt), 0));
+            }
+
+            return console;
         });
 }
 
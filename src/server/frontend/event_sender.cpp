@@ -18,6 +18,7 @@
 
 #include "event_sender.h"
 #include "mir/events/event.h"
+#include "mir/events/pointer_event.h"
 #include "mir/frontend/client_constants.h"
 #include "mir/graphics/display_configuration.h"
 #include "mir/variable_length_array.h"
@@ -42,6 +43,35 @@ namespace mev = mir::events;
 namespace mp = mir::protobuf;
 namespace mi = mir::input;
 
+namespace
+{
+bool is_pointer_motion(MirEvent const& event)
+{
+    return event.type() == mir_event_type_input &&
+           event.to_input()->input_type() == mir_input_event_type_pointer &&
+           event.to_input()->to_pointer()->action() == mir_pointer_action_motion;
+}
+
+std::string wire_message_for(MirEvent const& event)
+{
+    mp::EventSequence seq;
+    seq.add_event()->set_raw(MirEvent::serialize(&event));
+
+    mir::protobuf::wire::Result result;
+    result.add_events(seq.SerializeAsString());
+    return result.SerializeAsString();
+}
+
+mir::EventUPtr event_in(std::string const& wire_message)
+{
+    mir::protobuf::wire::Result result;
+    mp::EventSequence seq;
+    result.ParseFromString(wire_message);
+    seq.ParseFromString(result.events(0));
+    return MirEvent::deserialize(seq.event(0).raw());
+}
+}
+
 mfd::EventSender::EventSender(
     std::shared_ptr<MessageSender> const& socket_sender,
     std::shared_ptr<mg::PlatformIpcOperations> const& buffer_packer) :
@@ -52,6 +82,12 @@ mfd::EventSender::EventSender(
 
 void mfd::EventSender::handle_event(EventUPtr&& event)
 {
+    if (is_pointer_motion(*event))
+    {
+        send_pointer_motion(std::move(event));
+        return;
+    }
+
     // In future we might send multiple events, or insert them into messages
     // containing other responses, but for now we send them individually.
     mp::EventSequence seq;
@@ -61,6 +97,40 @@ void mfd::EventSender::handle_event(EventUPtr&& event)
     send_event_sequence(seq, {});
 }
 
+void mfd::EventSender::send_pointer_motion(EventUPtr&& event)
+{
+    // A client that's falling behind only needs to know where the pointer
+    // ended up and how far it went getting there.
+    std::shared_ptr<MirEvent> const motion{std::move(event)};
+    auto const window = static_cast<uint32_t>(motion->to_input()->window_id());
+    auto const device = static_cast<uint32_t>(motion->to_input()->device_id());
+    auto const key = (static_cast<uint64_t>(window) + 1) << 32 | device;
+
+    try
+    {
+        sender->send_mergeable(
+            wire_message_for(*motion),
+            key,
+            [motion](std::string const& earlier)
+            {
+                auto const earlier_motion = event_in(earlier);
+                auto const from = earlier_motion->to_input()->to_pointer();
+                auto const to = motion->to_input()->to_pointer();
+
+                to->set_dx(from->dx() + to->dx());
+                to->set_dy(from->dy() + to->dy());
+                to->set_vscroll(from->vscroll() + to->vscroll());
+                to->set_hscroll(from->hscroll() + to->hscroll());
+                return wire_message_for(*motion);
+            });
+    }
+    catch (std::exception const& error)
+    {
+        // TODO: We should report this state.
+        (void) error;
+    }
+}
+
 void mfd::EventSender::handle_display_config_change(
     graphics::DisplayConfiguration const& display_config)
 {
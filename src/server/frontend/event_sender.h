@@ -56,6 +56,7 @@ public:
 
 private:
     void send_event_sequence(protobuf::EventSequence&, FdSets const&);
+    void send_pointer_motion(EventUPtr&& event);
     void send_buffer(protobuf::EventSequence&, graphics::Buffer&, graphics::BufferIpcMsgType);
 
     std::shared_ptr<MessageSender> const sender;
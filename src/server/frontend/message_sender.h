@@ -22,6 +22,10 @@
 
 #include <sys/types.h>
 
+#include <cstdint>
+#include <functional>
+#include <string>
+
 namespace mir
 {
 namespace frontend
@@ -31,6 +35,21 @@ class MessageSender
 public:
     virtual void send(char const* data, size_t length, FdSets const& fds) = 0;
 
+    /// Given an earlier message that hasn't gone out yet, returns the message to send in place of both
+    using Merge = std::function<std::string(std::string const& earlier)>;
+
+    /**
+     * Sends a message that the client only needs the gist of when it is
+     * falling behind: if the last message still waiting to go out was sent
+     * with the same \a key, \a merge replaces both of them.
+     *
+     * By default this just sends the message.
+     */
+    virtual void send_mergeable(std::string const& message, uint64_t /*key*/, Merge const& /*merge*/)
+    {
+        send(message.data(), message.size(), {});
+    }
+
 protected:
     MessageSender() = default;
     virtual ~MessageSender() = default;
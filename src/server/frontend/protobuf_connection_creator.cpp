@@ -81,7 +81,7 @@ void mf::ProtobufConnectionCreator::create_connection_for(
     std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket,
     ConnectionContext const& connection_context)
 {
-    auto const messenger = std::make_shared<detail::SocketMessenger>(socket);
+    auto const messenger = std::make_shared<detail::SocketMessenger>(socket, report);
     auto const creds = messenger->client_creds();
 
     if (session_authorizer->connection_is_allowed(creds))
@@ -43,6 +43,20 @@ void mf::ReorderingMessageSender::send(
     sink->send(data, length, fds);
 }
 
+void mf::ReorderingMessageSender::send_mergeable(std::string const& message, uint64_t key, Merge const& merge)
+{
+    {
+        std::lock_guard<decltype(message_lock)> lock{message_lock};
+        if (corked)
+        {
+            buffered_messages.emplace_back(Message {std::vector<char>(message.begin(), message.end()), FdSets{}});
+            return;
+        }
+    }
+
+    sink->send_mergeable(message, key, merge);
+}
+
 void mf::ReorderingMessageSender::uncork()
 {
     {
@@ -38,6 +38,7 @@ public:
     explicit ReorderingMessageSender(std::shared_ptr<MessageSender> const& sink);
 
     void send(char const* data, size_t length, FdSets const& fds) override;
+    void send_mergeable(std::string const& message, uint64_t key, Merge const& merge) override;
 
     /**
      * Stop diverting messages into the buffer.
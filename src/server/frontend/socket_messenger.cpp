@@ -17,7 +17,7 @@
  */
 
 #include "socket_messenger.h"
-#include "mir/frontend/client_constants.h"
+#include "mir/frontend/message_processor_report.h"
 #include "mir/variable_length_array.h"
 #include "mir/fd_socket_transmission.h"
 #include "mir/raii.h"
@@ -26,23 +26,74 @@
 
 #include <errno.h>
 #include <string.h>
+#include <sys/socket.h>
 
 #include <stdexcept>
+#include <system_error>
 
 namespace mf = mir::frontend;
 namespace mfd = mf::detail;
 namespace bs = boost::system;
 namespace ba = boost::asio;
 
-mfd::SocketMessenger::SocketMessenger(std::shared_ptr<ba::local::stream_protocol::socket> const& socket)
+namespace
+{
+size_t const header_size{2};
+
+// Enough to coalesce a burst of events without building a huge iovec array
+size_t const max_messages_per_write{32};
+
+void set_header(char (&header)[header_size], size_t length)
+{
+    header[0] = static_cast<char>((length >> 8) & 0xff);
+    header[1] = static_cast<char>((length >> 0) & 0xff);
+}
+
+// As mir::send_fds(), but leaves it to the caller to handle EAGAIN
+ssize_t send_fd_set(int socket, std::vector<mir::Fd> const& fds)
+{
+    char dummy_iov_data = 'M';
+    iovec iov{&dummy_iov_data, 1};
+
+    static auto const builtin_n_fds = 5;
+    static auto const builtin_cmsg_space = CMSG_SPACE(builtin_n_fds * sizeof(int));
+    auto const fds_bytes = fds.size() * sizeof(int);
+    mir::VariableLengthArray<builtin_cmsg_space> control{CMSG_SPACE(fds_bytes)};
+    memset(control.data(), 0, control.size());
+
+    msghdr header{};
+    header.msg_iov = &iov;
+    header.msg_iovlen = 1;
+    header.msg_control = control.data();
+    header.msg_controllen = control.size();
+
+    auto const message = CMSG_FIRSTHDR(&header);
+    message->cmsg_len = CMSG_LEN(fds_bytes);
+    message->cmsg_level = SOL_SOCKET;
+    message->cmsg_type = SCM_RIGHTS;
+
+    auto data = reinterpret_cast<int*>(CMSG_DATA(message));
+    for (auto const& fd : fds)
+        *data++ = fd;
+
+    return sendmsg(socket, &header, MSG_NOSIGNAL | MSG_DONTWAIT);
+}
+}
+
+mfd::SocketMessenger::SocketMessenger(
+    std::shared_ptr<ba::local::stream_protocol::socket> const& socket,
+    std::shared_ptr<MessageProcessorReport> const& report,
+    size_t max_queued_bytes)
     : socket(socket),
-      socket_fd{IntOwnedFd{socket->native_handle()}}
+      report(report),
+      socket_fd{IntOwnedFd{socket->native_handle()}},
+      max_queued_bytes{max_queued_bytes}
 {
     // Make the socket non-blocking to avoid hanging the server when a client
-    // is unresponsive. Also increase the send buffer size to 64KiB to allow
-    // more leeway for transient client freezes.
+    // is unresponsive; messages queue up until the client catches up. Also
+    // increase the send buffer size to 64KiB to allow more leeway for
+    // transient client freezes.
     // See https://bugs.launchpad.net/mir/+bug/1350207
-    // TODO: Rework the messenger to support asynchronous sends
     socket->non_blocking(true);
     boost::asio::socket_base::send_buffer_size option(64*1024);
     socket->set_option(option);
@@ -71,26 +122,222 @@ mf::SessionCredentials mfd::SocketMessenger::client_creds()
     return creator_creds();
 }
 
-void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& fd_set)
+void mfd::SocketMessenger::send(char const* data, size_t length, FdSets const& fds)
+{
+    std::string payload{data, length};
+
+    // NOTE: messages go out in the order they are sent, which we rely on
+    // as per the comment in mf::SessionMediator::release_surface
+    std::unique_lock<std::mutex> lock{message_lock};
+    enqueue(lock, std::move(payload), fds, 0, nullptr);
+}
+
+void mfd::SocketMessenger::send_mergeable(std::string const& message, uint64_t key, Merge const& merge)
+{
+    std::unique_lock<std::mutex> lock{message_lock};
+    enqueue(lock, std::string{message}, {}, key, merge);
+}
+
+size_t mfd::SocketMessenger::queue_depth() const
+{
+    std::lock_guard<std::mutex> lock{message_lock};
+    return queue.size();
+}
+
+void mfd::SocketMessenger::enqueue(
+    std::unique_lock<std::mutex>& lock,
+    std::string&& payload,
+    FdSets const& fds,
+    uint64_t key,
+    Merge const& merge)
+{
+    // Only a message nobody has started writing can be merged into
+    auto const mergeable = [&]
+        {
+            auto const last = queue.size() - 1;
+            return last >= in_flight && !(last == 0 && front_bytes_sent) && queue.back().key == key;
+        };
+
+    if (key && !queue.empty() && mergeable())
+    {
+        auto& message = queue.back();
+        auto merged = merge(message.payload);
+        queued_bytes += merged.size() - message.payload.size();
+        message.payload = std::move(merged);
+        set_header(message.header, message.payload.size());
+        return;
+    }
+
+    if (queued_bytes + payload.size() > max_queued_bytes)
+        BOOST_THROW_EXCEPTION(std::runtime_error("Client is not reading its messages"));
+
+    queued_bytes += payload.size();
+    queue.push_back(Message{{}, std::move(payload), fds, key});
+    set_header(queue.back().header, queue.back().payload.size());
+
+    flush(lock);
+}
+
+void mfd::SocketMessenger::flush(std::unique_lock<std::mutex>& lock)
 {
-    static size_t const header_size{2};
-    mir::VariableLengthArray<mf::serialization_buffer_size> whole_message{header_size + length};
+    // Whoever is already flushing picks up what we've queued
+    if (flushing || waiting_for_socket)
+        return;
+
+    flushing = true;
+    try
+    {
+        while (!queue.empty() && write_queued(lock))
+            ;
+    }
+    catch (...)
+    {
+        // The client is gone, so nothing more will go out
+        queue.clear();
+        queued_bytes = front_bytes_sent = front_fd_sets_sent = in_flight = 0;
+        flushing = false;
+        throw;
+    }
+    flushing = false;
+}
+
+bool mfd::SocketMessenger::write_queued(std::unique_lock<std::mutex>& lock)
+{
+    auto& front = queue.front();
+    auto const front_size = header_size + front.payload.size();
+    ssize_t result;
+
+    if (front_bytes_sent == front_size)
+    {
+        // The client reads the fds that go with a message after the message
+        auto const& fds = front.fds[front_fd_sets_sent];
+        in_flight = 1;
+        lock.unlock();
+        result = send_fd_set(socket_fd, fds);
+        lock.lock();
+        in_flight = 0;
+
+        if (result >= 0 && ++front_fd_sets_sent == front.fds.size())
+        {
+            queued_bytes -= front.payload.size();
+            front_bytes_sent = front_fd_sets_sent = 0;
+            queue.pop_front();
+        }
+    }
+    else
+    {
+        // Gather everything up to (and including) the next message with fds
+        // into a single write. Messages queued meanwhile are only ever
+        // appended, so the ones being written stay put while we're unlocked.
+        iovec iov[2*max_messages_per_write];
+        size_t iov_count = 0;
+
+        for (auto& message : queue)
+        {
+            if (in_flight == max_messages_per_write)
+                break;
+
+            ++in_flight;
+            iov[iov_count++] = {message.header, header_size};
+            iov[iov_count++] = {&message.payload[0], message.payload.size()};
+
+            if (!message.fds.empty())
+                break;
+        }
+
+        // Skip what an earlier, partial, write of the front message got out
+        auto skip = front_bytes_sent;
+        auto first = iov;
+        while (skip >= first->iov_len)
+            skip -= (first++)->iov_len;
+        first->iov_base = static_cast<char*>(first->iov_base) + skip;
+        first->iov_len -= skip;
+
+        msghdr header{};
+        header.msg_iov = first;
+        header.msg_iovlen = iov_count - (first - iov);
+
+        lock.unlock();
+        result = sendmsg(socket_fd, &header, MSG_NOSIGNAL | MSG_DONTWAIT);
+        lock.lock();
+        in_flight = 0;
+
+        for (auto written = result; written > 0;)
+        {
+            auto& message = queue.front();
+            auto const remaining = header_size + message.payload.size() - front_bytes_sent;
+
+            if (static_cast<size_t>(written) < remaining)
+            {
+                front_bytes_sent += written;
+                break;
+            }
+
+            written -= remaining;
+            if (!message.fds.empty())
+            {
+                front_bytes_sent += remaining;
+                break;
+            }
+
+            queued_bytes -= message.payload.size();
+            front_bytes_sent = 0;
+            queue.pop_front();
+        }
+    }
+
+    if (result < 0)
+    {
+        if (errno == EAGAIN || errno == EWOULDBLOCK)
+        {
+            waiting_for_socket = true;
+            report->send_queue_depth(this, queue.size());
+            flush_when_writable();
+            return false;
+        }
+
+        if (!mir::socket_error_is_transient(errno))
+            BOOST_THROW_EXCEPTION(std::system_error(errno, std::system_category(), "Failed to send message to client"));
+    }
+
+    return true;
+}
+
+void mfd::SocketMessenger::flush_when_writable()
+{
+    std::weak_ptr<SocketMessenger> const weak_self = shared_from_this();
+
+    socket->async_write_some(
+        ba::null_buffers(),
+        [weak_self](bs::error_code const& error, size_t)
+        {
+            auto const self = weak_self.lock();
+            if (!self)
+                return;
 
-    whole_message.data()[0] = static_cast<unsigned char>((length >> 8) & 0xff);
-    whole_message.data()[1] = static_cast<unsigned char>((length >> 0) & 0xff);
-    std::copy(data, data + length, whole_message.data() + header_size);
+            std::unique_lock<std::mutex> lock{self->message_lock};
+            self->waiting_for_socket = false;
 
-    std::unique_lock<std::mutex> lg(message_lock);
+            if (error)
+            {
+                self->queue.clear();
+                self->queued_bytes = self->front_bytes_sent = self->front_fd_sets_sent = 0;
+                return;
+            }
 
-    // TODO: This should be asynchronous, but we are not making sure
-    // that a potential call to send_fds is executed _after_ this
-    // function has completed (if it would be executed asynchronously.
-    // NOTE: we rely on this synchronous behavior as per the comment in
-    // mf::SessionMediator::create_surface
-    ba::write(*socket, ba::buffer(whole_message.data(), whole_message.size()));
+            try
+            {
+                self->flush(lock);
+            }
+            catch (std::exception const&)
+            {
+                // The connection notices the client is gone when it next reads
+                return;
+            }
 
-    for (auto const& fds : fd_set)
-        mir::send_fds(socket_fd, fds);
+            if (!self->waiting_for_socket)
+                self->report->send_queue_depth(self.get(), self->queue.size());
+        });
 }
 
 void mfd::SocketMessenger::async_receive_msg(
@@ -21,21 +21,46 @@
 #include "message_sender.h"
 #include "message_receiver.h"
 #include "mir/frontend/session_credentials.h"
+
+#include <deque>
+#include <memory>
 #include <mutex>
 
 namespace mir
 {
 namespace frontend
 {
+class MessageProcessorReport;
+
 namespace detail
 {
+/**
+ * Sends messages to a client through a per-connection queue, without ever
+ * blocking on the socket.
+ *
+ * Whatever has been queued by the time the socket can take it is written
+ * with a single sendmsg(). While the client is not reading, messages wait
+ * (up to max_queued_bytes of them) for the socket to drain, and mergeable
+ * ones are merged. The queue depth is reported each time the client stops
+ * reading, and again once it has caught up.
+ */
 class SocketMessenger : public MessageSender,
-                        public MessageReceiver
+                        public MessageReceiver,
+                        public std::enable_shared_from_this<SocketMessenger>
 {
 public:
-    SocketMessenger(std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket);
+    static size_t const default_max_queued_bytes = 4*1024*1024;
+
+    SocketMessenger(
+        std::shared_ptr<boost::asio::local::stream_protocol::socket> const& socket,
+        std::shared_ptr<MessageProcessorReport> const& report,
+        size_t max_queued_bytes = default_max_queued_bytes);
 
     void send(char const* data, size_t length, FdSets const& fds) override;
+    void send_mergeable(std::string const& message, uint64_t key, Merge const& merge) override;
+
+    /// The number of messages waiting to be written to the socket
+    size_t queue_depth() const;
 
     void async_receive_msg(MirReadHandler const& handler, boost::asio::mutable_buffers_1 const& buffer) override;
     boost::system::error_code receive_msg(boost::asio::mutable_buffers_1 const& buffer) override;
@@ -48,10 +73,32 @@ private:
     void update_session_creds();
     SessionCredentials creator_creds() const;
 
+    struct Message
+    {
+        char header[2];
+        std::string payload;
+        FdSets fds;
+        uint64_t key;   // 0 if not mergeable
+    };
+
+    void enqueue(std::unique_lock<std::mutex>& lock, std::string&& payload, FdSets const& fds, uint64_t key, Merge const& merge);
+    void flush(std::unique_lock<std::mutex>& lock);
+    bool write_queued(std::unique_lock<std::mutex>& lock);
+    void flush_when_writable();
+
     std::shared_ptr<boost::asio::local::stream_protocol::socket> socket;
+    std::shared_ptr<MessageProcessorReport> const report;
     mir::Fd socket_fd;
+    size_t const max_queued_bytes;
 
-    std::mutex message_lock;
+    std::mutex mutable message_lock;
+    std::deque<Message> queue;
+    size_t queued_bytes{0};
+    size_t front_bytes_sent{0};     // Of queue.front(), header included
+    size_t front_fd_sets_sent{0};
+    size_t in_flight{0};            // Messages at the front being written without the lock held
+    bool flushing{false};
+    bool waiting_for_socket{false};
     SessionCredentials session_creds{0, 0, 0};
 };
 }
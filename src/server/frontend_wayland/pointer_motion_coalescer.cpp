@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "pointer_motion_coalescer.h"
+
+#include <set>
+#include <sstream>
+
+namespace mf = mir::frontend;
+namespace geom = mir::geometry;
+
+mf::PointerMotionCoalescer::PointerMotionCoalescer(
+    bool enabled,
+    std::function<bool()> awaiting_frame,
+    std::function<void(std::function<void()>&& action)> on_next_frame,
+    SendMotion send_motion)
+    : enabled{enabled},
+      awaiting_frame{std::move(awaiting_frame)},
+      on_next_frame{std::move(on_next_frame)},
+      send_motion{std::move(send_motion)}
+{
+}
+
+void mf::PointerMotionCoalescer::before(MirInputEvent const* event)
+{
+    if (!pending)
+        return;
+
+    if (mir_input_event_get_type(event) == mir_input_event_type_pointer)
+    {
+        auto const pointer_event = mir_input_event_get_pointer_event(event);
+        if (mir_pointer_event_action(pointer_event) == mir_pointer_action_motion &&
+            mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_hscroll) == 0 &&
+            mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_vscroll) == 0)
+        {
+            return;
+        }
+    }
+
+    flush();
+}
+
+bool mf::PointerMotionCoalescer::hold(std::chrono::milliseconds ms, geom::Point position)
+{
+    if (!enabled || !awaiting_frame())
+    {
+        flush();
+        return false;
+    }
+
+    pending = PendingMotion{ms, position};
+
+    if (!flush_scheduled)
+    {
+        flush_scheduled = true;
+        on_next_frame([this]()
+            {
+                flush_scheduled = false;
+                flush();
+            });
+    }
+
+    return true;
+}
+
+void mf::PointerMotionCoalescer::flush()
+{
+    if (!pending)
+        return;
+
+    auto const motion = pending.value();
+    pending = std::experimental::nullopt;
+
+    send_motion(motion.ms, motion.position);
+}
+
+auto mf::coalesce_pointer_motion_for(std::string const& clients) -> std::function<bool(std::string const& executable)>
+{
+    if (clients.empty())
+        return [](std::string const&) { return false; };
+
+    if (clients == "all")
+        return [](std::string const&) { return true; };
+
+    std::set<std::string> names;
+    std::istringstream list{clients};
+    for (std::string name; std::getline(list, name, ',');)
+    {
+        if (!name.empty())
+            names.insert(name);
+    }
+
+    return [names](std::string const& executable)
+        {
+            return names.find(executable) != names.end();
+        };
+}
@@ -0,0 +1,85 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
+#define MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
+
+#include "mir/geometry/point.h"
+#include "mir_toolkit/events/event.h"
+
+#include <chrono>
+#include <experimental/optional>
+#include <functional>
+#include <string>
+
+namespace mir
+{
+namespace frontend
+{
+/**
+ * Holds back pointer motion for a client that is drawing a frame, so it
+ * gets only the latest position just before it starts on the next one.
+ */
+class PointerMotionCoalescer
+{
+public:
+    typedef std::function<void(std::chrono::milliseconds ms, geometry::Point position)> SendMotion;
+
+    /// \param enabled          whether motion is ever held back for this client
+    /// \param awaiting_frame   whether the client is waiting for a frame callback
+    /// \param on_next_frame    runs its argument just before the next frame callbacks are sent
+    /// \param send_motion      sends motion (and a frame) to the client
+    PointerMotionCoalescer(
+        bool enabled,
+        std::function<bool()> awaiting_frame,
+        std::function<void(std::function<void()>&& action)> on_next_frame,
+        SendMotion send_motion);
+
+    /// Sends any pending motion, unless event is more motion without scrolling.
+    /// Call before handling each input event, so the client gets them in order.
+    void before(MirInputEvent const* event);
+
+    /// Holds back motion to position while the client is drawing a frame
+    /// \returns false if the motion isn't held back and should be sent now
+    bool hold(std::chrono::milliseconds ms, geometry::Point position);
+
+    /// Sends any pending motion
+    void flush();
+
+private:
+    struct PendingMotion
+    {
+        std::chrono::milliseconds ms;
+        geometry::Point position;
+    };
+
+    bool const enabled;
+    std::function<bool()> const awaiting_frame;
+    std::function<void(std::function<void()>&& action)> const on_next_frame;
+    SendMotion const send_motion;
+
+    std::experimental::optional<PendingMotion> pending;
+    bool flush_scheduled{false};
+};
+
+/// Parses the --wayland-coalesce-pointer-motion option: "all", or a
+/// comma-separated list of executable names
+/// \returns whether to coalesce motion for a client running executable
+auto coalesce_pointer_motion_for(std::string const& clients) -> std::function<bool(std::string const& executable)>;
+}
+}
+
+#endif // MIR_FRONTEND_POINTER_MOTION_COALESCER_H_
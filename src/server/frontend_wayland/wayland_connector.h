@@ -99,7 +99,8 @@ public:
         std::shared_ptr<SessionAuthorizer> const& session_authorizer,
         bool arw_socket,
         std::unique_ptr<WaylandExtensions> extensions,
-        WaylandProtocolExtensionFilter const& extension_filter);
+        WaylandProtocolExtensionFilter const& extension_filter,
+        std::function<bool(wl_client*)> const& coalesce_pointer_motion = [](wl_client*) { return false; });
 
     ~WaylandConnector() override;
 
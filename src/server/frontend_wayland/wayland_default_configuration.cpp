@@ -27,12 +27,17 @@
 #include "xwayland_wm_shell.h"
 #include "mir_display.h"
 #include "wl_seat.h"
+#include "pointer_motion_coalescer.h"
 #include "xdg-output-unstable-v1_wrapper.h"
 
 #include "mir/graphics/platform.h"
 #include "mir/options/default_configuration.h"
 #include "mir/scene/session.h"
 
+#include <wayland-server-core.h>
+
+#include <fstream>
+
 namespace mf = mir::frontend;
 namespace ms = mir::scene;
 namespace mo = mir::options;
@@ -131,6 +136,26 @@ auto configure_wayland_extensions(
 
     return std::make_unique<WaylandExtensions>(extensions, x11_enabled, wayland_extension_hooks);
 }
+
+auto coalesce_pointer_motion_for(std::string const& clients) -> std::function<bool(wl_client*)>
+{
+    if (clients.empty())
+        return [](wl_client*) { return false; };
+
+    auto const coalesce_for = mf::coalesce_pointer_motion_for(clients);
+
+    return [coalesce_for](wl_client* client)
+        {
+            pid_t pid;
+            wl_client_get_credentials(client, &pid, nullptr, nullptr);
+
+            std::string executable;
+            std::ifstream comm{"/proc/" + std::to_string(pid) + "/comm"};
+            std::getline(comm, executable);
+
+            return coalesce_for(executable);
+        };
+}
 }
 
 std::shared_ptr<mf::Connector>
@@ -165,7 +190,8 @@ std::shared_ptr<mf::Connector>
                 the_session_authorizer(),
                 arw_socket,
                 configure_wayland_extensions(wayland_extensions, options->is_set(mo::x11_display_opt), wayland_extension_hooks),
-                wayland_extension_filter);
+                wayland_extension_filter,
+                coalesce_pointer_motion_for(options->get<std::string>(mo::wayland_coalesce_pointer_motion_opt)));
         });
 }
 
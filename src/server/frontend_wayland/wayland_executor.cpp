@@ -25,8 +25,8 @@
 
 #include <boost/throw_exception.hpp>
 
+#include <atomic>
 #include <cstring>
-#include <deque>
 #include <functional>
 #include <mutex>
 #include <system_error>
@@ -55,77 +55,184 @@ private:
         TerminationRequested,
         Stopped
     };
+
+    /*
+     * The workqueue is an intrusive multi-producer, single-consumer queue
+     * (after Dmitry Vyukov's): producers only ever exchange the tail and then
+     * link the node they've added, so spawning takes no lock, and the Wayland
+     * thread pops from the head without synchronising with anybody.
+     */
+    struct Node
+    {
+        std::atomic<Node*> next{nullptr};
+        std::function<void()> work;
+    };
+
+    void push(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        auto const previous = tail.exchange(node, std::memory_order_acq_rel);
+        previous->next.store(node, std::memory_order_release);
+    }
+
+    /*
+     * Returns nullptr if the queue is empty *or* if a producer is part way
+     * through a push(); that producer has yet to ask for a wakeup, and will.
+     */
+    Node* pop()
+    {
+        auto first = head;
+        auto next = first->next.load(std::memory_order_acquire);
+
+        if (first == &stub)
+        {
+            if (!next)
+                return nullptr;
+
+            head = first = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next)
+        {
+            head = next;
+            return first;
+        }
+
+        if (first != tail.load(std::memory_order_acquire))
+            return nullptr;
+
+        // first is the last node: put the stub behind it so we can take it
+        push(&stub);
+        next = first->next.load(std::memory_order_acquire);
+        if (next)
+        {
+            head = next;
+            return first;
+        }
+        return nullptr;
+    }
+
 public:
     explicit State(wl_event_loop* loop)
         : loop{loop}
     {
-        enqueue(
+        // This runs along with whatever is first spawned
+        auto const node = new Node;
+        node->work =
             []()
             {
                 on_wayland_thread = true;
-            });
+            };
+        push(node);
     }
 
-    void enqueue(std::function<void()>&& work)
+    ~State()
+    {
+        while (auto const node = pop())
+            delete node;
+    }
+
+    /// Returns whether the Wayland thread needs waking to process the work
+    bool enqueue(std::function<void()>&& work)
     {
         if (on_wayland_thread)
         {
             work();
-            return;
+            return false;
         }
 
-        std::lock_guard<std::mutex> lock{mutex};
-        if (state == ExecutionState::Running)
-        {
-            workqueue.emplace_back(std::move(work));
-        }
         // If we've been terminated then drop the work on the floor, letting the
         // std::function destructor clean up any necessary state.
+        if (state.load() != ExecutionState::Running)
+            return false;
+
+        auto const node = new Node;
+        node->work = std::move(work);
+        push(node);
+
+        // One wakeup covers everything queued until the Wayland thread next
+        // looks at the queue.
+        return !wakeup_pending.exchange(true);
     }
 
     void enqueue_termination(std::function<void()>&& terminator)
     {
         std::lock_guard<std::mutex> lock{mutex};
-        if (state == ExecutionState::Running)
+        if (state.load() == ExecutionState::Running)
         {
-            workqueue.emplace_front(std::move(terminator));
+            this->terminator = std::move(terminator);
             on_wayland_thread = false;
             state = ExecutionState::TerminationRequested;
         }
     }
 
-    std::function<void()> get_work()
+    std::function<void()> take_terminator()
     {
         std::lock_guard<std::mutex> lock{mutex};
-        if (!workqueue.empty())
+        auto taken = std::move(terminator);
+        terminator = nullptr;
+        return taken;
+    }
+
+    /// Runs all the queued work; called on the Wayland thread
+    void process_work()
+    {
+        // Anything spawned from here on needs a new wakeup. (This pairs with
+        // the exchange in enqueue(), so we see everything queued before it.)
+        wakeup_pending.exchange(false);
+
+        for (;;)
         {
-            auto const work = std::move(workqueue.front());
-            workqueue.pop_front();
-            return work;
+            // A termination request (which work may make) goes ahead of any other work
+            std::function<void()> work;
+            if (state.load() == ExecutionState::TerminationRequested)
+                work = take_terminator();
+
+            if (!work)
+            {
+                std::unique_ptr<Node> const node{pop()};
+                if (!node)
+                    break;
+                work = std::move(node->work);
+            }
+
+            try
+            {
+                work();
+            }
+            catch (...)
+            {
+                mir::log(
+                    mir::logging::Severity::critical,
+                    MIR_LOG_COMPONENT,
+                    std::current_exception(),
+                    "Exception processing Wayland event loop work item");
+            }
         }
-        return {};
     }
 
     std::unique_lock<std::mutex> drain()
     {
         std::unique_lock<std::mutex> lock{mutex};
 
-        if (state == ExecutionState::TerminationRequested)
+        if (state.load() == ExecutionState::TerminationRequested)
         {
-            // If we've been asked to terminate then the front of the workqueue
-            // will contain the termination request.
             {
-                std::function<void()> const work = std::move(workqueue.front());
+                std::function<void()> const work = std::move(terminator);
                 lock.unlock();
 
-                work();
+                if (work)
+                    work();
             }
             lock.lock();
         }
 
         on_wayland_thread = false;
         state = ExecutionState::Stopped;
-        workqueue.empty();
+
+        while (auto const node = pop())
+            delete node;
 
         return lock;
     }
@@ -134,9 +241,14 @@ public:
 private:
     static thread_local bool on_wayland_thread;
     std::mutex mutex;
-    ExecutionState state{ExecutionState::Running};
+    std::atomic<ExecutionState> state{ExecutionState::Running};
+    std::function<void()> terminator;
     wl_event_loop* const loop;
-    std::deque<std::function<void()>> workqueue;
+
+    Node stub;
+    std::atomic<Node*> tail{&stub};
+    Node* head{&stub};
+    std::atomic<bool> wakeup_pending{false};
 };
 
 thread_local bool mf::WaylandExecutor::State::on_wayland_thread{false};
@@ -162,9 +274,9 @@ public:
 
         EventLoopDestroyedHandler* me;
         me = wl_container_of(listener, me, destruction_listener);
-        delete me;
 
         wl_list_remove(&listener->link);
+        delete me;
     }
 private:
     EventLoopDestroyedHandler(
@@ -233,22 +345,9 @@ int mf::WaylandExecutor::State::on_notify(int fd, uint32_t, void* data)
             err);
     }
 
-    while (auto work = state->get_work())
-    {
-        try
-        {
-            work();
-        }
-        catch (...)
-        {
-            mir::log(
-                mir::logging::Severity::critical,
-                MIR_LOG_COMPONENT,
-                std::current_exception(),
-                "Exception processing Wayland event loop work item");
-        }
-    }
-    if (state->state != ExecutionState::Running)
+    state->process_work();
+
+    if (state->state.load() != ExecutionState::Running)
     {
         EventLoopDestroyedHandler::remove_destruction_handler_for_loop(state->loop);
     }
@@ -319,7 +418,8 @@ mf::WaylandExecutor::~WaylandExecutor()
 
 void mf::WaylandExecutor::spawn (std::function<void()>&& work)
 {
-    state->enqueue(std::move(work));
+    if (!state->enqueue(std::move(work)))
+        return;
 
     if (auto err = eventfd_write(notify_fd, 1))
     {
@@ -26,7 +26,6 @@
 
 #include <mutex>
 #include <memory>
-#include <deque>
 
 namespace mir
 {
@@ -52,7 +52,22 @@ mf::WaylandSurfaceObserver::WaylandSurfaceObserver(
       surface{surface},
       window{window},
       window_size{geometry::Size{0,0}},
-      destroyed{std::make_shared<bool>(false)}
+      destroyed{std::make_shared<bool>(false)},
+      motion_coalescer{
+          seat->coalesces_pointer_motion(client),
+          [surface]() { return surface->awaiting_frame(); },
+          [surface, destroyed = destroyed](std::function<void()>&& action)
+          {
+              surface->on_next_frame(run_unless(destroyed, action));
+          },
+          [seat, client, surface](std::chrono::milliseconds ms, geometry::Point position)
+          {
+              seat->for_each_listener(client, [&ms, surface, &position](WlPointer* pointer)
+                  {
+                      pointer->motion(ms, surface, position);
+                      pointer->frame();
+                  });
+          }}
 {
 }
 
@@ -177,6 +192,9 @@ void mf::WaylandSurfaceObserver::handle_input_event(MirInputEvent const* event)
     if (mir_input_event_has_cookie(event))
         timestamp = ns;
 
+    // Anything but more motion has to reach the client after the motion before it
+    motion_coalescer.before(event);
+
     switch (mir_input_event_get_type(event))
     {
     case mir_input_event_type_key:
@@ -314,6 +332,10 @@ void mf::WaylandSurfaceObserver::handle_pointer_motion_event(
 
     last_pointer_position = position;
 
+    // The client only needs to know where the pointer is when it starts drawing its next frame
+    if (send_motion && !send_axis && motion_coalescer.hold(ms, position))
+        return;
+
     if (send_motion || send_axis)
     {
         seat->for_each_listener(
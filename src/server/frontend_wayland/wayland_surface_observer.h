@@ -21,6 +21,7 @@
 #define MIR_FRONTEND_WAYLAND_SURFACE_OBSERVER_H_
 
 #include "mir/scene/null_surface_observer.h"
+#include "pointer_motion_coalescer.h"
 
 #include <memory>
 #include <experimental/optional>
@@ -100,6 +101,7 @@ private:
     MirPointerButtons last_pointer_buttons{0};
     std::experimental::optional<mir::geometry::Point> last_pointer_position;
     std::shared_ptr<bool> const destroyed;
+    PointerMotionCoalescer motion_coalescer;
 
     void run_on_wayland_thread_unless_destroyed(std::function<void()>&& work);
 
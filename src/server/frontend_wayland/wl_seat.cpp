@@ -158,7 +158,8 @@ mf::WlSeat::WlSeat(
     wl_display* display,
     std::shared_ptr<mi::InputDeviceHub> const& input_hub,
     std::shared_ptr<mi::Seat> const& seat,
-    std::shared_ptr<mir::Executor> const& executor)
+    std::shared_ptr<mir::Executor> const& executor,
+    std::function<bool(wl_client*)> const& coalesce_pointer_motion)
     :   Global(display, Version<6>()),
         keymap{std::make_unique<input::Keymap>()},
         config_observer{
@@ -173,7 +174,8 @@ mf::WlSeat::WlSeat(
         touch_listeners{std::make_shared<ListenerList<WlTouch>>()},
         input_hub{input_hub},
         seat{seat},
-        executor{executor}
+        executor{executor},
+        coalesce_pointer_motion{coalesce_pointer_motion}
 {
     input_hub->add_observer(config_observer);
 }
@@ -214,6 +216,11 @@ void mf::WlSeat::spawn(std::function<void()>&& work)
     executor->spawn(std::move(work));
 }
 
+auto mf::WlSeat::coalesces_pointer_motion(wl_client* client) const -> bool
+{
+    return coalesce_pointer_motion(client);
+}
+
 void mf::WlSeat::bind(wl_resource* new_wl_seat)
 {
     new Instance{new_wl_seat, this};
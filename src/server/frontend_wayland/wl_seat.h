@@ -54,7 +54,8 @@ public:
         wl_display* display,
         std::shared_ptr<mir::input::InputDeviceHub> const& input_hub,
         std::shared_ptr<mir::input::Seat> const& seat,
-        std::shared_ptr<mir::Executor> const& executor);
+        std::shared_ptr<mir::Executor> const& executor,
+        std::function<bool(wl_client*)> const& coalesce_pointer_motion = [](wl_client*) { return false; });
 
     ~WlSeat();
 
@@ -66,6 +67,9 @@ public:
 
     void spawn(std::function<void()>&& work);
 
+    /// Whether the client should only be sent the latest pointer motion while it's drawing a frame
+    auto coalesces_pointer_motion(wl_client* client) const -> bool;
+
     class ListenerTracker
     {
     public:
@@ -102,6 +106,7 @@ private:
     std::shared_ptr<input::Seat> const seat;
 
     std::shared_ptr<mir::Executor> const executor;
+    std::function<bool(wl_client*)> const coalesce_pointer_motion;
 
     void bind(wl_resource* new_wl_seat) override;
 
@@ -39,11 +39,32 @@
 #include "mir/log.h"
 
 #include <algorithm>
+#include <limits>
 
 namespace mf = mir::frontend;
 namespace geom = mir::geometry;
 namespace mw = mir::wayland;
 
+namespace
+{
+// Clients commonly damage INT32_MAX × INT32_MAX to mean "everything"
+geom::Rectangle damage_rectangle(int32_t x, int32_t y, int32_t width, int32_t height)
+{
+    auto const clamp = [](int64_t value)
+        {
+            return static_cast<int>(std::max<int64_t>(
+                0, std::min<int64_t>(value, std::numeric_limits<int32_t>::max())));
+        };
+
+    int const left = clamp(x);
+    int const top = clamp(y);
+    int const right = clamp(int64_t{x} + width);
+    int const bottom = clamp(int64_t{y} + height);
+
+    return {{left, top}, {std::max(right - left, 0), std::max(bottom - top, 0)}};
+}
+}
+
 mf::WlSurfaceState::Callback::Callback(wl_resource* new_resource)
     : mw::Callback{new_resource, Version<1>()},
       destroyed{deleted_flag_for_resource(resource)}
@@ -61,6 +82,8 @@ void mf::WlSurfaceState::update_from(WlSurfaceState const& source)
     if (source.input_shape)
         input_shape = source.input_shape;
 
+    buffer_damage.add(source.buffer_damage);
+
     frame_callbacks.insert(end(frame_callbacks),
                            begin(source.frame_callbacks),
                            end(source.frame_callbacks));
@@ -221,8 +244,19 @@ mf::WlSurface* mf::WlSurface::from(wl_resource* resource)
     return static_cast<WlSurface*>(static_cast<wayland::Surface*>(raw_surface));
 }
 
+void mf::WlSurface::on_next_frame(std::function<void()>&& action)
+{
+    next_frame_actions.push_back(std::move(action));
+}
+
 void mf::WlSurface::send_frame_callbacks()
 {
+    // Actions may add more for the frame after
+    std::vector<std::function<void()>> actions;
+    std::swap(actions, next_frame_actions);
+    for (auto const& action : actions)
+        action();
+
     for (auto const& frame : frame_callbacks)
     {
         if (!*frame->destroyed)
@@ -255,20 +289,13 @@ void mf::WlSurface::attach(std::experimental::optional<wl_resource*> const& buff
 
 void mf::WlSurface::damage(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    // Surface and buffer coordinates are the same until we support buffer scale and transform
+    pending.buffer_damage.add(damage_rectangle(x, y, width, height));
 }
 
 void mf::WlSurface::damage_buffer(int32_t x, int32_t y, int32_t width, int32_t height)
 {
-    (void)x;
-    (void)y;
-    (void)width;
-    (void)height;
-    // This isn't essential, but could enable optimizations
+    pending.buffer_damage.add(damage_rectangle(x, y, width, height));
 }
 
 void mf::WlSurface::frame(wl_resource* new_callback)
@@ -318,6 +345,7 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
         {
             // TODO: unmap surface, and unmap all subsurfaces
             buffer_size_ = std::experimental::nullopt;
+            last_shm_buffer.reset();
             send_frame_callbacks();
         }
         else
@@ -336,10 +364,17 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
 
             if (wl_shm_buffer_get(buffer))
             {
-                mir_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
+                auto const shm_buffer = WlShmBuffer::mir_buffer_from_wl_buffer(
                     buffer,
                     executor,
                     std::move(executor_send_frame_callbacks));
+
+                // If the last buffer has already been released we can't say what changed
+                if (auto const previous = last_shm_buffer.lock())
+                    shm_buffer->set_damage_since(*previous, state.buffer_damage);
+
+                last_shm_buffer = shm_buffer;
+                mir_buffer = shm_buffer;
                 tracepoint(
                     mir_server_wayland,
                     sw_buffer_committed,
@@ -348,6 +383,8 @@ void mf::WlSurface::commit(WlSurfaceState const& state)
             }
             else
             {
+                last_shm_buffer.reset();
+
                 std::shared_ptr<bool> buffer_destroyed = deleted_flag_for_resource(buffer);
 
                 auto release_buffer = [executor = executor, buffer = buffer, destroyed = buffer_destroyed]()
@@ -29,6 +29,7 @@
 #include "mir/geometry/displacement.h"
 #include "mir/geometry/size.h"
 #include "mir/geometry/point.h"
+#include "mir/geometry/region.h"
 
 #include <vector>
 #include <map>
@@ -56,6 +57,7 @@ class BufferStream;
 class MirClientSession;
 class WlSurface;
 class WlSubsurface;
+class WlShmBuffer;
 
 struct WlSurfaceState
 {
@@ -81,6 +83,8 @@ struct WlSurfaceState
     std::experimental::optional<geometry::Displacement> offset;
     std::experimental::optional<std::experimental::optional<std::vector<geometry::Rectangle>>> input_shape;
     std::vector<std::shared_ptr<Callback>> frame_callbacks;
+    /// Damage to the buffer (or, as we don't support buffer scale or transform, surface)
+    geometry::Region buffer_damage;
 
 private:
     // only set to true if invalidate_surface_data() is called
@@ -141,6 +145,10 @@ public:
     void commit(WlSurfaceState const& state);
     void add_destroy_listener(void const* key, std::function<void()> listener);
     void remove_destroy_listener(void const* key);
+    /// If the client is waiting for a frame callback (i.e. is drawing a frame)
+    bool awaiting_frame() const { return !frame_callbacks.empty(); }
+    /// Runs action once, just before the next frame callbacks are sent
+    void on_next_frame(std::function<void()>&& action);
 
     std::shared_ptr<MirClientSession> const session;
     mir::frontend::BufferStreamId const stream_id;
@@ -160,8 +168,11 @@ private:
     geometry::Displacement offset_;
     std::experimental::optional<geometry::Size> buffer_size_;
     std::vector<std::shared_ptr<WlSurfaceState::Callback>> frame_callbacks;
+    std::vector<std::function<void()>> next_frame_actions;
     std::experimental::optional<std::vector<mir::geometry::Rectangle>> input_shape;
     std::map<void const*, std::function<void()>> destroy_listeners;
+    /// The last buffer committed, if it was shm, so the next can say how it differs
+    std::weak_ptr<WlShmBuffer> last_shm_buffer;
     std::shared_ptr<bool> const destroyed;
 
     void send_frame_callbacks();
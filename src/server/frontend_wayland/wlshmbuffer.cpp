@@ -31,6 +31,7 @@
 #include <boost/throw_exception.hpp>
 
 #include <cstring>
+#include <algorithm>
 
 namespace
 {
@@ -121,6 +122,30 @@ GLenum const abgr = GL_INVALID_ENUM;
 
     return gl_format != GL_INVALID_ENUM && gl_type != GL_INVALID_ENUM;
 }
+
+// Textures lagging further behind than this are uploaded in full
+size_t const max_differences = 3;
+
+/*
+ * GLES2 has no GL_UNPACK_ROW_LENGTH, so we can only upload whole rows. Finds
+ * the row ranges [top, bottom) that the damage touches.
+ */
+std::vector<std::pair<int, int>> damaged_rows(mir::geometry::Region const& damage)
+{
+    std::vector<std::pair<int, int>> rows;
+    for (auto const& rect : damage.rectangles())
+    {
+        int const top = rect.top().as_int();
+        int const bottom = rect.bottom().as_int();
+
+        // Bands are ordered top to bottom, so only the last range can overlap
+        if (!rows.empty() && top <= rows.back().second)
+            rows.back().second = std::max(rows.back().second, bottom);
+        else
+            rows.emplace_back(top, bottom);
+    }
+    return rows;
+}
 }
 
 namespace mf = mir::frontend;
@@ -138,7 +163,7 @@ mf::WlShmBuffer::~WlShmBuffer()
         });
 }
 
-std::shared_ptr<mg::Buffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
+std::shared_ptr<mf::WlShmBuffer> mf::WlShmBuffer::mir_buffer_from_wl_buffer(
     wl_resource *buffer,
     std::shared_ptr<Executor> executor,
     std::function<void()> &&on_consumed)
@@ -236,6 +261,79 @@ void mf::WlShmBuffer::bind()
     gl_bind_to_texture();
 }
 
+size_t mf::WlShmBuffer::bind_over(mg::BufferID texture_contents)
+{
+    std::vector<std::pair<int, int>> rows;
+    {
+        std::lock_guard<std::mutex> lock{differences_mutex};
+        auto const difference = std::find_if(
+            differences.begin(), differences.end(),
+            [texture_contents](Difference const& d) { return d.since == texture_contents; });
+
+        if (difference == differences.end())
+        {
+            gl_bind_to_texture();
+            return size_.height.as_int() * size_.width.as_int() * MIR_BYTES_PER_PIXEL(format_);
+        }
+
+        rows = damaged_rows(difference->damage);
+    }
+
+    size_t uploaded = 0;
+    GLenum format, type;
+
+    if (get_gl_pixel_format(format_, format, type))
+    {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        // Even with nothing to upload, the client needs to know we've used the buffer
+        read(
+            [this, &rows, format, type](unsigned char const* pixels)
+            {
+                for (auto const& row : rows)
+                {
+                    glTexSubImage2D(GL_TEXTURE_2D, 0,
+                                    0, row.first,
+                                    size_.width.as_int(), row.second - row.first,
+                                    format, type,
+                                    pixels + row.first * stride_.as_int());
+                }
+            });
+
+        for (auto const& row : rows)
+            uploaded += (row.second - row.first) * size_.width.as_int() * MIR_BYTES_PER_PIXEL(format_);
+    }
+
+    return uploaded;
+}
+
+void mf::WlShmBuffer::set_damage_since(WlShmBuffer const& previous, Region const& damage)
+{
+    // Reattaching the same wl_buffer gets the same WlShmBuffer back
+    if (&previous == this ||
+        previous.size_ != size_ || previous.stride_ != stride_ || previous.format_ != format_)
+        return;
+
+    auto const clipped = damage.intersection_with(Rectangle{{0, 0}, size_});
+
+    std::vector<Difference> result{{previous.id(), clipped}};
+    {
+        std::lock_guard<std::mutex> lock{previous.differences_mutex};
+        for (auto const& earlier : previous.differences)
+        {
+            if (result.size() == max_differences)
+                break;
+
+            auto combined = earlier.damage;
+            combined.add(clipped);
+            result.push_back({earlier.since, std::move(combined)});
+        }
+    }
+
+    std::lock_guard<std::mutex> lock{differences_mutex};
+    differences = std::move(result);
+}
+
 void mf::WlShmBuffer::secure_for_render()
 {
 }
@@ -256,12 +354,9 @@ void mf::WlShmBuffer::write(unsigned char const *pixels, size_t size)
 
 void mf::WlShmBuffer::read(std::function<void(unsigned char const *)> const &do_with_pixels)
 {
+    // The contents were copied on the Wayland thread, so they're still
+    // valid if the client has since resized the pool or destroyed the wl_buffer
     std::lock_guard <std::mutex> lock{wayland->mutex};
-    if (!wayland->buffer) {
-        log_warning("Attempt to read from WlShmBuffer after the wl_buffer has been destroyed");
-        return;
-    }
-
     if (!consumed) {
         on_consumed();
         consumed = true;
@@ -21,7 +21,9 @@
 #define MIR_FRONTEND_WLSHMBUFFER_H_
 
 #include <mir/graphics/buffer_basic.h>
+#include <mir/geometry/region.h>
 #include <mir/renderer/gl/texture_source.h>
+#include <mir/renderer/gl/incremental_texture_source.h>
 #include <mir/renderer/sw/pixel_source.h>
 
 #include <wayland-server-core.h>
@@ -29,6 +31,7 @@
 #include <functional>
 #include <mutex>
 #include <string>
+#include <vector>
 #include <experimental/optional>
 
 namespace mir
@@ -42,6 +45,7 @@ class WlShmBuffer :
     public graphics::BufferBasic,
     public graphics::NativeBufferBase,
     public renderer::gl::TextureSource,
+    public renderer::gl::IncrementalTextureSource,
     public renderer::software::PixelSource
 {
 public:
@@ -51,7 +55,7 @@ public:
         std::function<void()> &&on_consumed);
     ~WlShmBuffer();
 
-    static std::shared_ptr <graphics::Buffer> mir_buffer_from_wl_buffer(
+    static std::shared_ptr<WlShmBuffer> mir_buffer_from_wl_buffer(
         wl_resource *buffer,
         std::shared_ptr<Executor> executor,
         std::function<void()> &&on_consumed);
@@ -68,6 +72,14 @@ public:
 
     void bind() override;
 
+    size_t bind_over(graphics::BufferID texture_contents) override;
+
+    /**
+     * Records that this buffer differs from \a previous (the buffer the
+     * client submitted before it) only within \a damage.
+     */
+    void set_damage_since(WlShmBuffer const& previous, geometry::Region const& damage);
+
     void secure_for_render() override;
 
     void write(unsigned char const *pixels, size_t size) override;
@@ -112,6 +124,16 @@ private:
     std::function<void()> on_consumed;
 
     std::shared_ptr<Executor> executor;
+
+    /// How this buffer differs from those submitted shortly before it
+    struct Difference
+    {
+        graphics::BufferID since;
+        geometry::Region damage;
+    };
+
+    std::mutex mutable differences_mutex;
+    std::vector<Difference> differences;
 };
 }
 }
@@ -147,7 +147,34 @@ void mgo::DisplayBuffer::release_current()
 
 void mgo::DisplayBuffer::swap_buffers()
 {
-    glFinish();
+    if (frame.empty())
+        glFinish();
+    else
+        frame_swapped = true;
+}
+
+geom::Size mgo::DisplayBuffer::size() const
+{
+    return area.size;
+}
+
+geom::Stride mgo::DisplayBuffer::stride() const
+{
+    return geom::Stride{area.size.width.as_int() * 4};
+}
+
+unsigned char* mgo::DisplayBuffer::pixels()
+{
+    if (frame.empty())
+        frame.resize(area.size.width.as_int() * area.size.height.as_int());
+
+    return reinterpret_cast<unsigned char*>(frame.data());
+}
+
+unsigned int mgo::DisplayBuffer::buffer_age() const
+{
+    // There is only the one frame, so it always holds the last one drawn
+    return frame_swapped ? 1 : 0;
 }
 
 bool mgo::DisplayBuffer::overlay(RenderableList const&)
@@ -25,9 +25,13 @@
 #include "mir/geometry/size.h"
 #include "mir/geometry/rectangle.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/renderer/sw/pixel_target.h"
 
 #include <EGL/egl.h>
 
+#include <cstdint>
+#include <vector>
+
 namespace mir
 {
 namespace graphics
@@ -57,9 +61,14 @@ private:
 
 }
 
+/**
+ * Renders into a GL framebuffer object or, for the software renderer, into
+ * memory. Neither is ever shown.
+ */
 class DisplayBuffer : public graphics::DisplayBuffer,
                       public graphics::NativeDisplayBuffer,
-                      public renderer::gl::RenderTarget
+                      public renderer::gl::RenderTarget,
+                      public renderer::software::PixelTarget
 {
 public:
     DisplayBuffer(SurfacelessEGLContext egl_context,
@@ -73,10 +82,20 @@ public:
     void bind() override;
     void release_current() override;
     void swap_buffers() override;
+
+    geometry::Size size() const override;
+    geometry::Stride stride() const override;
+    unsigned char* pixels() override;
+    unsigned int buffer_age() const override;
+
 private:
     SurfacelessEGLContext const egl_context;
     detail::GLFramebufferObject const fbo;
     geometry::Rectangle const area;
+
+    /// Allocated when the software renderer first draws
+    std::vector<uint32_t> frame;
+    bool frame_swapped{false};
 };
 
 }
@@ -217,14 +217,24 @@ void mg::SoftwareCursor::hide()
 
 void mg::SoftwareCursor::move_to(geometry::Point position)
 {
+    geom::Rectangle old_area;
+    geom::Rectangle new_area;
     {
         std::lock_guard<std::mutex> lg{guard};
 
         if (!renderable)
             return;
 
-        renderable->move_to(position - hotspot);
+        old_area = renderable->screen_position();
+        new_area = {position - hotspot, old_area.size};
+
+        if (new_area == old_area)
+            return;
+
+        renderable->move_to(new_area.top_left);
     }
 
-    scene->emit_scene_changed();
+    // Only where the cursor was and where it is now need recompositing
+    scene->emit_scene_damaged(old_area);
+    scene->emit_scene_damaged(new_area);
 }
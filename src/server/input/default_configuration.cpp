@@ -29,6 +29,7 @@
 #include "builtin_cursor_images.h"
 #include "default_input_device_hub.h"
 #include "default_input_manager.h"
+#include "input_trace.h"
 #include "surface_input_dispatcher.h"
 #include "basic_seat.h"
 #include "seat_observer_multiplexer.h"
@@ -316,12 +317,19 @@ std::shared_ptr<mi::DefaultInputDeviceHub> mir::DefaultServerConfiguration::the_
        {
            auto input_dispatcher = the_input_dispatcher();
            auto key_repeater = std::dynamic_pointer_cast<mi::KeyRepeatDispatcher>(input_dispatcher);
+
+           std::shared_ptr<mi::InputTraceRecorder> trace_recorder;
+           auto const options = the_options();
+           if (options->is_set(options::input_trace_opt))
+               trace_recorder = std::make_shared<mi::InputTraceRecorder>(options->get<std::string>(options::input_trace_opt));
+
            auto hub = std::make_shared<mi::DefaultInputDeviceHub>(
                the_seat(),
                the_input_reading_multiplexer(),
                the_cookie_authority(),
                the_key_mapper(),
-               the_server_status_listener());
+               the_server_status_listener(),
+               trace_recorder);
 
            // lp:1675357: KeyRepeatDispatcher must be informed about removed input devices, otherwise
            // pressed keys get repeated indefinitely
@@ -18,6 +18,7 @@
 
 #include "default_input_device_hub.h"
 #include "default_device.h"
+#include "input_trace.h"
 
 #include "mir/input/input_device.h"
 #include "mir/input/input_device_observer.h"
@@ -174,13 +175,15 @@ mi::DefaultInputDeviceHub::DefaultInputDeviceHub(
     std::shared_ptr<dispatch::MultiplexingDispatchable> const& input_multiplexer,
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
     std::shared_ptr<mi::KeyMapper> const& key_mapper,
-    std::shared_ptr<mir::ServerStatusListener> const& server_status_listener)
+    std::shared_ptr<mir::ServerStatusListener> const& server_status_listener,
+    std::shared_ptr<InputTraceRecorder> const& trace_recorder)
     : seat{seat},
       input_dispatchable{input_multiplexer},
       device_queue(std::make_shared<dispatch::ActionQueue>()),
       cookie_authority(cookie_authority),
       key_mapper(key_mapper),
       server_status_listener(server_status_listener),
+      trace_recorder(trace_recorder),
       device_id_generator{0}
 {
     input_dispatchable->add_watch(device_queue);
@@ -204,7 +207,10 @@ void mi::DefaultInputDeviceHub::add_device(std::shared_ptr<InputDevice> const& d
         auto handle = restore_or_create_device(*device, queue);
         // send input device info to observer loop..
         devices.push_back(std::make_unique<RegisteredDevice>(
-            device, handle->id(), queue, cookie_authority, handle));
+            device, handle->id(), queue, cookie_authority, handle, trace_recorder));
+
+        if (trace_recorder)
+            trace_recorder->device_added(handle->id(), device->get_device_info());
 
         auto const& dev = devices.back();
         add_device_handle(handle);
@@ -240,6 +246,9 @@ void mi::DefaultInputDeviceHub::remove_device(std::shared_ptr<InputDevice> const
                 }
                 remove_device_handle(item->id());
 
+                if (trace_recorder)
+                    trace_recorder->device_removed(item->id());
+
                 return true;
             }
             return false;
@@ -258,12 +267,14 @@ mi::DefaultInputDeviceHub::RegisteredDevice::RegisteredDevice(
     MirInputDeviceId device_id,
     std::shared_ptr<dispatch::ActionQueue> const& queue,
     std::shared_ptr<mir::cookie::Authority> const& cookie_authority,
-    std::shared_ptr<mi::DefaultDevice> const& handle)
+    std::shared_ptr<mi::DefaultDevice> const& handle,
+    std::shared_ptr<InputTraceRecorder> const& trace_recorder)
     : handle(handle),
       device_id(device_id),
       cookie_authority(cookie_authority),
       device(dev),
-      queue(queue)
+      queue(queue),
+      trace_recorder(trace_recorder)
 {
 }
 
@@ -288,6 +299,9 @@ void mi::DefaultInputDeviceHub::RegisteredDevice::handle_input(std::shared_ptr<M
     if (!seat)
         return;
 
+    if (trace_recorder)
+        trace_recorder->record(*event);
+
     seat->dispatch_event(event);
 }
 
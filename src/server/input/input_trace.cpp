@@ -0,0 +1,329 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "input_trace.h"
+
+#include "mir/input/input_device_info.h"
+#include "mir/thread_name.h"
+#define MIR_LOG_COMPONENT "Input"
+#include "mir/log.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mi = mir::input;
+
+namespace
+{
+// Enough to keep the number of writes down without losing much if we crash
+size_t const records_per_write = 64;
+// How far the disk may fall behind before batches are dropped: 256KiB of records
+size_t const max_full_batches = 64;
+
+void write_fully(mir::Fd const& file, void const* data, size_t size)
+{
+    auto bytes = static_cast<char const*>(data);
+    while (size > 0)
+    {
+        auto const written = ::write(file, bytes, size);
+        if (written < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            BOOST_THROW_EXCEPTION((std::system_error{errno, std::system_category(), "Failed to write input trace"}));
+        }
+        bytes += written;
+        size -= written;
+    }
+}
+
+auto blank_record(int64_t device_id, int64_t event_time_ns, mi::InputTraceRecord::Kind kind) -> mi::InputTraceRecord
+{
+    mi::InputTraceRecord record;
+    memset(&record, 0, sizeof record);
+    record.event_time_ns = event_time_ns;
+    record.device_id = device_id;
+    record.kind = kind;
+    return record;
+}
+}
+
+mi::InputTraceRecorder::InputTraceRecorder(std::string const& path)
+    : file{::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0600)},
+      written{sizeof(InputTraceHeader)}
+{
+    // Input includes whatever is typed, passwords and all. So if the file was
+    // already there, it's still only for its owner.
+    if (file == mir::Fd::invalid || fchmod(file, 0600) != 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{
+            errno,
+            std::system_category(),
+            "Failed to open input trace file \"" + path + "\""}));
+    }
+
+    InputTraceHeader header;
+    memset(&header, 0, sizeof header);
+    memcpy(header.magic, "MIRINPUT", sizeof header.magic);
+    header.version = InputTraceHeader::current_version;
+    header.record_size = sizeof(InputTraceRecord);
+    write_fully(file, &header, sizeof header);
+
+    pending.reserve(records_per_write);
+
+    writer = std::thread{[this] { write_batches(); }};
+}
+
+mi::InputTraceRecorder::~InputTraceRecorder()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    writer.join();
+}
+
+void mi::InputTraceRecorder::device_added(MirInputDeviceId id, InputDeviceInfo const& info)
+{
+    auto record = blank_record(id, 0, InputTraceRecord::device_added);
+    record.device.capabilities = info.capabilities.value();
+    strncpy(record.device.name, info.name.c_str(), sizeof record.device.name - 1);
+
+    append(record);
+}
+
+void mi::InputTraceRecorder::device_removed(MirInputDeviceId id)
+{
+    append(blank_record(id, 0, InputTraceRecord::device_removed));
+}
+
+void mi::InputTraceRecorder::record(MirEvent const& event)
+{
+    // Device state events are the seat's business, and are rebuilt from what's recorded here on replay
+    if (mir_event_get_type(&event) != mir_event_type_input)
+        return;
+
+    auto const input_event = mir_event_get_input_event(&event);
+    auto const device_id = mir_input_event_get_device_id(input_event);
+    auto const event_time = mir_input_event_get_event_time(input_event);
+
+    switch (mir_input_event_get_type(input_event))
+    {
+    case mir_input_event_type_key:
+    {
+        auto const key_event = mir_input_event_get_keyboard_event(input_event);
+        auto record = blank_record(device_id, event_time, InputTraceRecord::key_event);
+        record.action = mir_keyboard_event_action(key_event);
+        record.modifiers = mir_keyboard_event_modifiers(key_event);
+        record.key.scan_code = mir_keyboard_event_scan_code(key_event);
+        record.key.key_code = mir_keyboard_event_key_code(key_event);
+        append(record);
+        break;
+    }
+    case mir_input_event_type_pointer:
+    {
+        auto const pointer_event = mir_input_event_get_pointer_event(input_event);
+        auto record = blank_record(device_id, event_time, InputTraceRecord::pointer_event);
+        record.action = mir_pointer_event_action(pointer_event);
+        record.modifiers = mir_pointer_event_modifiers(pointer_event);
+        record.pointer.buttons = mir_pointer_event_buttons(pointer_event);
+        record.pointer.x = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_x);
+        record.pointer.y = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_y);
+        record.pointer.relative_x = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_relative_x);
+        record.pointer.relative_y = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_relative_y);
+        record.pointer.hscroll = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_hscroll);
+        record.pointer.vscroll = mir_pointer_event_axis_value(pointer_event, mir_pointer_axis_vscroll);
+        append(record);
+        break;
+    }
+    case mir_input_event_type_touch:
+    {
+        auto const touch_event = mir_input_event_get_touch_event(input_event);
+        auto const point_count = mir_touch_event_point_count(touch_event);
+        for (auto i = 0u; i != point_count; ++i)
+        {
+            auto record = blank_record(device_id, event_time, InputTraceRecord::touch_point);
+            record.action = mir_touch_event_action(touch_event, i);
+            record.modifiers = mir_touch_event_modifiers(touch_event);
+            record.point = i;
+            record.point_count = point_count;
+            record.touch.id = mir_touch_event_id(touch_event, i);
+            record.touch.tooltype = mir_touch_event_tooltype(touch_event, i);
+            record.touch.x = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_x);
+            record.touch.y = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_y);
+            record.touch.pressure = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_pressure);
+            record.touch.touch_major = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_touch_major);
+            record.touch.touch_minor = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_touch_minor);
+            record.touch.size = mir_touch_event_axis_value(touch_event, i, mir_touch_axis_size);
+            append(record);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void mi::InputTraceRecorder::append(InputTraceRecord const& record)
+{
+    std::lock_guard<std::mutex> lock{mutex};
+
+    pending.push_back(record);
+    if (pending.size() < records_per_write)
+        return;
+
+    if (full.size() == max_full_batches)
+    {
+        // Losing the trace mustn't hold input up
+        dropped += pending.size();
+        pending.clear();
+        return;
+    }
+
+    full.push_back(std::move(pending));
+
+    if (spare.empty())
+    {
+        pending = Batch{};
+        pending.reserve(records_per_write);
+    }
+    else
+    {
+        pending = std::move(spare.back());
+        spare.pop_back();
+    }
+
+    wakeup.notify_one();
+}
+
+void mi::InputTraceRecorder::write_batches()
+{
+    mir::set_thread_name("Mir/InputTrace");
+
+    std::unique_lock<std::mutex> lock{mutex};
+
+    for (;;)
+    {
+        wakeup.wait(lock, [this] { return stopping || !full.empty() || dropped; });
+
+        if (auto const lost = dropped)
+        {
+            dropped = 0;
+            lock.unlock();
+            log_warning("Dropped %zu input trace records: they came in faster than they could be written", lost);
+            lock.lock();
+        }
+
+        if (full.empty() && stopping)
+        {
+            if (pending.empty())
+                return;
+
+            full.push_back(std::move(pending));
+            pending.clear();
+        }
+
+        while (!full.empty())
+        {
+            auto batch = std::move(full.front());
+            full.pop_front();
+
+            lock.unlock();
+            write(batch);
+            batch.clear();
+            lock.lock();
+
+            spare.push_back(std::move(batch));
+        }
+    }
+}
+
+void mi::InputTraceRecorder::write(Batch const& batch)
+{
+    auto const size = batch.size() * sizeof(InputTraceRecord);
+
+    try
+    {
+        write_fully(file, batch.data(), size);
+        written += size;
+    }
+    catch (std::exception const& error)
+    {
+        log_error("Dropped input trace records: %s", error.what());
+
+        // Leave no part of a record behind, so whatever comes next lines up
+        if (ftruncate(file, written) != 0 || lseek(file, written, SEEK_SET) != written)
+        {
+            log_error("Failed to cut the input trace back to the last whole record: %s", strerror(errno));
+        }
+    }
+}
+
+mi::InputTrace::InputTrace(std::string const& path)
+    : file{::open(path.c_str(), O_RDONLY | O_CLOEXEC)}
+{
+    struct stat info;
+    if (file == mir::Fd::invalid || fstat(file, &info) != 0)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{
+            errno, std::system_category(), "Failed to open input trace \"" + path + "\""}));
+    }
+
+    size = info.st_size;
+    if (size < sizeof(InputTraceHeader))
+        BOOST_THROW_EXCEPTION(std::runtime_error{"\"" + path + "\" is too short to be an input trace"});
+
+    data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    if (data == MAP_FAILED)
+    {
+        BOOST_THROW_EXCEPTION((std::system_error{
+            errno, std::system_category(), "Failed to map input trace \"" + path + "\""}));
+    }
+
+    auto const header = static_cast<InputTraceHeader const*>(data);
+    if (memcmp(header->magic, "MIRINPUT", sizeof header->magic) != 0 ||
+        header->version != InputTraceHeader::current_version ||
+        header->record_size != sizeof(InputTraceRecord))
+    {
+        munmap(data, size);
+        BOOST_THROW_EXCEPTION(std::runtime_error{"\"" + path + "\" is not a version of input trace we can read"});
+    }
+}
+
+mi::InputTrace::~InputTrace()
+{
+    munmap(data, size);
+}
+
+auto mi::InputTrace::begin() const -> InputTraceRecord const*
+{
+    return reinterpret_cast<InputTraceRecord const*>(static_cast<char const*>(data) + sizeof(InputTraceHeader));
+}
+
+auto mi::InputTrace::end() const -> InputTraceRecord const*
+{
+    // A trace cut short mid-record ends at the last whole one
+    return begin() + (size - sizeof(InputTraceHeader)) / sizeof(InputTraceRecord);
+}
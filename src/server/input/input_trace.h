@@ -0,0 +1,169 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_INPUT_INPUT_TRACE_H_
+#define MIR_INPUT_INPUT_TRACE_H_
+
+#include "mir/fd.h"
+#include "mir_toolkit/event.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/types.h>
+
+namespace mir
+{
+namespace input
+{
+struct InputDeviceInfo;
+
+/**
+ * An input trace file is an InputTraceHeader followed by InputTraceRecords,
+ * in the order the server received them. Every record is the same size, so
+ * a trace can be mmap()ed and read in place.
+ */
+struct InputTraceHeader
+{
+    static uint32_t constexpr current_version = 1;
+
+    char magic[8];              ///< "MIRINPUT", not nul terminated
+    uint32_t version;
+    uint32_t record_size;
+};
+
+struct InputTraceRecord
+{
+    enum Kind : uint8_t
+    {
+        device_added,
+        device_removed,
+        key_event,
+        pointer_event,
+        touch_point     ///< One record per point; the event is complete at point + 1 == point_count
+    };
+
+    int64_t event_time_ns;      ///< As stamped by the device
+    int64_t device_id;
+    uint8_t kind;
+    uint8_t action;             ///< The event's MirKeyboardAction, MirPointerAction or MirTouchAction
+    uint8_t point;
+    uint8_t point_count;
+    uint32_t modifiers;
+
+    union
+    {
+        struct
+        {
+            uint32_t capabilities;
+            char name[36];      ///< Truncated, and nul terminated
+        } device;
+
+        struct
+        {
+            int32_t scan_code;
+            int32_t key_code;
+        } key;
+
+        struct
+        {
+            uint32_t buttons;
+            float x, y;
+            float relative_x, relative_y;
+            float hscroll, vscroll;
+        } pointer;
+
+        struct
+        {
+            int32_t id;
+            uint32_t tooltype;
+            float x, y;
+            float pressure, touch_major, touch_minor, size;
+        } touch;
+    };
+};
+
+static_assert(sizeof(InputTraceRecord) == 64, "Input trace records must keep their size to stay readable");
+
+/**
+ * Writes everything the input devices send to an input trace file.
+ *
+ * Records are collected in batches and written from a thread of its own, so
+ * input never waits for the disk. If the disk falls too far behind, whole
+ * batches are dropped. A failed write is cut back to the last whole record,
+ * so the file stays readable.
+ */
+class InputTraceRecorder
+{
+public:
+    /// Creates (or truncates) the file at path, readable only by its owner
+    explicit InputTraceRecorder(std::string const& path);
+    ~InputTraceRecorder();
+
+    void device_added(MirInputDeviceId id, InputDeviceInfo const& info);
+    void device_removed(MirInputDeviceId id);
+    void record(MirEvent const& event);
+
+private:
+    InputTraceRecorder(InputTraceRecorder const&) = delete;
+    InputTraceRecorder& operator=(InputTraceRecorder const&) = delete;
+
+    typedef std::vector<InputTraceRecord> Batch;
+
+    void append(InputTraceRecord const& record);
+    void write_batches();
+    void write(Batch const& batch);
+
+    mir::Fd const file;
+    off_t written;                  ///< The end of the last whole record in the file
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    Batch pending;
+    std::deque<Batch> full;         ///< Waiting to be written, oldest first
+    std::vector<Batch> spare;       ///< Written, and kept to be filled again
+    size_t dropped{0};
+    bool stopping{false};
+    std::thread writer;
+};
+
+/// A read-only view of an input trace file
+class InputTrace
+{
+public:
+    explicit InputTrace(std::string const& path);
+    ~InputTrace();
+
+    auto begin() const -> InputTraceRecord const*;
+    auto end() const -> InputTraceRecord const*;
+
+private:
+    InputTrace(InputTrace const&) = delete;
+    InputTrace& operator=(InputTrace const&) = delete;
+
+    mir::Fd const file;
+    size_t size;
+    void* data;
+};
+}
+}
+
+#endif /* MIR_INPUT_INPUT_TRACE_H_ */
@@ -152,9 +152,9 @@ mi::SurfaceInputDispatcher::SurfaceInputDispatcher(std::shared_ptr<mi::Scene> co
       started(false)
 {
     scene_observer = std::make_shared<InputDispatcherSceneObserver>(
-        [this](std::shared_ptr<ms::Surface> const& s) { surface_removed(s); },
-        [this](scene::Surface const* s) { surface_moved(s); },
-        [this] { surface_resized(); });
+        [this](std::shared_ptr<ms::Surface> const& s) { queue_scene_change({SceneChange::removed, s, nullptr}); },
+        [this](scene::Surface const* s) { queue_scene_change({SceneChange::moved, nullptr, s}); },
+        [this] { queue_scene_change({SceneChange::resized, nullptr, nullptr}); });
     scene->add_observer(scene_observer);
 }
 
@@ -182,14 +182,74 @@ bool compare_surfaces(std::shared_ptr<mi::Surface> const& input_surface, ms::Sur
 }
 }
 
-void mi::SurfaceInputDispatcher::surface_removed(std::shared_ptr<ms::Surface> surface)
+void mi::SurfaceInputDispatcher::queue_scene_change(SceneChange&& change)
 {
-    std::lock_guard<std::mutex> lg(dispatcher_mutex);
+    {
+        std::lock_guard<std::mutex> lock{scene_changes_mutex};
+
+        // The shell often moves or resizes the same surface many times over
+        // while dispatch is busy: all but the last of those make no difference
+        auto const repeat = !scene_changes.empty() &&
+            change.what != SceneChange::removed &&
+            scene_changes.back().what == change.what &&
+            scene_changes.back().moved_surface == change.moved_surface;
+
+        if (!repeat)
+            scene_changes.push_back(std::move(change));
+        ++scene_epoch;
+    }
+
+    apply_scene_changes();
+}
+
+void mi::SurfaceInputDispatcher::apply_scene_changes()
+{
+    while (scene_epoch != applied_epoch)
+    {
+        // Whoever holds the lock applies our changes on releasing it
+        std::unique_lock<std::mutex> lock{dispatcher_mutex, std::try_to_lock};
+        if (!lock)
+            return;
+
+        apply_scene_changes_locked();
+    }
+}
 
+void mi::SurfaceInputDispatcher::apply_scene_changes_locked()
+{
+    if (scene_epoch == applied_epoch)
+        return;
+
+    std::vector<SceneChange> changes;
+    {
+        std::lock_guard<std::mutex> lock{scene_changes_mutex};
+        changes.swap(scene_changes);
+        applied_epoch = scene_epoch.load();
+    }
+
+    for (auto const& change : changes)
+    {
+        switch (change.what)
+        {
+        case SceneChange::removed:
+            surface_removed_locked(change.removed_surface);
+            break;
+        case SceneChange::moved:
+            surface_moved_locked(change.moved_surface);
+            break;
+        case SceneChange::resized:
+            surface_resized_locked();
+            break;
+        }
+    }
+}
+
+void mi::SurfaceInputDispatcher::surface_removed_locked(std::shared_ptr<ms::Surface> const& surface)
+{
     auto strong_focus = focus_surface.lock();
     if (strong_focus && compare_surfaces(strong_focus, surface.get()))
     {
-        set_focus_locked(lg, nullptr);
+        focus_surface.reset();
     }
 
     for (auto& kv : pointer_state_by_id)
@@ -332,10 +392,8 @@ void send_motion_event_to_moved_surface(
 }
 }
 
-void mi::SurfaceInputDispatcher::surface_moved(ms::Surface const* moved_surface)
+void mi::SurfaceInputDispatcher::surface_moved_locked(ms::Surface const* moved_surface)
 {
-    std::lock_guard<std::mutex> lock{dispatcher_mutex};
-
     if (!last_pointer_event)
         return;
 
@@ -363,10 +421,8 @@ void mi::SurfaceInputDispatcher::surface_moved(ms::Surface const* moved_surface)
     }
 }
 
-void mi::SurfaceInputDispatcher::surface_resized()
+void mi::SurfaceInputDispatcher::surface_resized_locked()
 {
-    std::lock_guard<std::mutex> lock{dispatcher_mutex};
-
     if (!last_pointer_event)
         return;
 
@@ -404,6 +460,7 @@ void mi::SurfaceInputDispatcher::device_reset(MirInputDeviceId reset_device_id,
 bool mi::SurfaceInputDispatcher::dispatch_key(MirEvent const* kev)
 {
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
+    apply_scene_changes_locked();
 
     if (!started)
         return false;
@@ -442,12 +499,7 @@ bool is_gesture_terminator(MirPointerEvent const* pev)
 
 std::shared_ptr<mi::Surface> mi::SurfaceInputDispatcher::find_target_surface(geom::Point const& point)
 {
-    std::shared_ptr<mi::Surface> top_target = nullptr;
-    scene->for_each([&top_target, &point](std::shared_ptr<mi::Surface> const& target) {
-            if (target->input_area_contains(point))
-                top_target = target;
-    });
-    return top_target;
+    return scene->input_surface_at(point);
 }
 
 void mi::SurfaceInputDispatcher::send_enter_exit_event(std::shared_ptr<mi::Surface> const& surface,
@@ -490,6 +542,7 @@ bool mi::SurfaceInputDispatcher::dispatch_pointer(MirInputDeviceId id, std::shar
 {
     auto const ev = event.get();
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
+    apply_scene_changes_locked();
     last_pointer_event = event;
     auto const* input_ev = mir_event_get_input_event(ev);
     auto const* pev = mir_input_event_get_pointer_event(input_ev);
@@ -600,6 +653,7 @@ bool is_gesture_end(MirTouchEvent const* tev)
 bool mi::SurfaceInputDispatcher::dispatch_touch(MirInputDeviceId id, MirEvent const* ev)
 {
     std::lock_guard<std::mutex> lg(dispatcher_mutex);
+    apply_scene_changes_locked();
     auto const* input_ev = mir_event_get_input_event(ev);
     auto const* tev = mir_input_event_get_touch_event(input_ev);
 
@@ -639,19 +693,25 @@ bool mi::SurfaceInputDispatcher::dispatch(std::shared_ptr<MirEvent const> const&
     
     auto iev = mir_event_get_input_event(event.get());
     auto id = mir_input_event_get_device_id(iev);
+    bool dispatched;
     switch (mir_input_event_get_type(iev))
     {
     case mir_input_event_type_key:
-        return dispatch_key(event.get());
+        dispatched = dispatch_key(event.get());
+        break;
     case mir_input_event_type_touch:
-        return dispatch_touch(id, event.get());
+        dispatched = dispatch_touch(id, event.get());
+        break;
     case mir_input_event_type_pointer:
-        return dispatch_pointer(id, event);
+        dispatched = dispatch_pointer(id, event);
+        break;
     default:
         BOOST_THROW_EXCEPTION(std::logic_error("InputDispatcher got an input event of unknown type"));
     }
-    
-    return true;
+
+    // Scene changes queued while we held the lock
+    apply_scene_changes();
+    return dispatched;
 }
 
 void mi::SurfaceInputDispatcher::start()
@@ -679,25 +739,41 @@ void mi::SurfaceInputDispatcher::set_focus_locked(std::lock_guard<std::mutex> co
 
 void mi::SurfaceInputDispatcher::set_focus(std::shared_ptr<mi::Surface> const& target)
 {
-    std::lock_guard<std::mutex> lg(dispatcher_mutex);
-    set_focus_locked(lg, target);
+    {
+        std::lock_guard<std::mutex> lg(dispatcher_mutex);
+        apply_scene_changes_locked();
+        set_focus_locked(lg, target);
+    }
+    apply_scene_changes();
 }
 
 void mi::SurfaceInputDispatcher::clear_focus()
 {
-    std::lock_guard<std::mutex> lg(dispatcher_mutex);
-    set_focus_locked(lg, nullptr);
+    {
+        std::lock_guard<std::mutex> lg(dispatcher_mutex);
+        apply_scene_changes_locked();
+        set_focus_locked(lg, nullptr);
+    }
+    apply_scene_changes();
 }
 
 void mir::input::SurfaceInputDispatcher::set_drag_and_drop_handle(std::vector<uint8_t> const& handle)
 {
-    std::lock_guard<std::mutex> lg(dispatcher_mutex);
-    drag_and_drop_handle = handle;
+    {
+        std::lock_guard<std::mutex> lg(dispatcher_mutex);
+        apply_scene_changes_locked();
+        drag_and_drop_handle = handle;
+    }
+    apply_scene_changes();
 }
 
 void mir::input::SurfaceInputDispatcher::clear_drag_and_drop_handle()
 {
-    std::lock_guard<std::mutex> lg(dispatcher_mutex);
-    drag_and_drop_handle.clear();
+    {
+        std::lock_guard<std::mutex> lg(dispatcher_mutex);
+        apply_scene_changes_locked();
+        drag_and_drop_handle.clear();
+    }
+    apply_scene_changes();
 }
 
@@ -23,10 +23,13 @@
 #include "mir/shell/input_targeter.h"
 #include "mir/geometry/point.h"
 
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <mutex>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 namespace mir
 {
@@ -71,10 +74,22 @@ private:
 
     void set_focus_locked(std::lock_guard<std::mutex> const&, std::shared_ptr<input::Surface> const&);
 
-    void surface_removed(std::shared_ptr<scene::Surface> surface);
+    // Scene changes come from the shell. Rather than wait for dispatch they
+    // are queued, and applied by whichever thread holds dispatcher_mutex next
+    struct SceneChange
+    {
+        enum { removed, moved, resized } what;
+        std::shared_ptr<scene::Surface> removed_surface;
+        scene::Surface const* moved_surface;
+    };
 
-    void surface_moved(scene::Surface const* moved_surface);
-    void surface_resized();
+    void queue_scene_change(SceneChange&& change);
+    void apply_scene_changes();
+    void apply_scene_changes_locked();
+
+    void surface_removed_locked(std::shared_ptr<scene::Surface> const& surface);
+    void surface_moved_locked(scene::Surface const* moved_surface);
+    void surface_resized_locked();
 
     // Look in to homognizing index on KeyInputState and PointerInputState (wrt to device id)
     struct PointerInputState
@@ -96,6 +111,11 @@ private:
 
     std::shared_ptr<scene::Observer> scene_observer;
 
+    std::mutex scene_changes_mutex;
+    std::vector<SceneChange> scene_changes;
+    std::atomic<uint64_t> scene_epoch{0};     // Bumped for each queued scene change
+    std::atomic<uint64_t> applied_epoch{0};
+
     std::mutex dispatcher_mutex;
     std::shared_ptr<MirEvent const> last_pointer_event;
     std::weak_ptr<input::Surface> focus_surface;
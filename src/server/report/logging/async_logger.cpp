@@ -0,0 +1,212 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "async_logger.h"
+#include "mir/thread_name.h"
+
+#include <chrono>
+#include <cstdint>
+
+namespace ml = mir::logging;
+namespace mrl = mir::report::logging;
+
+namespace
+{
+// Both powers of two
+size_t const ring_size = 1024;
+size_t const rate_limit_buckets = 256;
+
+auto message_key(ml::Severity severity, std::string const& message, std::string const& component) -> size_t
+{
+    /*
+     * We don't know which call site a message came from, but messages from
+     * the same call site usually only differ in the numbers in them.
+     */
+    uint32_t hash = 2166136261u ^ static_cast<uint32_t>(severity);
+    auto const mix = [&hash](char c) { hash = (hash ^ static_cast<unsigned char>(c)) * 16777619u; };
+
+    for (auto c : component)
+        mix(c);
+    for (auto c : message)
+        if (c < '0' || c > '9')
+            mix(c);
+
+    return hash & (rate_limit_buckets - 1);
+}
+}
+
+struct mrl::AsyncLogger::Entry
+{
+    // Strings are kept in the ring, so after a while logging doesn't allocate
+    std::atomic<size_t> sequence;
+    ml::Severity severity;
+    std::string message;
+    std::string component;
+};
+
+struct mrl::AsyncLogger::RateLimit
+{
+    std::atomic<long> second{0};
+    std::atomic<unsigned> count{0};
+    std::atomic<unsigned> suppressed{0};
+};
+
+mrl::AsyncLogger::AsyncLogger(std::shared_ptr<ml::Logger> const& sink, unsigned max_per_second)
+    : sink{sink},
+      max_per_second{max_per_second},
+      entries{new Entry[ring_size]},
+      rate_limits{new RateLimit[rate_limit_buckets]}
+{
+    for (size_t i = 0; i != ring_size; ++i)
+        entries[i].sequence = i;
+
+    writer = std::thread{[this] { write_queued(); }};
+}
+
+mrl::AsyncLogger::~AsyncLogger()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+    wakeup.notify_one();
+    writer.join();
+}
+
+void mrl::AsyncLogger::log(ml::Severity severity, std::string const& message, std::string const& component)
+{
+    unsigned suppressed = 0;
+    if (rate_limited(severity, message, component, suppressed))
+        return;
+
+    // A bounded multi-producer queue, after Dmitry Vyukov's
+    auto position = enqueue_position.load(std::memory_order_relaxed);
+    Entry* entry;
+    for (;;)
+    {
+        entry = &entries[position & (ring_size - 1)];
+        auto const sequence = entry->sequence.load(std::memory_order_acquire);
+        auto const difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+
+        if (difference == 0)
+        {
+            if (enqueue_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                break;
+        }
+        else if (difference < 0)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        else
+        {
+            position = enqueue_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    entry->severity = severity;
+    entry->message = message;
+    entry->component = component;
+    if (suppressed)
+        entry->message += " (and " + std::to_string(suppressed) + " more like it not logged)";
+    entry->sequence.store(position + 1, std::memory_order_release);
+
+    // Only bother the writer if it has run out of things to write
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (writer_waiting.exchange(false))
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        wakeup.notify_one();
+    }
+}
+
+bool mrl::AsyncLogger::rate_limited(
+    ml::Severity severity, std::string const& message, std::string const& component, unsigned& suppressed)
+{
+    if (max_per_second == 0 || severity == ml::Severity::critical)
+        return false;
+
+    auto& limit = rate_limits[message_key(severity, message, component)];
+    long const now = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+
+    // Close enough: racing loggers may let through a few more than the limit
+    auto second = limit.second.load(std::memory_order_relaxed);
+    if (second != now && limit.second.compare_exchange_strong(second, now, std::memory_order_relaxed))
+        limit.count.store(0, std::memory_order_relaxed);
+
+    if (limit.count.fetch_add(1, std::memory_order_relaxed) < max_per_second)
+    {
+        suppressed = limit.suppressed.exchange(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    limit.suppressed.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool mrl::AsyncLogger::queue_empty() const
+{
+    auto const& entry = entries[dequeue_position & (ring_size - 1)];
+    return entry.sequence.load(std::memory_order_acquire) != dequeue_position + 1;
+}
+
+bool mrl::AsyncLogger::write_next()
+{
+    if (queue_empty())
+        return false;
+
+    auto& entry = entries[dequeue_position & (ring_size - 1)];
+    sink->log(entry.severity, entry.message, entry.component);
+    entry.sequence.store(dequeue_position + ring_size, std::memory_order_release);
+    ++dequeue_position;
+
+    return true;
+}
+
+void mrl::AsyncLogger::write_queued()
+{
+    mir::set_thread_name("Mir/Log");
+
+    for (;;)
+    {
+        while (write_next())
+            ;
+
+        if (auto const lost = dropped.exchange(0, std::memory_order_relaxed))
+        {
+            sink->log(
+                ml::Severity::warning,
+                std::to_string(lost) + " messages were not logged: they came in faster than they could be written",
+                "Logging");
+        }
+
+        std::unique_lock<std::mutex> lock{mutex};
+        if (stopping)
+        {
+            // Anything logged while we were reporting drops
+            while (write_next())
+                ;
+            return;
+        }
+
+        writer_waiting = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (queue_empty())
+            wakeup.wait(lock, [this] { return !writer_waiting || stopping; });
+        writer_waiting = false;
+    }
+}
@@ -0,0 +1,82 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_LOGGING_ASYNC_LOGGER_H_
+#define MIR_REPORT_LOGGING_ASYNC_LOGGER_H_
+
+#include "mir/logging/logger.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+namespace mir
+{
+namespace report
+{
+namespace logging
+{
+/**
+ * Passes messages on to another Logger from a thread of its own, so that
+ * whoever logs never waits for the output.
+ *
+ * Logging doesn't take a lock: messages go into a fixed size ring, and if
+ * that is full they are dropped and counted rather than waiting for room.
+ * Any one message (ignoring the numbers in it) is passed on at most
+ * max_per_second times a second; the rest are counted and the count noted
+ * on the next one let through.
+ */
+class AsyncLogger : public mir::logging::Logger
+{
+public:
+    AsyncLogger(std::shared_ptr<mir::logging::Logger> const& sink, unsigned max_per_second);
+    ~AsyncLogger();
+
+    void log(mir::logging::Severity severity, std::string const& message, std::string const& component) override;
+
+private:
+    struct Entry;
+    struct RateLimit;
+
+    bool rate_limited(mir::logging::Severity severity, std::string const& message, std::string const& component,
+                      unsigned& suppressed);
+    bool queue_empty() const;
+    bool write_next();
+    void write_queued();
+
+    std::shared_ptr<mir::logging::Logger> const sink;
+    unsigned const max_per_second;
+
+    std::unique_ptr<Entry[]> const entries;
+    std::atomic<size_t> enqueue_position{0};
+    size_t dequeue_position{0};
+    std::atomic<unsigned long> dropped{0};
+
+    std::unique_ptr<RateLimit[]> const rate_limits;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    std::atomic<bool> writer_waiting{false};
+    bool stopping{false};
+    std::thread writer;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_LOGGING_ASYNC_LOGGER_H_ */
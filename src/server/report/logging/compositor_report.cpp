@@ -27,6 +27,11 @@ namespace
 {
     const char * const component = "compositor";
     const auto min_report_interval = std::chrono::seconds(1);
+
+    uint64_t microseconds(Timestamp::duration duration)
+    {
+        return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+    }
 }
 
 mrl::CompositorReport::CompositorReport(
@@ -62,15 +67,21 @@ void mrl::CompositorReport::began_frame(SubCompositorId id)
     inst.bypassed = true;
 }
 
-void mrl::CompositorReport::renderables_in_frame(SubCompositorId, mir::graphics::RenderableList const&)
+void mrl::CompositorReport::renderables_in_frame(SubCompositorId id, mir::graphics::RenderableList const& renderables)
 {
+    std::lock_guard<std::mutex> lock(mutex);
+    instance[id].renderables.record(renderables.size());
 }
 
 void mrl::CompositorReport::rendered_frame(SubCompositorId id)
 {
     std::lock_guard<std::mutex> lock(mutex);
     auto& inst = instance[id];
-    inst.render_time_sum += now() - inst.start_of_frame;
+
+    auto t = now();
+    inst.render_time_sum += t - inst.start_of_frame;
+    inst.render_time.record(microseconds(t - inst.start_of_frame));
+    inst.end_of_render = t;
     inst.bypassed = false;
 }
 
@@ -122,6 +133,37 @@ void mrl::CompositorReport::Instance::log(ml::Logger& logger, SubCompositorId id
                  bypass_percent
                  );
 
+        if (refresh_interval.count())
+        {
+            long long const interval_usec = refresh_interval.count() / 1000;
+            long long const render_usec = predicted_render_time.count() / 1000;
+
+            char prediction[128];
+            snprintf(prediction, sizeof prediction, "Display %p predicted "
+                     "vblank every %lld.%03lld ms, "
+                     "render time %lld.%03lld ms",
+                     id,
+                     interval_usec / 1000,
+                     interval_usec % 1000,
+                     render_usec / 1000,
+                     render_usec % 1000);
+
+            logger.log(ml::Severity::informational, prediction, component);
+        }
+
+        char display[32];
+        snprintf(display, sizeof display, "Display %p timings ", id);
+        logger.log(ml::Severity::informational,
+                   display +
+                   std::string{"{\"frames\":"} + std::to_string(nframes) +
+                   ",\"bypassed\":" + std::to_string(nbypassed) +
+                   ",\"frame_time_us\":" + frame_time.to_json() +
+                   ",\"render_time_us\":" + render_time.to_json() +
+                   ",\"post_time_us\":" + post_time.to_json() +
+                   ",\"renderables\":" + renderables.to_json() +
+                   ",\"copied_bytes\":" + copied_bytes.to_json() + "}",
+                   component);
+
         logger.log(ml::Severity::informational, msg, component);
     }
 
@@ -138,6 +180,9 @@ void mrl::CompositorReport::finished_frame(SubCompositorId id)
     auto& inst = instance[id];
 
     auto t = now();
+    if (inst.end_of_frame > TimePoint())
+        inst.frame_time.record(microseconds(t - inst.end_of_frame));
+    inst.post_time.record(microseconds(t - (inst.bypassed ? inst.start_of_frame : inst.end_of_render)));
     inst.total_time_sum += t - inst.end_of_frame;
     inst.end_of_frame = t;
     inst.nframes++;
@@ -179,6 +224,24 @@ void mrl::CompositorReport::stopped()
     instance.clear();
 }
 
+void mrl::CompositorReport::predicted_frame(
+    SubCompositorId id,
+    std::chrono::steady_clock::time_point,
+    std::chrono::nanoseconds refresh_interval,
+    std::chrono::nanoseconds render_time)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& inst = instance[id];
+    inst.refresh_interval = refresh_interval;
+    inst.predicted_render_time = render_time;
+}
+
+void mrl::CompositorReport::copied_bytes(SubCompositorId id, size_t bytes)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    instance[id].copied_bytes.record(bytes);
+}
+
 void mrl::CompositorReport::scheduled()
 {
     std::lock_guard<std::mutex> lock(mutex);
@@ -21,6 +21,7 @@
 
 #include "mir/compositor/compositor_report.h"
 #include "mir/time/clock.h"
+#include "histogram.h"
 #include <memory>
 #include <mutex>
 #include <unordered_map>
@@ -50,6 +51,12 @@ public:
     void started() override;
     void stopped() override;
     void scheduled() override;
+    void predicted_frame(
+        SubCompositorId id,
+        std::chrono::steady_clock::time_point vblank,
+        std::chrono::nanoseconds refresh_interval,
+        std::chrono::nanoseconds render_time) override;
+    void copied_bytes(SubCompositorId id, size_t bytes) override;
 
 private:
     std::shared_ptr<mir::logging::Logger> const logger;
@@ -61,6 +68,7 @@ private:
     struct Instance
     {
         TimePoint start_of_frame;
+        TimePoint end_of_render;
         TimePoint end_of_frame;
         TimePoint total_time_sum;
         TimePoint render_time_sum;
@@ -69,6 +77,8 @@ private:
         long nbypassed = 0;
         bool bypassed = true;
         bool prev_bypassed = false;
+        std::chrono::nanoseconds refresh_interval{0};
+        std::chrono::nanoseconds predicted_render_time{0};
 
         TimePoint last_reported_total_time_sum;
         TimePoint last_reported_render_time_sum;
@@ -76,6 +86,13 @@ private:
         long last_reported_nframes = 0;
         long last_reported_bypassed = 0;
 
+        // Since the compositor started, in microseconds
+        Histogram frame_time;
+        Histogram render_time;
+        Histogram post_time;    ///< From rendering (or bypass) to the frame being posted
+        Histogram renderables;
+        Histogram copied_bytes; ///< Of client pixels, in each rendered frame
+
         void log(mir::logging::Logger& logger, SubCompositorId id);
     };
 
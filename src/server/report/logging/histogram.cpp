@@ -0,0 +1,110 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "histogram.h"
+
+#include <cmath>
+
+namespace mrl = mir::report::logging;
+
+namespace
+{
+unsigned const sub_buckets = 16;
+unsigned const sub_bucket_bits = 4;
+
+unsigned bucket_of(uint64_t value)
+{
+    if (value < sub_buckets)
+        return value;
+
+    // Which power of two, then which sixteenth of it
+    unsigned const magnitude = 63 - __builtin_clzll(value);
+    return (magnitude - sub_bucket_bits + 1) * sub_buckets +
+           (value >> (magnitude - sub_bucket_bits)) - sub_buckets;
+}
+
+uint64_t highest_in_bucket(unsigned bucket)
+{
+    if (bucket < sub_buckets)
+        return bucket;
+
+    unsigned const magnitude = bucket / sub_buckets + sub_bucket_bits - 1;
+    uint64_t const sub_bucket = bucket % sub_buckets + sub_buckets;
+    return ((sub_bucket + 1) << (magnitude - sub_bucket_bits)) - 1;
+}
+}
+
+mrl::Histogram::Histogram()
+{
+    reset();
+}
+
+void mrl::Histogram::record(uint64_t value)
+{
+    auto const bucket = bucket_of(value);
+    buckets[bucket < bucket_count ? bucket : bucket_count - 1].fetch_add(1, std::memory_order_relaxed);
+    total.fetch_add(1, std::memory_order_relaxed);
+
+    auto seen = largest.load(std::memory_order_relaxed);
+    while (value > seen && !largest.compare_exchange_weak(seen, value, std::memory_order_relaxed))
+        ;
+}
+
+void mrl::Histogram::reset()
+{
+    for (auto& bucket : buckets)
+        bucket.store(0, std::memory_order_relaxed);
+    total.store(0, std::memory_order_relaxed);
+    largest.store(0, std::memory_order_relaxed);
+}
+
+uint64_t mrl::Histogram::count() const
+{
+    return total.load(std::memory_order_relaxed);
+}
+
+uint64_t mrl::Histogram::percentile(double percent) const
+{
+    auto const wanted = static_cast<uint64_t>(std::ceil(count() * percent / 100.0));
+    auto const most = max();
+
+    uint64_t seen = 0;
+    for (unsigned i = 0; i != bucket_count; ++i)
+    {
+        seen += buckets[i].load(std::memory_order_relaxed);
+        if (seen > 0 && seen >= wanted)
+        {
+            auto const highest = highest_in_bucket(i);
+            return highest < most ? highest : most;
+        }
+    }
+
+    return most;
+}
+
+uint64_t mrl::Histogram::max() const
+{
+    return largest.load(std::memory_order_relaxed);
+}
+
+std::string mrl::Histogram::to_json() const
+{
+    return "{\"count\":" + std::to_string(count()) +
+           ",\"p50\":" + std::to_string(percentile(50)) +
+           ",\"p90\":" + std::to_string(percentile(90)) +
+           ",\"p99\":" + std::to_string(percentile(99)) +
+           ",\"max\":" + std::to_string(max()) + "}";
+}
@@ -0,0 +1,63 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_REPORT_LOGGING_HISTOGRAM_H_
+#define MIR_REPORT_LOGGING_HISTOGRAM_H_
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace mir
+{
+namespace report
+{
+namespace logging
+{
+/**
+ * Counts how often values of each size are seen, to within about 6% (as
+ * in HdrHistogram: each power of two is split into 16 equal buckets).
+ * Recording never takes a lock, so it can be done from any thread.
+ */
+class Histogram
+{
+public:
+    Histogram();
+
+    void record(uint64_t value);
+    void reset();
+
+    uint64_t count() const;
+    /// The value that the given percentage of recorded values are no greater than
+    uint64_t percentile(double percent) const;
+    uint64_t max() const;
+
+    /// {"count":..., "p50":..., "p90":..., "p99":..., "max":...}
+    std::string to_json() const;
+
+private:
+    static unsigned const bucket_count = 16 * 40;   ///< Up to 2^40
+
+    std::array<std::atomic<uint64_t>, bucket_count> buckets;
+    std::atomic<uint64_t> total;
+    std::atomic<uint64_t> largest;
+};
+}
+}
+}
+
+#endif /* MIR_REPORT_LOGGING_HISTOGRAM_H_ */
@@ -162,3 +162,10 @@ void mrl::MessageProcessorReport::exception_handled(void const* mediator, std::e
     if (pm != mediators.end())
         mediators.erase(mediator);
 }
+
+void mrl::MessageProcessorReport::send_queue_depth(void const* connection, size_t depth)
+{
+    std::ostringstream out;
+    out << "connection=" << connection << ", messages waiting for the client=" << depth;
+    log->log(ml::Severity::informational, out.str(), component);
+}
@@ -72,6 +72,8 @@ public:
 
     void exception_handled(void const* mediator, std::exception const& error);
 
+    void send_queue_depth(void const* connection, size_t depth);
+
     ~MessageProcessorReport() noexcept(true);
 
 private:
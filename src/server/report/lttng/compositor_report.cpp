@@ -62,3 +62,21 @@ void mir::report::lttng::CompositorReport::finished_frame(SubCompositorId id)
 {
     mir_tracepoint(mir_server_compositor, finished_frame, id);
 }
+
+void mir::report::lttng::CompositorReport::predicted_frame(
+    SubCompositorId id,
+    std::chrono::steady_clock::time_point vblank,
+    std::chrono::nanoseconds refresh_interval,
+    std::chrono::nanoseconds render_time)
+{
+    mir_tracepoint(
+        mir_server_compositor, predicted_frame, id,
+        std::chrono::duration_cast<std::chrono::nanoseconds>(vblank.time_since_epoch()).count(),
+        refresh_interval.count(),
+        render_time.count());
+}
+
+void mir::report::lttng::CompositorReport::copied_bytes(SubCompositorId id, size_t bytes)
+{
+    mir_tracepoint(mir_server_compositor, copied_bytes, id, bytes);
+}
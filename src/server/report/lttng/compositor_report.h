@@ -43,6 +43,12 @@ public:
     void started() override;
     void stopped() override;
     void scheduled() override;
+    void predicted_frame(
+        SubCompositorId id,
+        std::chrono::steady_clock::time_point vblank,
+        std::chrono::nanoseconds refresh_interval,
+        std::chrono::nanoseconds render_time) override;
+    void copied_bytes(SubCompositorId id, size_t bytes) override;
 private:
     ServerTracepointProvider tp_provider;
 };
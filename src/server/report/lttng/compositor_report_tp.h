@@ -90,6 +90,28 @@ TRACEPOINT_EVENT(
     )
 )
 
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    predicted_frame,
+    TP_ARGS(void const*, id, int64_t, vblank_ns, int64_t, refresh_interval_ns, int64_t, render_time_ns),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(int64_t, vblank_ns, vblank_ns)
+        ctf_integer(int64_t, refresh_interval_ns, refresh_interval_ns)
+        ctf_integer(int64_t, render_time_ns, render_time_ns)
+    )
+)
+
+TRACEPOINT_EVENT(
+    mir_server_compositor,
+    copied_bytes,
+    TP_ARGS(void const*, id, uint64_t, bytes),
+    TP_FIELDS(
+        ctf_integer_hex(uintptr_t, id, (uintptr_t)(id))
+        ctf_integer(uint64_t, bytes, bytes)
+    )
+)
+
 #endif /* MIR_LTTNG_COMPOSITOR_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
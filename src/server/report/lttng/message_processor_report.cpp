@@ -53,3 +53,9 @@ void mir::report::lttng::MessageProcessorReport::exception_handled(
 {
     mir_tracepoint(mir_server_msgproc, exception_handled_wo_invocation, mediator, error.what());
 }
+
+void mir::report::lttng::MessageProcessorReport::send_queue_depth(
+    void const* connection, size_t depth)
+{
+    mir_tracepoint(mir_server_msgproc, send_queue_depth, connection, depth);
+}
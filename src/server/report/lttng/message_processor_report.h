@@ -38,6 +38,7 @@ public:
     void unknown_method(void const* mediator, int id, std::string const& method);
     void exception_handled(void const* mediator, int id, std::exception const& error);
     void exception_handled(void const* mediator, std::exception const& error);
+    void send_queue_depth(void const* connection, size_t depth);
 
 private:
     ServerTracepointProvider tp_provider;
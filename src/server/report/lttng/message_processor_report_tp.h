@@ -85,6 +85,16 @@ TRACEPOINT_EVENT(
         )
     )
 
+TRACEPOINT_EVENT(
+    mir_server_msgproc,
+    send_queue_depth,
+    TP_ARGS(const void*, connection, size_t, depth),
+    TP_FIELDS(
+        ctf_integer_hex(void*, connection, connection)
+        ctf_integer(size_t, depth, depth)
+        )
+    )
+
 #endif /* MIR_LTTNG_MESSAGE_PROCESSOR_REPORT_TP_H_ */
 
 #include <lttng/tracepoint-event.h>
@@ -51,3 +51,15 @@ void mrn::CompositorReport::stopped()
 void mrn::CompositorReport::scheduled()
 {
 }
+
+void mrn::CompositorReport::predicted_frame(
+    SubCompositorId,
+    std::chrono::steady_clock::time_point,
+    std::chrono::nanoseconds,
+    std::chrono::nanoseconds)
+{
+}
+
+void mrn::CompositorReport::copied_bytes(SubCompositorId, size_t)
+{
+}
@@ -39,3 +39,7 @@ void mrn::MessageProcessorReport::exception_handled(void const*, int, std::excep
 void mrn::MessageProcessorReport::exception_handled(void const*, std::exception const&)
 {
 }
+
+void mrn::MessageProcessorReport::send_queue_depth(void const*, size_t)
+{
+}
@@ -38,6 +38,8 @@ class MessageProcessorReport : public frontend::MessageProcessorReport
     void exception_handled(void const*, int, std::exception const&);
 
     void exception_handled(void const*, std::exception const&);
+
+    void send_queue_depth(void const*, size_t);
 };
 }
 }
@@ -159,6 +159,12 @@ void ms::SurfaceObservers::depth_layer_set_to(Surface const* surf, MirDepthLayer
                  { observer->depth_layer_set_to(surf, depth_layer); });
 }
 
+void ms::SurfaceObservers::input_region_set_to(Surface const* surf, std::vector<geometry::Rectangle> const& region)
+{
+    for_each([&](std::shared_ptr<SurfaceObserver> const& observer)
+                 { observer->input_region_set_to(surf, region); });
+}
+
 struct ms::CursorStreamImageAdapter
 {
     CursorStreamImageAdapter(ms::BasicSurface &surface)
@@ -327,8 +333,13 @@ std::shared_ptr<mf::BufferStream> ms::BasicSurface::primary_buffer_stream() cons
 
 void ms::BasicSurface::set_input_region(std::vector<geom::Rectangle> const& input_rectangles)
 {
-    std::unique_lock<std::mutex> lock(guard);
-    custom_input_rectangles = input_rectangles;
+    {
+        std::unique_lock<std::mutex> lock(guard);
+        if (custom_input_rectangles == input_rectangles)
+            return;
+        custom_input_rectangles = input_rectangles;
+    }
+    observers.input_region_set_to(this, input_rectangles);
 }
 
 void ms::BasicSurface::resize(geom::Size const& desired_size)
@@ -56,12 +56,12 @@ public:
 
 private:
     void prepare();
-    void copy_and_convert_pixel_line(char* src, char* dst);
 
     std::unique_ptr<renderer::gl::Context> const gl_context;
     GLuint tex;
     GLuint fbo;
-    std::vector<char> pixels;
+    std::vector<char> pixels;       ///< As read, bottom line first
+    std::vector<char> argb_pixels;  ///< As returned by as_argb_8888()
     GLuint gl_pixel_format;
     bool pixels_need_y_flip;
     geometry::Size size_;
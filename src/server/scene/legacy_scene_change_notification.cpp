@@ -155,6 +155,14 @@ void ms::LegacySceneChangeNotification::scene_changed()
     scene_notify_change();
 }
 
+void ms::LegacySceneChangeNotification::scene_damaged(geometry::Rectangle const& damage)
+{
+    if (damage_notify_change)
+        damage_notify_change(1, damage);
+    else
+        scene_notify_change();
+}
+
 void ms::LegacySceneChangeNotification::end_observation()
 {
     std::unique_lock<decltype(surface_observers_guard)> lg(surface_observers_guard);
@@ -0,0 +1,288 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "surface_grid.h"
+#include "mir/scene/surface.h"
+#include "mir/geometry/rectangles.h"
+
+#include <algorithm>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+
+namespace
+{
+int const cell_size = 256;
+
+// Enough for a 4K output; anything bigger is checked for every lookup instead
+int const max_cells_per_surface = 256;
+
+int cell_of(int coordinate)
+{
+    // Round towards minus infinity, so that negative coordinates get their own cells
+    return coordinate >= 0 ? coordinate / cell_size : -((-coordinate - 1) / cell_size) - 1;
+}
+
+struct CellRange
+{
+    int left, top, right, bottom;   // inclusive
+    bool oversized;
+};
+
+CellRange cells_covering(geom::Rectangle const& bounds)
+{
+    CellRange range{
+        cell_of(bounds.left().as_int()),
+        cell_of(bounds.top().as_int()),
+        cell_of(bounds.right().as_int() - 1),
+        cell_of(bounds.bottom().as_int() - 1),
+        false};
+
+    range.oversized =
+        static_cast<long long>(range.right - range.left + 1) * (range.bottom - range.top + 1) > max_cells_per_surface;
+    return range;
+}
+
+bool is_empty(geom::Rectangle const& bounds)
+{
+    return bounds.size.width.as_int() <= 0 || bounds.size.height.as_int() <= 0;
+}
+
+geom::Rectangle input_area_bounds(geom::Rectangle const& rect, std::vector<geom::Rectangle> const& region)
+{
+    if (region.empty())
+        return rect;
+
+    geom::Rectangles area;
+    for (auto const& r : region)
+    {
+        if (!is_empty(r))
+            area.add({r.top_left + (rect.top_left - geom::Point{}), r.size});
+    }
+    return area.bounding_rectangle();
+}
+
+template<typename List, typename Entry>
+void insert_in_stacking_order(List& list, Entry* entry)
+{
+    auto const p = std::find_if(list.begin(), list.end(),
+        [entry](Entry const* e) { return e->position < entry->position; });
+    list.insert(p, entry);
+}
+
+/**
+ * The elements of \a keys that are not in the longest increasing
+ * subsequence: the fewest that need moving to put \a keys in order.
+ */
+std::vector<bool> out_of_order(std::vector<size_t> const& keys)
+{
+    std::vector<size_t> tails;                      // Indices ending the best run of each length
+    std::vector<size_t> previous(keys.size());
+
+    for (size_t i = 0; i != keys.size(); ++i)
+    {
+        auto const length = std::lower_bound(tails.begin(), tails.end(), keys[i],
+            [&keys](size_t tail, size_t key) { return keys[tail] < key; }) - tails.begin();
+
+        previous[i] = length ? tails[length - 1] : keys.size();
+        if (static_cast<size_t>(length) == tails.size())
+            tails.push_back(i);
+        else
+            tails[length] = i;
+    }
+
+    std::vector<bool> moved(keys.size(), true);
+    for (auto i = tails.empty() ? keys.size() : tails.back(); i != keys.size(); i = previous[i])
+        moved[i] = false;
+    return moved;
+}
+}
+
+size_t ms::SurfaceGrid::CellHash::operator()(Cell const& cell) const
+{
+    return std::hash<long long>{}((static_cast<long long>(cell.x) << 32) ^ static_cast<unsigned>(cell.y));
+}
+
+ms::SurfaceGrid::SurfaceGrid() = default;
+ms::SurfaceGrid::~SurfaceGrid() = default;
+
+void ms::SurfaceGrid::add(std::shared_ptr<Surface> const& surface, geom::Rectangle const& bounds)
+{
+    auto const position = entries.size();
+    auto const result = entries.emplace(surface.get(), Entry{surface, bounds, {}, bounds, position, position});
+    if (result.second)
+        insert(&result.first->second);
+    else
+        update(surface.get(), bounds);
+}
+
+void ms::SurfaceGrid::remove(Surface const* surface)
+{
+    auto const p = entries.find(surface);
+    if (p == entries.end())
+        return;
+
+    erase(&p->second);
+    entries.erase(p);
+}
+
+void ms::SurfaceGrid::update(Surface const* surface, geom::Rectangle const& bounds)
+{
+    auto const p = entries.find(surface);
+    if (p == entries.end() || p->second.rect == bounds)
+        return;
+
+    p->second.rect = bounds;
+    rebound(&p->second);
+}
+
+void ms::SurfaceGrid::set_input_region(Surface const* surface, std::vector<geom::Rectangle> const& region)
+{
+    auto const p = entries.find(surface);
+    if (p == entries.end() || p->second.input_region == region)
+        return;
+
+    p->second.input_region = region;
+    rebound(&p->second);
+}
+
+void ms::SurfaceGrid::set_position(Surface const* surface, size_t position)
+{
+    auto const p = entries.find(surface);
+    if (p != entries.end())
+        p->second.next_position = position;
+}
+
+void ms::SurfaceGrid::restacked()
+{
+    /*
+     * Raising a surface renumbers everything above it, but only changes the
+     * order of the raised surface relative to the rest. So only the surfaces
+     * whose order changed are taken out of their cells and put back.
+     */
+    std::vector<Entry*> stacking;
+    stacking.reserve(entries.size());
+    for (auto& entry : entries)
+        stacking.push_back(&entry.second);
+    std::sort(stacking.begin(), stacking.end(),
+        [](Entry const* a, Entry const* b) { return a->position < b->position; });
+
+    std::vector<size_t> next_positions;
+    next_positions.reserve(stacking.size());
+    for (auto const entry : stacking)
+        next_positions.push_back(entry->next_position);
+
+    auto const moved = out_of_order(next_positions);
+
+    for (size_t i = 0; i != stacking.size(); ++i)
+    {
+        if (moved[i])
+            erase(stacking[i]);
+    }
+
+    for (auto const entry : stacking)
+        entry->position = entry->next_position;
+
+    for (size_t i = 0; i != stacking.size(); ++i)
+    {
+        if (moved[i])
+            insert(stacking[i]);
+    }
+}
+
+auto ms::SurfaceGrid::surface_at(geom::Point point) const -> std::shared_ptr<Surface>
+{
+    static EntryList const nothing;
+
+    auto const cell = cells.find({cell_of(point.x.as_int()), cell_of(point.y.as_int())});
+    auto const& local = cell != cells.end() ? cell->second : nothing;
+
+    // Both lists are topmost first, so merging them visits surfaces top down
+    auto l = local.begin();
+    auto o = oversized.begin();
+    while (l != local.end() || o != oversized.end())
+    {
+        Entry const* entry;
+        if (o == oversized.end() || (l != local.end() && (*l)->position > (*o)->position))
+            entry = *l++;
+        else
+            entry = *o++;
+
+        if (entry->bounds.contains(point) && entry->surface->input_area_contains(point))
+            return entry->surface;
+    }
+
+    return {};
+}
+
+void ms::SurfaceGrid::insert(Entry* entry)
+{
+    auto const& bounds = entry->bounds;
+    if (is_empty(bounds))
+        return;
+
+    auto const range = cells_covering(bounds);
+    if (range.oversized)
+    {
+        insert_in_stacking_order(oversized, entry);
+        return;
+    }
+
+    for (auto y = range.top; y <= range.bottom; ++y)
+    {
+        for (auto x = range.left; x <= range.right; ++x)
+            insert_in_stacking_order(cells[{x, y}], entry);
+    }
+}
+
+void ms::SurfaceGrid::rebound(Entry* entry)
+{
+    auto const bounds = input_area_bounds(entry->rect, entry->input_region);
+    if (bounds == entry->bounds)
+        return;
+
+    erase(entry);
+    entry->bounds = bounds;
+    insert(entry);
+}
+
+void ms::SurfaceGrid::erase(Entry* entry)
+{
+    oversized.erase(std::remove(oversized.begin(), oversized.end(), entry), oversized.end());
+
+    auto const& bounds = entry->bounds;
+    if (is_empty(bounds))
+        return;
+
+    auto const range = cells_covering(bounds);
+    if (range.oversized)
+        return;
+
+    for (auto y = range.top; y <= range.bottom; ++y)
+    {
+        for (auto x = range.left; x <= range.right; ++x)
+        {
+            auto const cell = cells.find({x, y});
+            if (cell == cells.end())
+                continue;
+
+            auto& list = cell->second;
+            list.erase(std::remove(list.begin(), list.end(), entry), list.end());
+            if (list.empty())
+                cells.erase(cell);
+        }
+    }
+}
@@ -0,0 +1,105 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify it
+ * under the terms of the GNU General Public License version 2 or 3,
+ * as published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef MIR_SCENE_SURFACE_GRID_H_
+#define MIR_SCENE_SURFACE_GRID_H_
+
+#include "mir/geometry/rectangle.h"
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace mir
+{
+namespace scene
+{
+class Surface;
+
+/**
+ * A uniform grid over the input areas of surfaces, so that finding the
+ * surface under a point only visits the surfaces near it.
+ *
+ * Surfaces are taken to accept input only within their input_bounds(), or
+ * within their input region when one has been set. The grid is not
+ * synchronized: callers serialize changes against lookups.
+ */
+class SurfaceGrid
+{
+public:
+    SurfaceGrid();
+    ~SurfaceGrid();
+
+    void add(std::shared_ptr<Surface> const& surface, geometry::Rectangle const& bounds);
+    void remove(Surface const* surface);
+    void update(Surface const* surface, geometry::Rectangle const& bounds);
+    /// As passed to Surface::set_input_region(), relative to the surface
+    void set_input_region(Surface const* surface, std::vector<geometry::Rectangle> const& region);
+
+    /**
+     * Sets where \a surface is in the stacking order (higher is nearer the
+     * top). Call restacked() once all positions are set.
+     */
+    void set_position(Surface const* surface, size_t position);
+    void restacked();
+
+    /// The topmost surface whose input area contains \a point
+    auto surface_at(geometry::Point point) const -> std::shared_ptr<Surface>;
+
+private:
+    SurfaceGrid(SurfaceGrid const&) = delete;
+    SurfaceGrid& operator=(SurfaceGrid const&) = delete;
+
+    struct Entry
+    {
+        std::shared_ptr<Surface> const surface;
+        geometry::Rectangle rect;
+        std::vector<geometry::Rectangle> input_region;
+        geometry::Rectangle bounds;     ///< Of the input area; what the cells are keyed on
+        size_t position;
+        size_t next_position;           ///< As set since the last restacked()
+    };
+
+    struct Cell
+    {
+        int x;
+        int y;
+        bool operator==(Cell const& other) const { return x == other.x && y == other.y; }
+    };
+
+    struct CellHash
+    {
+        size_t operator()(Cell const& cell) const;
+    };
+
+    // Each list is kept in stacking order, topmost first
+    using EntryList = std::vector<Entry*>;
+
+    void insert(Entry* entry);
+    void erase(Entry* entry);
+    void rebound(Entry* entry);
+
+    std::unordered_map<Surface const*, Entry> entries;
+    std::unordered_map<Cell, EntryList, CellHash> cells;
+
+    // Surfaces spanning too many cells to be worth adding to each of them
+    EntryList oversized;
+};
+
+}
+}
+
+#endif /* MIR_SCENE_SURFACE_GRID_H_ */
@@ -44,18 +44,91 @@ namespace geom = mir::geometry;
 namespace
 {
 
+/**
+ * Keeps the memory of objects freed on this thread for the next allocation.
+ * Compositors allocate and free about the same number of scene elements each
+ * frame, so after the first few frames this takes the heap off the hot path.
+ */
+template<typename T>
+class RecyclingAllocator
+{
+public:
+    using value_type = T;
+
+    RecyclingAllocator() = default;
+    template<typename U>
+    RecyclingAllocator(RecyclingAllocator<U> const&) {}
+
+    T* allocate(size_t n)
+    {
+        auto const free = free_blocks();
+        if (n == 1 && free && !free->blocks.empty())
+        {
+            auto const block = free->blocks.back();
+            free->blocks.pop_back();
+            return static_cast<T*>(block);
+        }
+        return static_cast<T*>(::operator new(n * sizeof(T)));
+    }
+
+    void deallocate(T* p, size_t n)
+    {
+        auto const free = free_blocks();
+        if (n == 1 && free && free->blocks.size() < max_free_blocks)
+            free->blocks.push_back(p);
+        else
+            ::operator delete(p);
+    }
+
+private:
+    static size_t const max_free_blocks = 256;
+
+    struct FreeBlocks
+    {
+        FreeBlocks() { blocks.reserve(max_free_blocks); }
+        ~FreeBlocks()
+        {
+            free_blocks_gone() = true;
+            for (auto const block : blocks) ::operator delete(block);
+        }
+
+        std::vector<void*> blocks;
+    };
+
+    // Elements can be freed while a thread exits, after its free list has gone
+    static bool& free_blocks_gone()
+    {
+        static thread_local bool gone{false};
+        return gone;
+    }
+
+    /// \returns this thread's free list, or null once that has been destroyed
+    static FreeBlocks* free_blocks()
+    {
+        if (free_blocks_gone())
+            return nullptr;
+
+        static thread_local FreeBlocks free;
+        return &free;
+    }
+};
+
+template<typename T, typename U>
+bool operator==(RecyclingAllocator<T> const&, RecyclingAllocator<U> const&) { return true; }
+
+template<typename T, typename U>
+bool operator!=(RecyclingAllocator<T> const&, RecyclingAllocator<U> const&) { return false; }
+
 class SurfaceSceneElement : public mc::SceneElement
 {
 public:
     SurfaceSceneElement(
-        std::string name,
         std::shared_ptr<mg::Renderable> const& renderable,
         std::shared_ptr<ms::RenderingTracker> const& tracker,
         mc::CompositorID id)
         : renderable_{renderable},
           tracker{tracker},
-          cid{id},
-          surface_name(name)
+          cid{id}
     {
     }
 
@@ -78,7 +151,6 @@ private:
     std::shared_ptr<mg::Renderable> const renderable_;
     std::shared_ptr<ms::RenderingTracker> const tracker;
     mc::CompositorID cid;
-    std::string const surface_name;
 };
 
 //note: something different than a 2D/HWC overlay
@@ -109,11 +181,11 @@ private:
 };
 
 /**
- * A SurfaceDepthLayerObserver must not outlive the SurfaceStack it was created for
+ * A SurfacePlacementObserver must not outlive the SurfaceStack it was created for
  */
-struct SurfaceDepthLayerObserver : ms::NullSurfaceObserver
+struct SurfacePlacementObserver : ms::NullSurfaceObserver
 {
-    SurfaceDepthLayerObserver(ms::SurfaceStack* stack)
+    SurfacePlacementObserver(ms::SurfaceStack* stack)
         : stack{stack}
     {
     }
@@ -124,17 +196,45 @@ struct SurfaceDepthLayerObserver : ms::NullSurfaceObserver
         stack->raise(surface);
     }
 
+    void moved_to(ms::Surface const* surface, geom::Point const& /*top_left*/) override
+    {
+        stack->input_bounds_changed(surface);
+    }
+
+    void resized_to(ms::Surface const* surface, geom::Size const& /*size*/) override
+    {
+        stack->input_bounds_changed(surface);
+    }
+
+    void input_region_set_to(ms::Surface const* surface, std::vector<geom::Rectangle> const& region) override
+    {
+        stack->input_region_changed(surface, region);
+    }
+
 private:
     ms::SurfaceStack* stack;
 };
 
 }
 
+struct ms::SurfaceStack::Snapshot
+{
+    struct Entry
+    {
+        std::shared_ptr<Surface> surface;
+        std::shared_ptr<RenderingTracker> tracker;
+    };
+
+    std::vector<Entry> surfaces;    ///< bottom to top
+    std::vector<std::shared_ptr<mg::Renderable>> overlays;
+};
+
 ms::SurfaceStack::SurfaceStack(
     std::shared_ptr<SceneReport> const& report) :
     report{report},
+    snapshot{std::make_shared<Snapshot>()},
     scene_changed{false},
-    surface_observer{std::make_shared<SurfaceDepthLayerObserver>(this)}
+    surface_observer{std::make_shared<SurfacePlacementObserver>(this)}
 {
 }
 
@@ -152,57 +252,51 @@ ms::SurfaceStack::~SurfaceStack() noexcept(true)
 
 mc::SceneElementSequence ms::SurfaceStack::scene_elements_for(mc::CompositorID id)
 {
-    RecursiveReadLock lg(guard);
+    auto const current = std::atomic_load(&snapshot);
 
     scene_changed = false;
     mc::SceneElementSequence elements;
-    for (auto const& layer : surface_layers)
+    elements.reserve(current->surfaces.size() + current->overlays.size());
+    for (auto const& entry : current->surfaces)
     {
-        for (auto const& surface : layer)
+        if (entry.surface->visible())
         {
-            if (surface->visible())
+            for (auto& renderable : entry.surface->generate_renderables(id))
             {
-                for (auto& renderable : surface->generate_renderables(id))
-                {
-                    elements.emplace_back(
-                        std::make_shared<SurfaceSceneElement>(
-                            surface->name(),
-                            renderable,
-                            rendering_trackers[surface.get()],
-                            id));
-                }
+                elements.emplace_back(
+                    std::allocate_shared<SurfaceSceneElement>(
+                        RecyclingAllocator<SurfaceSceneElement>{},
+                        renderable,
+                        entry.tracker,
+                        id));
             }
         }
     }
-    for (auto const& renderable : overlays)
+    for (auto const& renderable : current->overlays)
     {
-        elements.emplace_back(std::make_shared<OverlaySceneElement>(renderable));
+        elements.emplace_back(
+            std::allocate_shared<OverlaySceneElement>(
+                RecyclingAllocator<OverlaySceneElement>{},
+                renderable));
     }
     return elements;
 }
 
 int ms::SurfaceStack::frames_pending(mc::CompositorID id) const
 {
-    RecursiveReadLock lg(guard);
+    auto const current = std::atomic_load(&snapshot);
 
     int result = scene_changed ? 1 : 0;
-    for (auto const& layer : surface_layers)
+    for (auto const& entry : current->surfaces)
     {
-        for (auto const& surface : layer)
+        if (entry.surface->visible() && entry.tracker->is_exposed_in(id))
         {
-            if (surface->visible())
-            {
-                auto const tracker = rendering_trackers.find(surface.get());
-                if (tracker != rendering_trackers.end() && tracker->second->is_exposed_in(id))
-                {
-                    // Note that we ask the surface and not a Renderable.
-                    // This is because we don't want to waste time and resources
-                    // on a snapshot till we're sure we need it...
-                    int ready = surface->buffers_ready_for_compositor(id);
-                    if (ready > result)
-                        result = ready;
-                }
-            }
+            // Note that we ask the surface and not a Renderable.
+            // This is because we don't want to waste time and resources
+            // on a snapshot till we're sure we need it...
+            int ready = entry.surface->buffers_ready_for_compositor(id);
+            if (ready > result)
+                result = ready;
         }
     }
     return result;
@@ -232,6 +326,7 @@ void ms::SurfaceStack::add_input_visualization(
     {
         RecursiveWriteLock lg(guard);
         overlays.push_back(overlay);
+        publish_snapshot();
     }
     emit_scene_changed();
 }
@@ -248,6 +343,7 @@ void ms::SurfaceStack::remove_input_visualization(
             BOOST_THROW_EXCEPTION(std::runtime_error("Attempt to remove an overlay which was never added or which has been previously removed"));
         }
         overlays.erase(p);
+        publish_snapshot();
     }
     
     emit_scene_changed();
@@ -262,6 +358,11 @@ void ms::SurfaceStack::emit_scene_changed()
     observers.scene_changed();
 }
 
+void ms::SurfaceStack::emit_scene_damaged(geometry::Rectangle const& damage)
+{
+    observers.scene_damaged(damage);
+}
+
 void ms::SurfaceStack::add_surface(
     std::shared_ptr<Surface> const& surface,
     mi::InputReceptionMode input_mode)
@@ -270,7 +371,9 @@ void ms::SurfaceStack::add_surface(
         RecursiveWriteLock lg(guard);
         insert_surface_at_top_of_depth_layer(surface);
         create_rendering_tracker_for(surface);
+        input_grid.add(surface, surface->input_bounds());
         surface->add_observer(surface_observer);
+        publish_snapshot();
     }
     surface->set_reception_mode(input_mode);
     observers.surface_added(surface);
@@ -294,7 +397,9 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
             {
                 layer.erase(surface);
                 rendering_trackers.erase(keep_alive.get());
+                input_grid.remove(keep_alive.get());
                 keep_alive->remove_observer(surface_observer);
+                publish_snapshot();
                 found_surface = true;
                 break;
             }
@@ -309,37 +414,28 @@ void ms::SurfaceStack::remove_surface(std::weak_ptr<Surface> const& surface)
     // TODO: error logging when surface not found
 }
 
-namespace
+auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
+-> std::shared_ptr<Surface>
 {
-template <typename Container>
-struct InReverse {
-    Container& container;
-    auto begin() -> decltype(container.rbegin()) { return container.rbegin(); }
-    auto end() -> decltype(container.rend()) { return container.rend(); }
-};
+    RecursiveReadLock lg(guard);
+    return input_grid.surface_at(cursor);
+}
 
-template <typename Container>
-InReverse<Container> in_reverse(Container& container) { return InReverse<Container>{container}; }
+auto ms::SurfaceStack::input_surface_at(geometry::Point point) -> std::shared_ptr<mi::Surface>
+{
+    return surface_at(point);
 }
 
-auto ms::SurfaceStack::surface_at(geometry::Point cursor) const
--> std::shared_ptr<Surface>
+void ms::SurfaceStack::input_bounds_changed(Surface const* surface)
 {
-    RecursiveReadLock lg(guard);
-    for (auto const& layer : in_reverse(surface_layers))
-    {
-        for (auto const& surface : in_reverse(layer))
-        {
-            // TODO There's a lack of clarity about how the input area will
-            // TODO be maintained and whether this test will detect clicks on
-            // TODO decorations (it should) as these may be outside the area
-            // TODO known to the client.  But it works for now.
-            if (surface->input_area_contains(cursor))
-                    return surface;
-        }
-    }
+    RecursiveWriteLock lg(guard);
+    input_grid.update(surface, surface->input_bounds());
+}
 
-    return {};
+void ms::SurfaceStack::input_region_changed(Surface const* surface, std::vector<geometry::Rectangle> const& region)
+{
+    RecursiveWriteLock lg(guard);
+    input_grid.set_input_region(surface, region);
 }
 
 void ms::SurfaceStack::for_each(std::function<void(std::shared_ptr<mi::Surface> const&)> const& callback)
@@ -375,6 +471,7 @@ void ms::SurfaceStack::raise(Surface const* surface)
                 std::shared_ptr<Surface> surface_shared = *p;
                 layer.erase(p);
                 insert_surface_at_top_of_depth_layer(surface_shared);
+                publish_snapshot();
                 surfaces_reordered = true;
                 break;
             }
@@ -421,6 +518,9 @@ void ms::SurfaceStack::raise(SurfaceSet const& ss)
             if (old_layer != layer)
                 surfaces_reordered = true;
         }
+
+        if (surfaces_reordered)
+            publish_snapshot();
     }
 
     if (surfaces_reordered)
@@ -452,6 +552,24 @@ void ms::SurfaceStack::insert_surface_at_top_of_depth_layer(std::shared_ptr<Surf
     surface_layers[depth_index].push_back(surface);
 }
 
+void ms::SurfaceStack::publish_snapshot()
+{
+    auto const next = std::make_shared<Snapshot>();
+
+    for (auto const& layer : surface_layers)
+    {
+        for (auto const& surface : layer)
+        {
+            input_grid.set_position(surface.get(), next->surfaces.size());
+            next->surfaces.push_back({surface, rendering_trackers.at(surface.get())});
+        }
+    }
+    input_grid.restacked();
+    next->overlays = overlays;
+
+    std::atomic_store(&snapshot, std::shared_ptr<Snapshot const>{next});
+}
+
 void ms::SurfaceStack::add_observer(std::shared_ptr<ms::Observer> const& observer)
 {
     observers.add(observer);
@@ -502,6 +620,12 @@ void ms::Observers::scene_changed()
         { observer->scene_changed(); });
 }
 
+void ms::Observers::scene_damaged(geometry::Rectangle const& damage)
+{
+   for_each([&](std::shared_ptr<Observer> const& observer)
+        { observer->scene_damaged(damage); });
+}
+
 void ms::Observers::surface_exists(std::shared_ptr<Surface> const& surface)
 {
     for_each([&](std::shared_ptr<Observer> const& observer)
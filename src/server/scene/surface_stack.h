@@ -29,6 +29,8 @@
 #include "mir/basic_observers.h"
 #include "mir/scene/surface_observer.h"
 
+#include "surface_grid.h"
+
 #include <atomic>
 #include <map>
 #include <memory>
@@ -58,6 +60,7 @@ public:
    void surface_removed(std::shared_ptr<Surface> const& surface) override;
    void surfaces_reordered() override;
    void scene_changed() override;
+   void scene_damaged(geometry::Rectangle const& damage) override;
    void surface_exists(std::shared_ptr<Surface> const& surface) override;
    void end_observation() override;
 
@@ -80,10 +83,13 @@ public:
 
     // From Scene
     void for_each(std::function<void(std::shared_ptr<input::Surface> const&)> const& callback) override;
+    auto input_surface_at(geometry::Point point) -> std::shared_ptr<input::Surface> override;
 
     virtual void remove_surface(std::weak_ptr<Surface> const& surface) override;
 
     void raise(Surface const* surface);
+    void input_bounds_changed(Surface const* surface);
+    void input_region_changed(Surface const* surface, std::vector<geometry::Rectangle> const& region);
     virtual void raise(std::weak_ptr<Surface> const& surface) override;
     void raise(SurfaceSet const& surfaces) override;
 
@@ -101,6 +107,7 @@ public:
     void remove_input_visualization(std::weak_ptr<graphics::Renderable> const& overlay) override;
 
     void emit_scene_changed() override;
+    void emit_scene_damaged(geometry::Rectangle const& damage) override;
 
 private:
     SurfaceStack(const SurfaceStack&) = delete;
@@ -108,6 +115,7 @@ private:
     void create_rendering_tracker_for(std::shared_ptr<Surface> const&);
     void update_rendering_tracker_compositors();
     void insert_surface_at_top_of_depth_layer(std::shared_ptr<Surface> const& surface);
+    void publish_snapshot();
 
     RecursiveReadWriteMutex mutable guard;
 
@@ -126,6 +134,17 @@ private:
     
     std::vector<std::shared_ptr<graphics::Renderable>> overlays;
 
+    /// Where the surfaces are, for finding the one under the cursor
+    SurfaceGrid input_grid;
+
+    /**
+     * An immutable copy of the stack for the compositors, replaced (under
+     * the write lock) whenever surfaces or overlays are added, removed or
+     * reordered. Compositors load it atomically instead of taking the lock.
+     */
+    struct Snapshot;
+    std::shared_ptr<Snapshot const> snapshot;
+
     Observers observers;
     std::atomic<bool> scene_changed;
     std::shared_ptr<SurfaceObserver> surface_observer;
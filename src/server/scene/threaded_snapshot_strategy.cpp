@@ -21,9 +21,11 @@
 #include "mir/compositor/buffer_stream.h"
 #include "mir/thread_name.h"
 
+#include <algorithm>
 #include <deque>
 #include <mutex>
 #include <condition_variable>
+#include <vector>
 
 namespace geom = mir::geometry;
 namespace ms = mir::scene;
@@ -35,8 +37,8 @@ namespace scene
 
 struct WorkItem
 {
-    std::shared_ptr<compositor::BufferStream> const stream;
-    ms::SnapshotCallback const snapshot_taken;
+    std::shared_ptr<compositor::BufferStream> stream;
+    std::vector<ms::SnapshotCallback> snapshot_taken;
 };
 
 class SnapshottingFunctor
@@ -59,7 +61,7 @@ public:
 
             if (running)
             {
-                auto wi = work.front();
+                auto const wi = std::move(work.front());
                 work.pop_front();
 
                 lock.unlock();
@@ -77,17 +79,35 @@ public:
             pixels->fill_from(buffer);
         });
 
-        wi.snapshot_taken(
-            ms::Snapshot{pixels->size(),
-                     pixels->stride(),
-                     pixels->as_argb_8888()});
+        ms::Snapshot const snapshot{pixels->size(), pixels->stride(), pixels->as_argb_8888()};
+
+        for (auto const& snapshot_taken : wi.snapshot_taken)
+            snapshot_taken(snapshot);
     }
 
-    void schedule_snapshot(WorkItem const& wi)
+    void schedule_snapshot(
+        std::shared_ptr<compositor::BufferStream> const& stream,
+        ms::SnapshotCallback const& snapshot_taken)
     {
         std::lock_guard<std::mutex> lg{work_mutex};
-        work.push_back(wi);
-        work_cv.notify_one();
+
+        /*
+         * Anyone asking for a stream that is already waiting for a snapshot
+         * (a switcher asking again before the first one came back, say) can
+         * share it: it will be of the most recent buffer either way.
+         */
+        auto const queued = std::find_if(work.begin(), work.end(),
+            [&stream](WorkItem const& wi) { return wi.stream == stream; });
+
+        if (queued != work.end())
+        {
+            queued->snapshot_taken.push_back(snapshot_taken);
+        }
+        else
+        {
+            work.push_back(WorkItem{stream, {snapshot_taken}});
+            work_cv.notify_one();
+        }
     }
 
     void stop()
@@ -126,5 +146,5 @@ void ms::ThreadedSnapshotStrategy::take_snapshot_of(
     std::shared_ptr<compositor::BufferStream> const& surface_buffer_access,
     SnapshotCallback const& snapshot_taken)
 {
-    functor->schedule_snapshot(WorkItem{surface_buffer_access, snapshot_taken});
+    functor->schedule_snapshot(surface_buffer_access, snapshot_taken);
 }
@@ -46,6 +46,13 @@ public:
     MOCK_METHOD0(started, void());
     MOCK_METHOD0(stopped, void());
     MOCK_METHOD0(scheduled, void());
+    MOCK_METHOD4(predicted_frame,
+                 void(compositor::CompositorReport::SubCompositorId,
+                      std::chrono::steady_clock::time_point,
+                      std::chrono::nanoseconds,
+                      std::chrono::nanoseconds));
+    MOCK_METHOD2(copied_bytes,
+                 void(compositor::CompositorReport::SubCompositorId, size_t));
 };
 
 } // namespace doubles
@@ -56,6 +56,8 @@ public:
                        std::vector<uint32_t>& possible_encoder_ids,
                        geometry::Size const& physical_size,
                        drmModeSubPixel subpixel_arrangement = DRM_MODE_SUBPIXEL_UNKNOWN);
+    void add_plane(uint32_t plane_id, uint32_t possible_crtcs_mask,
+                   std::vector<uint32_t> const& formats, uint64_t type);
 
     void prepare();
     void reset();
@@ -63,6 +65,12 @@ public:
     drmModeCrtc* find_crtc(uint32_t id);
     drmModeEncoder* find_encoder(uint32_t id);
     drmModeConnector* find_connector(uint32_t id);
+    drmModePlane* find_plane(uint32_t id);
+    drmModePlaneRes* plane_resources_ptr();
+    drmModeObjectProperties* plane_properties_ptr(uint32_t plane_id);
+
+    /// The id of the "type" property of the planes added
+    static uint32_t const plane_type_property_id;
 
     enum ModePreference {NormalMode, PreferredMode};
     static drmModeModeInfo create_mode(uint16_t hdisplay, uint16_t vdisplay,
@@ -77,11 +85,18 @@ private:
     std::vector<drmModeCrtc> crtcs;
     std::vector<drmModeEncoder> encoders;
     std::vector<drmModeConnector> connectors;
+    std::vector<drmModePlane> planes;
 
     std::vector<uint32_t> crtc_ids;
     std::vector<uint32_t> encoder_ids;
     std::vector<uint32_t> connector_ids;
 
+    drmModePlaneRes plane_resources;
+    std::vector<uint32_t> plane_ids;
+    std::vector<std::vector<uint32_t>> plane_formats;
+    std::vector<uint64_t> plane_types;
+    std::vector<drmModeObjectProperties> plane_properties;
+
     std::vector<drmModeModeInfo> modes;
     std::vector<drmModeModeInfo> modes_empty;
     std::vector<uint32_t> connector_encoder_ids;
@@ -108,6 +123,15 @@ public:
                                      uint32_t x, uint32_t y, uint32_t *connectors,
                                      int count, drmModeModeInfoPtr mode));
 
+    /*
+     * gmock can mock at most ten arguments, so this leaves out the source
+     * rectangle: Mir always shows the whole framebuffer.
+     */
+    MOCK_METHOD9(drmModeSetPlane, int(int fd, uint32_t plane_id, uint32_t crtc_id,
+                                      uint32_t fb_id, uint32_t flags,
+                                      int32_t crtc_x, int32_t crtc_y,
+                                      uint32_t crtc_w, uint32_t crtc_h));
+
     MOCK_METHOD1(drmModeFreeResources, void(drmModeResPtr ptr));
     MOCK_METHOD1(drmModeFreeConnector, void(drmModeConnectorPtr ptr));
     MOCK_METHOD1(drmModeFreeEncoder, void(drmModeEncoderPtr ptr));
@@ -184,6 +208,12 @@ public:
         std::vector<uint32_t>& possible_encoder_ids,
         geometry::Size const& physical_size,
         drmModeSubPixel subpixel_arrangement = DRM_MODE_SUBPIXEL_UNKNOWN);
+    void add_plane(
+        char const* device,
+        uint32_t plane_id,
+        uint32_t possible_crtcs_mask,
+        std::vector<uint32_t> const& formats,
+        uint64_t type);
 
     void prepare(char const* device);
     void reset(char const* device);
@@ -35,7 +35,10 @@ class StubRenderer : public renderer::Renderer
 public:
     void set_viewport(geometry::Rectangle const&) override {}
     void set_output_transform(glm::mat2 const&) override {}
+    void set_damage(geometry::Rectangles const&) override {}
+    void set_visible_regions(VisibleRegions const&) override {}
     void suspend() override {}
+    size_t bytes_copied() const override { return 0; }
 
     void render(graphics::RenderableList const& renderables) const override
     {
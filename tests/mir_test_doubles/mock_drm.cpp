@@ -34,7 +34,19 @@ namespace geom = mir::geometry;
 namespace
 {
 mtd::MockDRM* global_mock = nullptr;
+
+drmModePropertyRes plane_type_property()
+{
+    drmModePropertyRes property = drmModePropertyRes();
+
+    property.prop_id = mtd::FakeDRMResources::plane_type_property_id;
+    strncpy(property.name, "type", sizeof property.name);
+
+    return property;
 }
+}
+
+uint32_t const mtd::FakeDRMResources::plane_type_property_id{90};
 
 mtd::FakeDRMResources::FakeDRMResources()
     : pipe_fds{-1, -1}
@@ -101,6 +113,11 @@ drmModeRes* mtd::FakeDRMResources::resources_ptr()
 
 void mtd::FakeDRMResources::prepare()
 {
+    // So prepare() can be called again after adding more objects
+    crtc_ids.clear();
+    encoder_ids.clear();
+    connector_ids.clear();
+
     resources.count_crtcs = crtcs.size();
     for (auto const& crtc: crtcs)
         crtc_ids.push_back(crtc.crtc_id);
@@ -115,6 +132,24 @@ void mtd::FakeDRMResources::prepare()
     for (auto const& connector: connectors)
         connector_ids.push_back(connector.connector_id);
     resources.connectors = connector_ids.data();
+
+    plane_ids.clear();
+    plane_properties.clear();
+    for (auto i = 0u; i != planes.size(); ++i)
+    {
+        planes[i].formats = plane_formats[i].data();
+        planes[i].count_formats = plane_formats[i].size();
+        plane_ids.push_back(planes[i].plane_id);
+
+        drmModeObjectProperties props = drmModeObjectProperties();
+        props.count_props = 1;
+        props.props = const_cast<uint32_t*>(&plane_type_property_id);
+        props.prop_values = &plane_types[i];
+        plane_properties.push_back(props);
+    }
+    plane_resources = drmModePlaneRes();
+    plane_resources.count_planes = plane_ids.size();
+    plane_resources.planes = plane_ids.data();
 }
 
 void mtd::FakeDRMResources::reset()
@@ -124,10 +159,17 @@ void mtd::FakeDRMResources::reset()
     crtcs.clear();
     encoders.clear();
     connectors.clear();
+    planes.clear();
 
     crtc_ids.clear();
     encoder_ids.clear();
     connector_ids.clear();
+
+    plane_resources = drmModePlaneRes();
+    plane_ids.clear();
+    plane_formats.clear();
+    plane_types.clear();
+    plane_properties.clear();
 }
 
 void mtd::FakeDRMResources::add_crtc(uint32_t id, drmModeModeInfo mode)
@@ -178,6 +220,22 @@ void mtd::FakeDRMResources::add_connector(uint32_t connector_id,
     connectors.push_back(connector);
 }
 
+void mtd::FakeDRMResources::add_plane(uint32_t plane_id,
+                                      uint32_t possible_crtcs_mask,
+                                      std::vector<uint32_t> const& formats,
+                                      uint64_t type)
+{
+    drmModePlane plane = drmModePlane();
+
+    plane.plane_id = plane_id;
+    plane.possible_crtcs = possible_crtcs_mask;
+
+    // prepare() points the plane at its formats and properties
+    planes.push_back(plane);
+    plane_formats.push_back(formats);
+    plane_types.push_back(type);
+}
+
 drmModeCrtc* mtd::FakeDRMResources::find_crtc(uint32_t id)
 {
     for (auto& crtc : crtcs)
@@ -208,6 +266,30 @@ drmModeConnector* mtd::FakeDRMResources::find_connector(uint32_t id)
     return nullptr;
 }
 
+drmModePlane* mtd::FakeDRMResources::find_plane(uint32_t id)
+{
+    for (auto& plane : planes)
+    {
+        if (plane.plane_id == id)
+            return &plane;
+    }
+    return nullptr;
+}
+
+drmModePlaneRes* mtd::FakeDRMResources::plane_resources_ptr()
+{
+    return &plane_resources;
+}
+
+drmModeObjectProperties* mtd::FakeDRMResources::plane_properties_ptr(uint32_t plane_id)
+{
+    for (auto i = 0u; i != planes.size(); ++i)
+    {
+        if (planes[i].plane_id == plane_id)
+            return &plane_properties[i];
+    }
+    return nullptr;
+}
 
 drmModeModeInfo mtd::FakeDRMResources::create_mode(uint16_t hdisplay, uint16_t vdisplay,
                                                    uint32_t clock, uint16_t htotal,
@@ -304,9 +386,39 @@ mtd::MockDRM::MockDRM()
                     return fd_to_drm.at(fd).find_connector(connector_id);
                 }));
 
+    ON_CALL(*this, drmModeGetPlaneResources(_))
+        .WillByDefault(
+            Invoke(
+                [this](int fd)
+                {
+                    return fd_to_drm.at(fd).plane_resources_ptr();
+                }));
+
+    ON_CALL(*this, drmModeGetPlane(_, _))
+        .WillByDefault(
+            Invoke(
+                [this](int fd, uint32_t plane_id)
+                {
+                    return fd_to_drm.at(fd).find_plane(plane_id);
+                }));
+
     ON_CALL(*this, drmModeObjectGetProperties(_, _, _))
         .WillByDefault(Return(&empty_object_props));
 
+    ON_CALL(*this, drmModeObjectGetProperties(_, _, DRM_MODE_OBJECT_PLANE))
+        .WillByDefault(
+            Invoke(
+                [this](int fd, uint32_t plane_id, uint32_t)
+                {
+                    auto const drm = fd_to_drm.find(fd);
+                    auto const props = drm != fd_to_drm.end() ? drm->second.plane_properties_ptr(plane_id) : nullptr;
+                    return props ? props : &empty_object_props;
+                }));
+
+    static drmModePropertyRes type_property = plane_type_property();
+    ON_CALL(*this, drmModeGetProperty(_, FakeDRMResources::plane_type_property_id))
+        .WillByDefault(Return(&type_property));
+
     ON_CALL(*this, drmSetInterfaceVersion(_, _))
         .WillByDefault(
             Invoke(
@@ -380,6 +492,16 @@ void mtd::MockDRM::add_encoder(
     fake_drms[device].add_encoder(encoder_id, crtc_id, possible_crtcs_mask);
 }
 
+void mtd::MockDRM::add_plane(
+    char const* device,
+    uint32_t plane_id,
+    uint32_t possible_crtcs_mask,
+    std::vector<uint32_t> const& formats,
+    uint64_t type)
+{
+    fake_drms[device].add_plane(plane_id, possible_crtcs_mask, formats, type);
+}
+
 void mtd::MockDRM::prepare(char const *device)
 {
     fake_drms[device].prepare();
@@ -543,6 +665,17 @@ int drmModeSetCrtc(int fd, uint32_t crtcId, uint32_t bufferId,
                                        connectors, count, mode);
 }
 
+int drmModeSetPlane(int fd, uint32_t plane_id, uint32_t crtc_id,
+                    uint32_t fb_id, uint32_t flags,
+                    int32_t crtc_x, int32_t crtc_y,
+                    uint32_t crtc_w, uint32_t crtc_h,
+                    uint32_t /*src_x*/, uint32_t /*src_y*/,
+                    uint32_t /*src_w*/, uint32_t /*src_h*/)
+{
+    return global_mock->drmModeSetPlane(fd, plane_id, crtc_id, fb_id, flags,
+                                        crtc_x, crtc_y, crtc_w, crtc_h);
+}
+
 int drmModeCrtcGetGamma(int fd, uint32_t crtc_id, uint32_t size,
                         uint16_t* red, uint16_t* green, uint16_t* blue)
 {
@@ -27,15 +27,26 @@ struct CompositorPerformance : SystemPerformanceTest
 {
     void SetUp() override
     {
-        compositor_fps = compositor_render_time = -1.0f;
+        compositor_fps = compositor_render_time = frame_time_p99 = -1.0f;
         SystemPerformanceTest::set_up_with("--compositor-report=log");
     }
 
     void read_compositor_report()
     {
-        char line[256];
+        char line[512];
         while (fgets(line, sizeof(line), server_output))
         {
+            // Since the compositor started, so the last one covers the whole run
+            if (char const* timings = strstr(line, "\"frame_time_us\":"))
+            {
+                unsigned long p99_usec;
+                if (1 == sscanf(timings, "\"frame_time_us\":{\"count\":%*u,\"p50\":%*u,\"p90\":%*u,\"p99\":%lu",
+                                &p99_usec))
+                {
+                    frame_time_p99 = p99_usec / 1000.0f;
+                }
+            }
+
             if (char const* perf = strstr(line, "averaged "))
             {
                 float fps, render_time;
@@ -49,7 +60,7 @@ struct CompositorPerformance : SystemPerformanceTest
         }
     }
 
-    float compositor_fps, compositor_render_time;
+    float compositor_fps, compositor_render_time, frame_time_p99;
 };
 } // anonymous namespace
 
@@ -66,4 +77,7 @@ TEST_F(CompositorPerformance, regression_test_1563287)
     read_compositor_report();
     EXPECT_GE(compositor_fps, 58.0f);
     EXPECT_LT(compositor_render_time, 17.0f);
+    // Averages hide the odd long frame; at worst one in a hundred misses a single vblank
+    EXPECT_GT(frame_time_p99, 0.0f);
+    EXPECT_LT(frame_time_p99, 34.0f);
 }
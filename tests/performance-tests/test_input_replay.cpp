@@ -0,0 +1,447 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/input_trace.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/input/input_device_info.h"
+#include "mir/input/seat_observer.h"
+#include "mir/input/event_filter.h"
+#include "mir/input/composite_event_filter.h"
+#include "mir/observer_registrar.h"
+#include "mir_test_framework/connected_client_headless_server.h"
+#include "mir_test_framework/fake_input_device.h"
+#include "mir_test_framework/stub_server_platform_factory.h"
+#include "mir/test/signal.h"
+
+#include <boost/throw_exception.hpp>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <linux/input.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace mev = mir::events;
+namespace mi = mir::input;
+namespace mis = mir::input::synthesis;
+namespace mtf = mir_test_framework;
+
+using namespace std::chrono;
+using namespace testing;
+
+namespace
+{
+seconds const max_wait{4};
+
+/*
+ * Each stage notes when it saw each event. Events are told apart by their
+ * event time, which the replay stamps with the moment it hands each one to
+ * the fake device and which passes through every stage untouched.
+ */
+class Stage
+{
+public:
+    void saw(MirEvent const& event)
+    {
+        if (mir_event_get_type(&event) != mir_event_type_input)
+            return;
+
+        auto const now = steady_clock::now().time_since_epoch().count();
+        auto const event_time = mir_input_event_get_event_time(mir_event_get_input_event(&event));
+
+        std::lock_guard<std::mutex> lock{mutex};
+        seen.emplace(event_time, now);
+    }
+
+    auto times() const -> std::unordered_map<int64_t, int64_t>
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        return seen;
+    }
+
+private:
+    std::mutex mutable mutex;
+    std::unordered_map<int64_t, int64_t> seen;
+};
+
+struct SeatStage : mi::SeatObserver, Stage
+{
+    void seat_add_device(uint64_t) override {}
+    void seat_remove_device(uint64_t) override {}
+    void seat_dispatch_event(std::shared_ptr<MirEvent const> const& event) override { saw(*event); }
+    void seat_set_key_state(uint64_t, std::vector<uint32_t> const&) override {}
+    void seat_set_pointer_state(uint64_t, unsigned) override {}
+    void seat_set_cursor_position(float, float) override {}
+    void seat_set_confinement_region_called(mir::geometry::Rectangles const&) override {}
+    void seat_reset_confinement_regions() override {}
+};
+
+struct DispatcherStage : mi::EventFilter, Stage
+{
+    bool handle(MirEvent const& event) override
+    {
+        saw(event);
+        return false;
+    }
+};
+
+/// Something to replay when we're not given a trace: a little typing, clicking and swiping, recorded as the server would
+void record_synthetic_trace(std::string const& path)
+{
+    MirInputDeviceId const keyboard{1};
+    MirInputDeviceId const mouse{2};
+    MirInputDeviceId const touch_screen{3};
+    std::vector<uint8_t> const no_cookie;
+
+    mi::InputTraceRecorder recorder{path};
+    recorder.device_added(keyboard, mi::InputDeviceInfo{"keyboard", "keyboard", mi::DeviceCapability::keyboard});
+    recorder.device_added(mouse, mi::InputDeviceInfo{"mouse", "mouse", mi::DeviceCapability::pointer});
+    recorder.device_added(
+        touch_screen,
+        mi::InputDeviceInfo{
+            "touch screen",
+            "touch screen",
+            mi::DeviceCapability::touchscreen | mi::DeviceCapability::multitouch});
+
+    milliseconds time{0};
+    for (int i = 0; i != 50; ++i)
+    {
+        for (auto action : {mir_keyboard_action_down, mir_keyboard_action_up})
+        {
+            recorder.record(*mev::make_event(
+                keyboard, time += milliseconds{8}, no_cookie,
+                action, 0, KEY_A + i % 9, mir_input_event_modifier_none));  // Along the home row
+        }
+
+        for (int j = 0; j != 4; ++j)
+        {
+            recorder.record(*mev::make_event(
+                mouse, time += milliseconds{4}, no_cookie, mir_input_event_modifier_none,
+                mir_pointer_action_motion, 0, 0, 0, 0, 0, 2, 1));
+        }
+
+        recorder.record(*mev::make_event(
+            mouse, time += milliseconds{8}, no_cookie, mir_input_event_modifier_none,
+            mir_pointer_action_button_down, mir_pointer_button_primary, 0, 0, 0, 0, 0, 0));
+        recorder.record(*mev::make_event(
+            mouse, time += milliseconds{8}, no_cookie, mir_input_event_modifier_none,
+            mir_pointer_action_button_up, 0, 0, 0, 0, 0, 0, 0));
+
+        for (int j = 0; j != 6; ++j)
+        {
+            auto touch = mev::make_event(touch_screen, time += milliseconds{4}, no_cookie, mir_input_event_modifier_none);
+            mev::add_touch(
+                *touch, 0,
+                j == 0 ? mir_touch_action_down : j == 5 ? mir_touch_action_up : mir_touch_action_change,
+                mir_touch_tooltype_finger, 100 + 10 * j, 100, 1, 1, 1, 1);
+            recorder.record(*touch);
+        }
+    }
+}
+
+int button_code_for(MirPointerButton button)
+{
+    switch (button)
+    {
+    case mir_pointer_button_secondary: return BTN_RIGHT;
+    case mir_pointer_button_tertiary: return BTN_MIDDLE;
+    case mir_pointer_button_back: return BTN_BACK;
+    case mir_pointer_button_forward: return BTN_FORWARD;
+    case mir_pointer_button_side: return BTN_SIDE;
+    case mir_pointer_button_extra: return BTN_EXTRA;
+    case mir_pointer_button_task: return BTN_TASK;
+    default: return BTN_LEFT;
+    }
+}
+
+void client_saw(MirWindow*, MirEvent const* event, void* context);
+
+struct InputReplay : mtf::ConnectedClientHeadlessServer
+{
+    void SetUp() override
+    {
+        mtf::ConnectedClientHeadlessServer::SetUp();
+
+        server.the_seat_observer_registrar()->register_interest(seat_stage);
+        server.the_composite_event_filter()->prepend(dispatcher_stage);
+
+        // Fullscreen, so every pointer and touch event lands on it
+        auto const spec = mir_create_normal_window_spec(connection, 100, 100);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_window_spec_set_pixel_format(spec, mir_pixel_format_abgr_8888);
+#pragma GCC diagnostic pop
+        mir_window_spec_set_fullscreen_on_output(spec, 1);
+        mir_window_spec_set_event_handler(spec, &client_saw, this);
+        window = mir_create_window_sync(spec);
+        mir_window_spec_release(spec);
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wdeprecated-declarations"
+        mir_buffer_stream_swap_buffers_sync(mir_window_get_buffer_stream(window));
+#pragma GCC diagnostic pop
+        ready_to_accept_events.wait_for(max_wait);
+        if (!ready_to_accept_events.raised())
+            BOOST_THROW_EXCEPTION(std::runtime_error("Timeout waiting for window to become focused and exposed"));
+    }
+
+    void TearDown() override
+    {
+        mir_window_release_sync(window);
+        mtf::ConnectedClientHeadlessServer::TearDown();
+    }
+
+    /*
+     * Emits each record at its recorded offset from the first, divided by
+     * speedup (or as fast as we can if speedup is 0). Returns how many
+     * events were emitted.
+     */
+    int replay(mi::InputTrace const& trace, double speedup)
+    {
+        std::map<int64_t, mir::UniqueModulePtr<mtf::FakeInputDevice>> devices;
+        std::map<int64_t, MirPointerButtons> buttons;
+        int emitted = 0;
+
+        auto const start = steady_clock::now();
+        int64_t recorded_start = -1;
+
+        for (auto record = trace.begin(); record != trace.end(); ++record)
+        {
+            switch (record->kind)
+            {
+            case mi::InputTraceRecord::device_added:
+                devices[record->device_id] = mtf::add_fake_input_device(mi::InputDeviceInfo{
+                    record->device.name,
+                    "replay-" + std::to_string(record->device_id),
+                    mi::DeviceCapabilities{record->device.capabilities}});
+                continue;
+            case mi::InputTraceRecord::device_removed:
+                devices.erase(record->device_id);
+                continue;
+            default:
+                break;
+            }
+
+            auto const device = devices.find(record->device_id);
+            if (device == devices.end())
+                continue;
+
+            if (recorded_start < 0)
+                recorded_start = record->event_time_ns;
+
+            if (speedup > 0)
+            {
+                nanoseconds const offset{record->event_time_ns - recorded_start};
+                std::this_thread::sleep_until(start + duration_cast<nanoseconds>(offset / speedup));
+            }
+
+            auto const now = duration_cast<nanoseconds>(steady_clock::now().time_since_epoch());
+
+            switch (record->kind)
+            {
+            case mi::InputTraceRecord::key_event:
+                // Repeats are made up by the server, so replaying them would count them twice
+                if (record->action == mir_keyboard_action_repeat)
+                    continue;
+                device->second->emit_event(
+                    (record->action == mir_keyboard_action_down ? mis::a_key_down_event() : mis::a_key_up_event())
+                        .of_scancode(record->key.scan_code)
+                        .with_event_time(now));
+                break;
+
+            case mi::InputTraceRecord::pointer_event:
+            {
+                auto& previous = buttons[record->device_id];
+                auto const changed = previous ^ record->pointer.buttons;
+                previous = record->pointer.buttons;
+
+                if (record->action == mir_pointer_action_button_down ||
+                    record->action == mir_pointer_action_button_up)
+                {
+                    auto const button = button_code_for(static_cast<MirPointerButton>(changed));
+                    device->second->emit_event(
+                        (record->action == mir_pointer_action_button_down ?
+                            mis::a_button_down_event() : mis::a_button_up_event())
+                            .of_button(button)
+                            .with_event_time(now));
+                }
+                else if (record->pointer.relative_x != 0 || record->pointer.relative_y != 0)
+                {
+                    device->second->emit_event(
+                        mis::a_pointer_event()
+                            .with_movement(
+                                static_cast<int>(record->pointer.relative_x),
+                                static_cast<int>(record->pointer.relative_y))
+                            .with_event_time(now));
+                }
+                else
+                {
+                    continue;
+                }
+                break;
+            }
+
+            case mi::InputTraceRecord::touch_point:
+            {
+                // The fake device only knows single touch, so follow the first point
+                if (record->point != 0)
+                    continue;
+
+                auto const action =
+                    record->action == mir_touch_action_down ? mis::TouchParameters::Action::Tap :
+                    record->action == mir_touch_action_up ? mis::TouchParameters::Action::Release :
+                    mis::TouchParameters::Action::Move;
+                device->second->emit_event(
+                    mis::a_touch_event()
+                        .at_position({static_cast<int>(record->touch.x), static_cast<int>(record->touch.y)})
+                        .with_action(action)
+                        .with_event_time(now));
+                break;
+            }
+
+            default:
+                continue;
+            }
+
+            ++emitted;
+        }
+
+        return emitted;
+    }
+
+    std::shared_ptr<SeatStage> const seat_stage{std::make_shared<SeatStage>()};
+    std::shared_ptr<DispatcherStage> const dispatcher_stage{std::make_shared<DispatcherStage>()};
+    Stage client_stage;
+
+    mir::test::Signal ready_to_accept_events;
+    std::mutex mutex;
+    bool exposed{false};
+    bool focused{false};
+    MirWindow* window{nullptr};
+};
+
+void client_saw(MirWindow*, MirEvent const* event, void* context)
+{
+    auto const replay = static_cast<InputReplay*>(context);
+
+    if (mir_event_get_type(event) == mir_event_type_window)
+    {
+        auto const window_event = mir_event_get_window_event(event);
+        auto const attrib = mir_window_event_get_attribute(window_event);
+        auto const value = mir_window_event_get_attribute_value(window_event);
+
+        std::lock_guard<std::mutex> lock{replay->mutex};
+        if (attrib == mir_window_attrib_visibility && value == mir_window_visibility_exposed)
+            replay->exposed = true;
+        if (attrib == mir_window_attrib_focus && value == mir_window_focus_state_focused)
+            replay->focused = true;
+        if (replay->exposed && replay->focused)
+            replay->ready_to_accept_events.raise();
+    }
+
+    replay->client_stage.saw(*event);
+}
+
+/// Prints how long events took to get from one stage to the next, and returns how many made it
+size_t report(
+    char const* name,
+    std::unordered_map<int64_t, int64_t> const& from,
+    std::unordered_map<int64_t, int64_t> const& to)
+{
+    std::vector<int64_t> latencies;
+    for (auto const& seen : to)
+    {
+        auto const earlier = from.find(seen.first);
+        if (earlier != from.end())
+            latencies.push_back(seen.second - earlier->second);
+    }
+
+    if (latencies.empty())
+    {
+        std::cout << name << ": no events" << std::endl;
+        return 0;
+    }
+
+    std::sort(latencies.begin(), latencies.end());
+    int64_t total = 0;
+    for (auto latency : latencies)
+        total += latency;
+
+    std::cout << name << ": " << latencies.size() << " events, "
+              << total / static_cast<int64_t>(latencies.size()) / 1000 << "us mean, "
+              << latencies[latencies.size() * 99 / 100] / 1000 << "us 99th percentile, "
+              << latencies.back() / 1000 << "us worst" << std::endl;
+    return latencies.size();
+}
+}
+
+/*
+ * Replays the input trace named by MIR_INPUT_TRACE (as written by a server
+ * run with --input-trace) or a synthetic one, at the recorded speed times
+ * MIR_INPUT_TRACE_SPEEDUP (0 for as fast as possible), and reports how long
+ * events take to get through each stage of the input stack.
+ */
+TEST_F(InputReplay, reports_latency_of_each_input_stage)
+{
+    std::string trace_path;
+    if (auto const path = getenv("MIR_INPUT_TRACE"))
+    {
+        trace_path = path;
+    }
+    else
+    {
+        trace_path = "/tmp/mir_performance_tests_input_trace." + std::to_string(getpid());
+        record_synthetic_trace(trace_path);
+    }
+
+    double speedup = 1;
+    if (auto const value = getenv("MIR_INPUT_TRACE_SPEEDUP"))
+        speedup = std::atof(value);
+
+    int emitted = 0;
+    {
+        mi::InputTrace const trace{trace_path};
+        emitted = replay(trace, speedup);
+    }
+
+    if (!getenv("MIR_INPUT_TRACE"))
+        unlink(trace_path.c_str());
+
+    // Let the last of it through
+    auto const deadline = steady_clock::now() + max_wait;
+    while (client_stage.times().size() < static_cast<size_t>(emitted) && steady_clock::now() < deadline)
+        std::this_thread::sleep_for(milliseconds{10});
+
+    std::unordered_map<int64_t, int64_t> emit_times;
+    for (auto const& seen : seat_stage->times())
+        emit_times.emplace(seen.first, seen.first);
+
+    std::cout << "Replayed " << emitted << " events" << std::endl;
+    report("device -> seat", emit_times, seat_stage->times());
+    report("seat -> dispatcher", seat_stage->times(), dispatcher_stage->times());
+    auto const delivered = report("dispatcher -> client", dispatcher_stage->times(), client_stage.times());
+
+    EXPECT_THAT(delivered, Gt(0u));
+}
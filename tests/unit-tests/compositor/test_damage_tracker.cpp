@@ -0,0 +1,77 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/damage_tracker.h"
+#include "mir/test/doubles/fake_renderable.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+namespace mc = mir::compositor;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+namespace mtd = mir::test::doubles;
+
+namespace
+{
+struct DamageTracker : Test
+{
+    geom::Rectangle const screen{{0, 0}, {1024, 768}};
+    geom::Rectangle const below_rect{{10, 10}, {200, 100}};
+    std::shared_ptr<mtd::FakeRenderable> const below{std::make_shared<mtd::FakeRenderable>(below_rect)};
+    std::shared_ptr<mtd::FakeRenderable> const above{std::make_shared<mtd::FakeRenderable>(50, 50, 100, 100)};
+    mg::RenderableList const renderables{below, above};
+
+    mc::DamageTracker tracker;
+};
+}
+
+TEST_F(DamageTracker, first_frame_is_fully_damaged)
+{
+    EXPECT_THAT(tracker.damage_for(renderables, screen), Eq(geom::Rectangles{screen}));
+}
+
+TEST_F(DamageTracker, unchanged_clip_causes_no_damage)
+{
+    mir::renderer::Renderer::VisibleRegions const clips{{below.get(), geom::Region{{{10, 10}, {200, 40}}}}};
+
+    tracker.damage_for(renderables, screen, clips);
+
+    EXPECT_THAT(tracker.damage_for(renderables, screen, clips), Eq(geom::Rectangles{}));
+}
+
+TEST_F(DamageTracker, changed_clip_damages_the_renderable)
+{
+    tracker.damage_for(
+        renderables, screen,
+        {{below.get(), geom::Region{{{10, 10}, {200, 40}}}}});
+
+    EXPECT_THAT(
+        tracker.damage_for(
+            renderables, screen,
+            {{below.get(), geom::Region{{{10, 10}, {200, 60}}}}}),
+        Eq(geom::Rectangles{below_rect, below_rect}));
+}
+
+TEST_F(DamageTracker, clip_being_removed_damages_the_renderable)
+{
+    tracker.damage_for(
+        renderables, screen,
+        {{below.get(), geom::Region{{{10, 10}, {200, 40}}}}});
+
+    EXPECT_THAT(tracker.damage_for(renderables, screen), Eq(geom::Rectangles{below_rect, below_rect}));
+}
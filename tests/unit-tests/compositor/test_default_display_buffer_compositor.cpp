@@ -22,6 +22,7 @@
 #include "mir/compositor/scene.h"
 #include "mir/renderer/renderer.h"
 #include "mir/geometry/rectangle.h"
+#include "mir/graphics/overlay_planes.h"
 #include "mir/test/doubles/mock_renderer.h"
 #include "mir/test/fake_shared.h"
 #include "mir/test/gmock_fixes.h"
@@ -184,6 +185,49 @@ TEST_F(DefaultDisplayBufferCompositor, rendering_reports_everything)
     compositor.composite(make_scene_elements({}));
 }
 
+TEST_F(DefaultDisplayBufferCompositor, reports_client_pixels_the_renderer_copied)
+{
+    using namespace testing;
+    NiceMock<mtd::MockCompositorReport> report;
+
+    EXPECT_CALL(display_buffer, overlay(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(mock_renderer, bytes_copied())
+        .WillOnce(Return(4096));
+    EXPECT_CALL(report, copied_bytes(_, 4096));
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mt::fake_shared(report));
+    compositor.composite(make_scene_elements({big}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, only_renders_what_is_not_on_overlay_planes)
+{
+    using namespace testing;
+
+    struct MockPlanesDisplayBuffer : mtd::MockDisplayBuffer, mg::OverlayPlanes
+    {
+        MOCK_METHOD1(assign_planes, mg::RenderableList(mg::RenderableList const&));
+    };
+    NiceMock<MockPlanesDisplayBuffer> planes_display_buffer;
+    ON_CALL(planes_display_buffer, view_area())
+        .WillByDefault(Return(screen));
+
+    EXPECT_CALL(planes_display_buffer, overlay(_))
+        .WillOnce(Return(false));
+    EXPECT_CALL(planes_display_buffer, assign_planes(mg::RenderableList{big, small}))
+        .WillOnce(Return(mg::RenderableList{big}));
+    EXPECT_CALL(mock_renderer, render(mg::RenderableList{big}));
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        planes_display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+    compositor.composite(make_scene_elements({big, small}));
+}
+
 TEST_F(DefaultDisplayBufferCompositor, calls_renderer_in_sequence)
 {
     using namespace testing;
@@ -388,3 +432,112 @@ TEST_F(DefaultDisplayBufferCompositor, marks_occluded_scene_elements)
     compositor.composite({element0_occluded, element1_rendered, element2_occluded});
 }
 
+
+TEST_F(DefaultDisplayBufferCompositor, first_frame_damages_everything)
+{
+    using namespace testing;
+
+    EXPECT_CALL(mock_renderer, set_damage(geom::Rectangles{screen}));
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, unchanged_frame_has_no_damage)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    Sequence seq;
+    EXPECT_CALL(mock_renderer, set_damage(geom::Rectangles{}))
+        .InSequence(seq);
+    EXPECT_CALL(mock_renderer, render(_))
+        .InSequence(seq);
+
+    compositor.composite(make_scene_elements({big, small}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, new_buffer_damages_only_its_renderable)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    small->set_buffer(std::make_shared<mtd::StubBuffer>());
+
+    EXPECT_CALL(mock_renderer, set_damage(geom::Rectangles{small->screen_position(), small->screen_position()}));
+
+    compositor.composite(make_scene_elements({big, small}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, removed_renderable_damages_where_it_was)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    EXPECT_CALL(mock_renderer, set_damage(geom::Rectangles{big->screen_position()}));
+
+    compositor.composite(make_scene_elements({small}));
+}
+
+TEST_F(DefaultDisplayBufferCompositor, frame_after_overlay_damages_everything)
+{
+    using namespace testing;
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    EXPECT_CALL(display_buffer, overlay(_))
+        .WillOnce(Return(true))
+        .WillRepeatedly(Return(false));
+    compositor.composite(make_scene_elements({fullscreen}));
+
+    EXPECT_CALL(mock_renderer, set_damage(geom::Rectangles{screen}));
+
+    compositor.composite(make_scene_elements({big, small}));
+
+    fullscreen->set_buffer({});  // Avoid GMock complaining about false leaks
+}
+
+TEST_F(DefaultDisplayBufferCompositor, tells_renderer_what_is_visible_of_partly_hidden_renderables)
+{
+    using namespace testing;
+
+    geom::Region visible_of_big{big->screen_position()};
+    visible_of_big.subtract(small->screen_position());
+
+    EXPECT_CALL(mock_renderer, set_visible_regions(
+        mir::renderer::Renderer::VisibleRegions{{big->id(), visible_of_big}}));
+
+    mc::DefaultDisplayBufferCompositor compositor(
+        display_buffer,
+        mt::fake_shared(mock_renderer),
+        mr::null_compositor_report());
+
+    compositor.composite(make_scene_elements({big, small}));
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/compositor/frame_scheduler.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace testing;
+using namespace std::literals::chrono_literals;
+namespace mc = mir::compositor;
+
+namespace
+{
+struct FrameScheduler : Test
+{
+    using TimePoint = mc::FrameScheduler::TimePoint;
+
+    // Composites a frame taking render_time, posted to an output refreshing every interval
+    void vsynced_frame(std::chrono::microseconds render_time)
+    {
+        auto const began = now;
+        auto const posting = began + render_time;
+        vblank += interval;
+        while (vblank < posting + 1ms)
+            vblank += interval;
+
+        scheduler.frame_posted(began, posting, vblank);
+        now = vblank;
+    }
+
+    std::chrono::microseconds const interval{16667};
+    TimePoint now{1s};
+    TimePoint vblank{now};
+    mc::FrameScheduler scheduler{2ms};
+};
+}
+
+TEST_F(FrameScheduler, has_no_prediction_at_first)
+{
+    EXPECT_FALSE(scheduler.has_prediction(now));
+}
+
+TEST_F(FrameScheduler, learns_refresh_interval_from_blocking_posts)
+{
+    for (int i = 0; i != 6; ++i)
+        vsynced_frame(3ms);
+
+    ASSERT_TRUE(scheduler.has_prediction(now));
+    EXPECT_THAT(scheduler.refresh_interval(), AllOf(Ge(interval - 50us), Le(interval + 50us)));
+    EXPECT_THAT(scheduler.next_vblank(now + 1us), AllOf(Ge(vblank + interval - 50us), Le(vblank + interval + 50us)));
+}
+
+TEST_F(FrameScheduler, learns_refresh_interval_despite_missed_frames)
+{
+    vsynced_frame(3ms);
+    vsynced_frame(3ms);
+    vsynced_frame(20ms);
+    vsynced_frame(3ms);
+    vsynced_frame(30ms);
+    vsynced_frame(3ms);
+    vsynced_frame(3ms);
+
+    ASSERT_TRUE(scheduler.has_prediction(now));
+    EXPECT_THAT(scheduler.refresh_interval(), AllOf(Ge(interval - 50us), Le(interval + 50us)));
+}
+
+TEST_F(FrameScheduler, posts_that_do_not_block_give_no_prediction)
+{
+    for (int i = 0; i != 10; ++i)
+    {
+        auto const began = now;
+        now += interval;
+        scheduler.frame_posted(began, now, now + 10us);
+    }
+
+    EXPECT_FALSE(scheduler.has_prediction(now));
+}
+
+TEST_F(FrameScheduler, starts_compositing_the_slowest_recent_render_time_before_vblank)
+{
+    for (int i = 0; i != 6; ++i)
+        vsynced_frame(i == 2 ? 5ms : 3ms);
+
+    EXPECT_THAT(scheduler.render_time(), Eq(5ms));
+    EXPECT_THAT(scheduler.lead_time(), Eq(7ms));
+
+    auto const target = scheduler.target_vblank(now);
+    EXPECT_THAT(target, Eq(scheduler.next_vblank(now + 1us)));
+    EXPECT_THAT(target - scheduler.lead_time(), Gt(now));
+}
+
+TEST_F(FrameScheduler, targets_a_later_vblank_when_too_late_for_the_next)
+{
+    for (int i = 0; i != 6; ++i)
+        vsynced_frame(3ms);
+
+    auto const next = scheduler.next_vblank(now + 1us);
+    auto const too_late = next - 2ms;
+
+    EXPECT_THAT(scheduler.target_vblank(too_late), Gt(next));
+    EXPECT_THAT(scheduler.target_vblank(too_late) - scheduler.lead_time(), Ge(too_late));
+}
+
+TEST_F(FrameScheduler, prediction_expires)
+{
+    for (int i = 0; i != 6; ++i)
+        vsynced_frame(3ms);
+
+    EXPECT_TRUE(scheduler.has_prediction(now + 100ms));
+    EXPECT_FALSE(scheduler.has_prediction(now + 10s));
+}
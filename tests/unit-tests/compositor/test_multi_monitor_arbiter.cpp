@@ -21,6 +21,7 @@
 #include "mir/test/doubles/stub_buffer_allocator.h"
 #include "src/server/compositor/multi_monitor_arbiter.h"
 #include "src/server/compositor/schedule.h"
+#include "src/server/compositor/queueing_schedule.h"
 
 #include <gtest/gtest.h>
 using namespace testing;
@@ -661,3 +662,54 @@ TEST_F(MultiMonitorArbiter, second_compositor_advances_schedule_after_both_aquir
     auto cbuffer4 = arbiter.compositor_acquire(&comp_id2);
     EXPECT_THAT(cbuffer1, Not(IsSameBufferAs(cbuffer4)));
 }
+
+TEST_F(MultiMonitorArbiter, keeps_track_of_compositors_after_many_have_come_and_gone)
+{
+    std::vector<int> departed(200);
+    int compositor{0};
+
+    schedule.set_schedule({buffers[0]});
+    for (auto& id : departed)
+        arbiter.compositor_acquire(&id);
+
+    auto cbuffer1 = arbiter.compositor_acquire(&compositor);
+    EXPECT_FALSE(arbiter.buffer_ready_for(&compositor));
+
+    schedule.set_schedule({buffers[1]});
+    auto cbuffer2 = arbiter.compositor_acquire(&compositor);
+    EXPECT_THAT(cbuffer1, IsSameBufferAs(buffers[0]));
+    EXPECT_THAT(cbuffer2, IsSameBufferAs(buffers[1]));
+}
+
+TEST_F(MultiMonitorArbiter, transitioning_schedule_moves_scheduled_buffers_to_the_new_one)
+{
+    auto const queue = std::make_shared<mc::QueueingSchedule>();
+    schedule.set_schedule({buffers[0], buffers[1], buffers[2]});
+
+    auto cbuffer1 = arbiter.compositor_acquire(this);
+    arbiter.transition_schedule(queue);
+
+    EXPECT_THAT(schedule.num_scheduled(), Eq(0u));
+    EXPECT_THAT(queue->num_scheduled(), Eq(2u));
+
+    auto cbuffer2 = arbiter.compositor_acquire(this);
+    auto cbuffer3 = arbiter.compositor_acquire(this);
+    EXPECT_THAT(cbuffer1, IsSameBufferAs(buffers[0]));
+    EXPECT_THAT(cbuffer2, IsSameBufferAs(buffers[1]));
+    EXPECT_THAT(cbuffer3, IsSameBufferAs(buffers[2]));
+}
+
+TEST_F(MultiMonitorArbiter, advancing_to_latest_drops_older_scheduled_buffers)
+{
+    auto buffer_released = std::make_shared<bool>(false);
+    schedule.set_schedule({
+        wrap_with_destruction_notifier(buffers[0], buffer_released),
+        buffers[1],
+        buffers[2]});
+
+    arbiter.advance_to_latest();
+
+    EXPECT_TRUE(*buffer_released);
+    EXPECT_THAT(schedule.num_scheduled(), Eq(0u));
+    EXPECT_THAT(arbiter.compositor_acquire(this), IsSameBufferAs(buffers[2]));
+}
@@ -468,6 +468,63 @@ TEST(MultiThreadedCompositor, reports_in_the_right_places)
     compositor.stop();
 }
 
+TEST(MultiThreadedCompositor, reports_vblanks_predicted_from_posts_waiting_for_them)
+{
+    using namespace testing;
+    using namespace std::chrono;
+
+    milliseconds const refresh_interval{10};
+
+    struct VsyncedDisplaySyncGroup : mtd::NullDisplaySyncGroup
+    {
+        VsyncedDisplaySyncGroup(milliseconds refresh_interval) : refresh_interval{refresh_interval} {}
+
+        void post() override
+        {
+            auto const now = steady_clock::now().time_since_epoch();
+            std::this_thread::sleep_until(
+                steady_clock::time_point{(now / refresh_interval + 1) * refresh_interval});
+        }
+
+        milliseconds const refresh_interval;
+    };
+
+    struct VsyncedDisplay : mtd::NullDisplay
+    {
+        VsyncedDisplay(milliseconds refresh_interval) : group{refresh_interval} {}
+
+        void for_each_display_sync_group(std::function<void(mg::DisplaySyncGroup&)> const& f) override
+        {
+            f(group);
+        }
+
+        VsyncedDisplaySyncGroup group;
+    };
+
+    auto display = std::make_shared<VsyncedDisplay>(refresh_interval);
+    auto scene = std::make_shared<StubScene>();
+    auto factory = std::make_shared<RecordingDisplayBufferCompositorFactory>();
+    auto mock_report = std::make_shared<NiceMock<mtd::MockCompositorReport>>();
+
+    std::atomic<bool> predicted{false};
+    EXPECT_CALL(*mock_report, predicted_frame(_, _, AllOf(Ge(refresh_interval - 1ms), Le(refresh_interval + 1ms)), _))
+        .Times(AtLeast(1))
+        .WillRepeatedly(InvokeWithoutArgs([&]{ predicted = true; }));
+
+    mc::MultiThreadedCompositor compositor{display, scene, factory,
+                                           null_display_listener, mock_report,
+                                           default_delay, false};
+    compositor.start();
+
+    for (int frame = 0; frame != 100 && !predicted; ++frame)
+    {
+        scene->emit_change_event();
+        std::this_thread::sleep_for(refresh_interval);
+    }
+
+    compositor.stop();
+}
+
 /*
  * It's difficult to test that a render won't happen, without some further
  * introspective capabilities that would complicate the code. This test will
@@ -202,3 +202,45 @@ TEST_F(OcclusionFilterTest,
     EXPECT_THAT(renderables_from(occlusions), ElementsAre(partially_onscreen));
     EXPECT_THAT(renderables_from(elements), ElementsAre(covering));
 }
+
+TEST_F(OcclusionFilterTest, window_covered_by_several_windows_occluded)
+{
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(100, 100, 200, 100);
+    auto const left = std::make_shared<mtd::FakeRenderable>(50, 50, 150, 200);
+    auto const right = std::make_shared<mtd::FakeRenderable>(200, 50, 150, 200);
+    auto elements = scene_elements_from({bottom, left, right});
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect);
+
+    EXPECT_THAT(renderables_from(occlusions), ElementsAre(bottom));
+    EXPECT_THAT(renderables_from(elements), ElementsAre(left, right));
+}
+
+TEST_F(OcclusionFilterTest, reports_visible_region_of_partially_covered_windows)
+{
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(0, 0, 100, 100);
+    auto const middle = std::make_shared<mtd::FakeRenderable>(50, 0, 100, 100);
+    auto const top = std::make_shared<mtd::FakeRenderable>(200, 200, 10, 10);
+    auto elements = scene_elements_from({bottom, middle, top});
+    mir::renderer::Renderer::VisibleRegions partially_visible;
+
+    auto const& occlusions = filter_occlusions_from(elements, monitor_rect, partially_visible);
+
+    EXPECT_THAT(renderables_from(occlusions), IsEmpty());
+    EXPECT_THAT(renderables_from(elements), ElementsAre(bottom, middle, top));
+
+    ASSERT_THAT(partially_visible.size(), Eq(1u));
+    EXPECT_THAT(partially_visible[bottom->id()], Eq(Region{Rectangle{{0, 0}, {50, 100}}}));
+}
+
+TEST_F(OcclusionFilterTest, translucent_windows_do_not_hide_parts_of_others)
+{
+    auto const bottom = std::make_shared<mtd::FakeRenderable>(Rectangle{{0, 0}, {100, 100}}, 1.0f);
+    auto const top = std::make_shared<mtd::FakeRenderable>(Rectangle{{50, 0}, {100, 100}}, 0.5f);
+    auto elements = scene_elements_from({bottom, top});
+    mir::renderer::Renderer::VisibleRegions partially_visible;
+
+    filter_occlusions_from(elements, monitor_rect, partially_visible);
+
+    EXPECT_THAT(partially_visible, IsEmpty());
+}
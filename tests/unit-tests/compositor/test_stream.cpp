@@ -26,6 +26,9 @@
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 #include "mir/test/gmock_fixes.h"
+
+#include <atomic>
+#include <thread>
 using namespace testing;
 namespace mf = mir::frontend;
 namespace mt = mir::test;
@@ -227,3 +230,90 @@ TEST_F(Stream, returns_buffers_to_client_when_told_to_bring_queue_up_to_date)
     EXPECT_THAT(buffers[1].use_count(), Eq(1));
     EXPECT_THAT(buffers[2].use_count(), Eq(2));
 }
+
+TEST_F(Stream, compositors_see_buffers_in_submission_order_while_a_client_submits)
+{
+    int const nframes{1000};
+    std::atomic<bool> done{false};
+    std::atomic<bool> out_of_order{false};
+
+    auto const compositor = [&]
+        {
+            int const id{0};
+            uint32_t last_seen{0};
+            while (!done)
+            {
+                if (!stream.buffers_ready_for_compositor(&id))
+                    continue;
+
+                auto const seen = stream.lock_compositor_buffer(&id)->id().as_value();
+                if (seen < last_seen)
+                    out_of_order = true;
+                last_seen = seen;
+            }
+        };
+
+    std::thread compositor1{compositor};
+    std::thread compositor2{compositor};
+
+    std::vector<std::shared_ptr<mg::Buffer>> submitted;
+    for (int i = 0; i != nframes; ++i)
+    {
+        submitted.push_back(std::make_shared<mtd::StubBuffer>());
+        stream.submit_buffer(submitted.back());
+    }
+
+    done = true;
+    compositor1.join();
+    compositor2.join();
+
+    EXPECT_FALSE(out_of_order);
+}
+
+TEST_F(Stream, compositors_can_acquire_while_the_schedule_is_drained)
+{
+    int const nframes{20000};
+    std::atomic<bool> done{false};
+    std::atomic<bool> threw{false};
+
+    stream.submit_buffer(buffers[0]);
+
+    std::thread compositor{
+        [&]
+        {
+            int const id{0};
+            while (!done)
+            {
+                try
+                {
+                    stream.lock_compositor_buffer(&id);
+                }
+                catch (std::logic_error const&)
+                {
+                    threw = true;
+                }
+            }
+        }};
+
+    try
+    {
+        for (int i = 0; i != nframes; ++i)
+        {
+            stream.submit_buffer(buffers[i % buffers.size()]);
+            stream.submit_buffer(buffers[(i + 1) % buffers.size()]);
+            if (i % 2)
+                stream.drop_old_buffers();
+            else
+                stream.allow_framedropping(i % 4 == 0);
+        }
+    }
+    catch (std::logic_error const&)
+    {
+        threw = true;
+    }
+
+    done = true;
+    compositor.join();
+
+    EXPECT_FALSE(threw);
+}
@@ -30,6 +30,7 @@ class MockMessageSender : public mf::MessageSender
 {
 public:
     MOCK_METHOD3(send, void(char const*, size_t, mf::FdSets const&));
+    MOCK_METHOD3(send_mergeable, void(std::string const&, uint64_t, Merge const&));
 };
 
 TEST(ReorderingMessageSender, sends_no_message_before_being_uncorked)
@@ -215,3 +216,22 @@ TEST(ReorderingMessageSender, messages_with_fds_are_sent)
         EXPECT_THAT(messages_sent[i + datas.size()].fds, Eq(fdsets[i]));
     }
 }
+
+TEST(ReorderingMessageSender, mergeable_messages_stay_mergeable_after_uncork)
+{
+    using namespace testing;
+    auto mock_sender = std::make_shared<NiceMock<MockMessageSender>>();
+
+    mf::ReorderingMessageSender sender{mock_sender};
+
+    std::string const held{"held"};
+    std::string const after{"after"};
+
+    InSequence seq;
+    EXPECT_CALL(*mock_sender, send(_, held.size(), _));
+    EXPECT_CALL(*mock_sender, send_mergeable(after, 42, _));
+
+    sender.send_mergeable(held, 42, [](std::string const& earlier) { return earlier; });
+    sender.uncork();
+    sender.send_mergeable(after, 42, [](std::string const& earlier) { return earlier; });
+}
@@ -60,6 +60,9 @@ struct StubMessageProcessorReport : mf::MessageProcessorReport
     void exception_handled(void const*, std::exception const&) override
     {
     }
+    void send_queue_depth(void const*, size_t) override
+    {
+    }
 };
 
 struct StubDisplayServer : mtd::StubDisplayServer
@@ -0,0 +1,196 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend/socket_messenger.h"
+#include "mir/frontend/message_processor_report.h"
+#include "mir/fd_socket_transmission.h"
+#include "mir/test/fake_shared.h"
+
+#include <boost/asio.hpp>
+
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+namespace mf = mir::frontend;
+namespace mfd = mir::frontend::detail;
+namespace ba = boost::asio;
+
+using namespace testing;
+
+namespace
+{
+struct MockMessageProcessorReport : mf::MessageProcessorReport
+{
+    void received_invocation(void const*, int, std::string const&) override {}
+    void completed_invocation(void const*, int, bool) override {}
+    void unknown_method(void const*, int, std::string const&) override {}
+    void exception_handled(void const*, int, std::exception const&) override {}
+    void exception_handled(void const*, std::exception const&) override {}
+
+    MOCK_METHOD2(send_queue_depth, void(void const*, size_t));
+};
+
+struct SocketMessenger : Test
+{
+    SocketMessenger()
+    {
+        ba::local::connect_pair(*server_socket, client_socket);
+        messenger = std::make_shared<mfd::SocketMessenger>(server_socket, mir::test::fake_shared(report), 1024*1024);
+    }
+
+    // Lets the messenger write what it's queued until the client has enough to read
+    void wait_for_bytes(size_t count)
+    {
+        while (client_socket.available() < count)
+        {
+            io.reset();
+            io.poll();
+        }
+    }
+
+    std::string receive_message()
+    {
+        unsigned char header[2];
+        wait_for_bytes(sizeof header);
+        ba::read(client_socket, ba::buffer(header));
+
+        std::string message(header[0] << 8 | header[1], '\0');
+        wait_for_bytes(message.size());
+        ba::read(client_socket, ba::buffer(&message[0], message.size()));
+        return message;
+    }
+
+    std::vector<mir::Fd> receive_fds(size_t count)
+    {
+        std::vector<mir::Fd> fds(count);
+        wait_for_bytes(1);
+        char dummy;
+        mir::receive_data(mir::Fd{mir::IntOwnedFd{client_socket.native_handle()}}, &dummy, 1, fds);
+        return fds;
+    }
+
+    // Sends until the socket buffer is full and messages start to queue
+    void fill_socket_buffer()
+    {
+        std::string const filler(1000, 'f');
+        while (messenger->queue_depth() == 0)
+        {
+            messenger->send(filler.data(), filler.size(), {});
+            ++filler_messages;
+        }
+    }
+
+    void drain_filler()
+    {
+        for (; filler_messages; --filler_messages)
+            EXPECT_THAT(receive_message(), Eq(std::string(1000, 'f')));
+    }
+
+    NiceMock<MockMessageProcessorReport> report;
+    ba::io_service io;
+    std::shared_ptr<ba::local::stream_protocol::socket> const server_socket{
+        std::make_shared<ba::local::stream_protocol::socket>(io)};
+    ba::local::stream_protocol::socket client_socket{io};
+    std::shared_ptr<mfd::SocketMessenger> messenger;
+    int filler_messages{0};
+};
+}
+
+TEST_F(SocketMessenger, sends_messages_in_order_with_their_fds)
+{
+    mir::Fd const fd{open("/dev/null", O_RDONLY)};
+    std::string const first{"first"};
+    std::string const second{"second"};
+
+    messenger->send(first.data(), first.size(), {{fd, fd}});
+    messenger->send(second.data(), second.size(), {});
+
+    EXPECT_THAT(receive_message(), Eq(first));
+    EXPECT_THAT(receive_fds(2).size(), Eq(2u));
+    EXPECT_THAT(receive_message(), Eq(second));
+}
+
+TEST_F(SocketMessenger, queues_messages_while_the_client_is_not_reading)
+{
+    mir::Fd const fd{open("/dev/null", O_RDONLY)};
+    std::string const with_fds{"with fds"};
+    std::string const last{"last"};
+
+    fill_socket_buffer();
+    messenger->send(with_fds.data(), with_fds.size(), {{fd}});
+    messenger->send(last.data(), last.size(), {});
+
+    EXPECT_THAT(messenger->queue_depth(), Ge(3u));
+
+    drain_filler();
+    EXPECT_THAT(receive_message(), Eq(with_fds));
+    EXPECT_THAT(receive_fds(1).size(), Eq(1u));
+    EXPECT_THAT(receive_message(), Eq(last));
+    EXPECT_THAT(messenger->queue_depth(), Eq(0u));
+}
+
+TEST_F(SocketMessenger, reports_the_queue_depth_when_the_client_falls_behind_and_catches_up)
+{
+    InSequence seq;
+    EXPECT_CALL(report, send_queue_depth(messenger.get(), Gt(0u))).Times(AtLeast(1));
+    EXPECT_CALL(report, send_queue_depth(messenger.get(), Eq(0u)));
+
+    fill_socket_buffer();
+    drain_filler();
+}
+
+TEST_F(SocketMessenger, merges_mergeable_messages_while_the_client_is_behind)
+{
+    fill_socket_buffer();
+
+    auto const merge = [](std::string const& earlier) { return earlier + "+later"; };
+    messenger->send_mergeable("earlier", 1, merge);
+    messenger->send_mergeable("later", 1, merge);
+    messenger->send_mergeable("other", 2, merge);
+
+    drain_filler();
+    EXPECT_THAT(receive_message(), Eq("earlier+later"));
+    EXPECT_THAT(receive_message(), Eq("other"));
+}
+
+TEST_F(SocketMessenger, does_not_merge_across_other_messages)
+{
+    fill_socket_buffer();
+
+    auto const merge = [](std::string const& earlier) { return earlier + "+later"; };
+    messenger->send_mergeable("earlier", 1, merge);
+    messenger->send("between", 7, {});
+    messenger->send_mergeable("later", 1, merge);
+
+    drain_filler();
+    EXPECT_THAT(receive_message(), Eq("earlier"));
+    EXPECT_THAT(receive_message(), Eq("between"));
+    EXPECT_THAT(receive_message(), Eq("later"));
+}
+
+TEST_F(SocketMessenger, refuses_messages_once_too_many_are_queued)
+{
+    std::string const big(60*1024, 'b');
+
+    EXPECT_THROW(
+        for (int i = 0; i != 100; ++i)
+            messenger->send(big.data(), big.size(), {});,
+        std::runtime_error);
+}
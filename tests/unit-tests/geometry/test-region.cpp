@@ -0,0 +1,190 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "mir/geometry/region.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+using namespace mir::geometry;
+using namespace testing;
+
+TEST(RegionTest, default_region_is_empty)
+{
+    Region const region;
+
+    EXPECT_TRUE(region.is_empty());
+    EXPECT_THAT(region.rectangles(), IsEmpty());
+    EXPECT_EQ(Rectangle{}, region.bounding_rectangle());
+}
+
+TEST(RegionTest, empty_rectangles_make_empty_regions)
+{
+    Region region{Rectangle{{10, 10}, {0, 5}}};
+    region.add(Rectangle{{0, 0}, {5, 0}});
+
+    EXPECT_TRUE(region.is_empty());
+}
+
+TEST(RegionTest, single_rectangle_is_kept_as_is)
+{
+    Rectangle const rect{{1, 2}, {3, 4}};
+    Region const region{rect};
+
+    EXPECT_THAT(region.rectangles(), ElementsAre(rect));
+    EXPECT_EQ(rect, region.bounding_rectangle());
+}
+
+TEST(RegionTest, side_by_side_rectangles_merge)
+{
+    Region const region{
+        Rectangle{{0, 0}, {50, 100}},
+        Rectangle{{50, 0}, {50, 100}}};
+
+    EXPECT_THAT(region.rectangles(), ElementsAre(Rectangle{{0, 0}, {100, 100}}));
+}
+
+TEST(RegionTest, stacked_rectangles_merge)
+{
+    Region const region{
+        Rectangle{{0, 0}, {100, 50}},
+        Rectangle{{0, 50}, {100, 50}}};
+
+    EXPECT_THAT(region.rectangles(), ElementsAre(Rectangle{{0, 0}, {100, 100}}));
+}
+
+TEST(RegionTest, overlapping_rectangles_are_split_into_bands)
+{
+    Region const region{
+        Rectangle{{0, 0}, {20, 20}},
+        Rectangle{{10, 10}, {20, 20}}};
+
+    EXPECT_THAT(region.rectangles(), ElementsAre(
+        Rectangle{{0, 0}, {20, 10}},
+        Rectangle{{0, 10}, {30, 10}},
+        Rectangle{{10, 20}, {20, 10}}));
+    EXPECT_EQ((Rectangle{{0, 0}, {30, 30}}), region.bounding_rectangle());
+}
+
+TEST(RegionTest, same_area_compares_equal_whatever_the_construction)
+{
+    Region const a{
+        Rectangle{{0, 0}, {10, 20}},
+        Rectangle{{10, 0}, {10, 20}}};
+    Region const b{
+        Rectangle{{0, 10}, {20, 10}},
+        Rectangle{{0, 0}, {20, 10}}};
+    Region const c{Rectangle{{0, 0}, {20, 19}}};
+
+    EXPECT_EQ(a, b);
+    EXPECT_NE(a, c);
+}
+
+TEST(RegionTest, contains_rectangle_covered_by_several_rectangles)
+{
+    Region const region{
+        Rectangle{{0, 0}, {50, 100}},
+        Rectangle{{50, 0}, {50, 60}},
+        Rectangle{{40, 60}, {60, 40}}};
+
+    EXPECT_TRUE(region.contains(Rectangle{{10, 10}, {80, 80}}));
+    EXPECT_TRUE(region.contains(Rectangle{{0, 0}, {100, 100}}));
+    EXPECT_FALSE(region.contains(Rectangle{{0, 0}, {101, 100}}));
+    EXPECT_FALSE(region.contains(Rectangle{{90, 90}, {10, 11}}));
+}
+
+TEST(RegionTest, does_not_contain_rectangle_across_a_gap)
+{
+    Region const region{
+        Rectangle{{0, 0}, {100, 40}},
+        Rectangle{{0, 60}, {100, 40}}};
+
+    EXPECT_FALSE(region.contains(Rectangle{{10, 10}, {10, 80}}));
+    EXPECT_TRUE(region.contains(Rectangle{{10, 10}, {10, 20}}));
+    EXPECT_TRUE(region.contains(Rectangle{{10, 70}, {10, 20}}));
+}
+
+TEST(RegionTest, contains_point)
+{
+    Region const region{
+        Rectangle{{0, 0}, {10, 10}},
+        Rectangle{{20, 20}, {10, 10}}};
+
+    EXPECT_TRUE(region.contains(Point{5, 5}));
+    EXPECT_TRUE(region.contains(Point{25, 25}));
+    EXPECT_FALSE(region.contains(Point{15, 15}));
+    EXPECT_FALSE(region.contains(Point{10, 5}));
+}
+
+TEST(RegionTest, overlaps)
+{
+    Region const region{
+        Rectangle{{0, 0}, {10, 10}},
+        Rectangle{{20, 20}, {10, 10}}};
+
+    EXPECT_TRUE(region.overlaps(Rectangle{{5, 5}, {20, 20}}));
+    EXPECT_FALSE(region.overlaps(Rectangle{{10, 10}, {10, 10}}));
+    EXPECT_FALSE(region.overlaps(Rectangle{{5, 5}, {0, 0}}));
+}
+
+TEST(RegionTest, subtracting_the_middle_leaves_a_frame)
+{
+    Region region{Rectangle{{0, 0}, {30, 30}}};
+    region.subtract(Rectangle{{10, 10}, {10, 10}});
+
+    EXPECT_THAT(region.rectangles(), ElementsAre(
+        Rectangle{{0, 0}, {30, 10}},
+        Rectangle{{0, 10}, {10, 10}},
+        Rectangle{{20, 10}, {10, 10}},
+        Rectangle{{0, 20}, {30, 10}}));
+    EXPECT_FALSE(region.contains(Point{15, 15}));
+}
+
+TEST(RegionTest, subtracting_everything_leaves_nothing)
+{
+    Region region{
+        Rectangle{{0, 0}, {10, 10}},
+        Rectangle{{20, 20}, {10, 10}}};
+    region.subtract(Region{
+        Rectangle{{0, 0}, {30, 15}},
+        Rectangle{{0, 15}, {30, 15}}});
+
+    EXPECT_TRUE(region.is_empty());
+}
+
+TEST(RegionTest, subtracting_a_disjoint_rectangle_changes_nothing)
+{
+    Region const original{Rectangle{{0, 0}, {10, 10}}};
+    Region region{original};
+    region.subtract(Rectangle{{10, 0}, {10, 10}});
+
+    EXPECT_EQ(original, region);
+}
+
+TEST(RegionTest, intersection)
+{
+    Region region{
+        Rectangle{{0, 0}, {10, 10}},
+        Rectangle{{20, 0}, {10, 10}}};
+
+    auto const clipped = region.intersection_with(Rectangle{{5, 5}, {20, 20}});
+    EXPECT_THAT(clipped.rectangles(), ElementsAre(
+        Rectangle{{5, 5}, {5, 5}},
+        Rectangle{{20, 5}, {5, 5}}));
+
+    region.intersect(Region{Rectangle{{100, 100}, {10, 10}}});
+    EXPECT_TRUE(region.is_empty());
+}
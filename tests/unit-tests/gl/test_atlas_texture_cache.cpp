@@ -0,0 +1,232 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/gl/atlas_texture_cache.h"
+#include "mir/test/doubles/mock_gl_buffer.h"
+#include "mir/test/doubles/mock_renderable.h"
+#include "mir/test/doubles/mock_gl.h"
+
+#include <GLES2/gl2ext.h>
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace mtd = mir::test::doubles;
+namespace mgl = mir::gl;
+namespace mg = mir::graphics;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+struct Surface
+{
+    Surface(geom::Size size, MirPixelFormat format = mir_pixel_format_argb_8888)
+        : buffer{std::make_shared<NiceMock<mtd::MockGLBuffer>>(
+              size, geom::Stride{size.width.as_int() * MIR_BYTES_PER_PIXEL(format)}, format)},
+          renderable{std::make_shared<NiceMock<mtd::MockRenderable>>()},
+          pixels(size.width.as_int() * size.height.as_int(), 0xff336699)
+    {
+        ON_CALL(*renderable, id()).WillByDefault(Return(renderable.get()));
+        ON_CALL(*renderable, buffer()).WillByDefault(Return(buffer));
+        ON_CALL(*renderable, screen_position()).WillByDefault(Return(geom::Rectangle{{10, 20}, size}));
+        ON_CALL(*buffer, read(_)).WillByDefault(
+            Invoke([this](std::function<void(unsigned char const*)> const& f)
+                {
+                    f(reinterpret_cast<unsigned char const*>(pixels.data()));
+                }));
+    }
+
+    std::shared_ptr<NiceMock<mtd::MockGLBuffer>> const buffer;
+    std::shared_ptr<NiceMock<mtd::MockRenderable>> const renderable;
+    std::vector<uint32_t> pixels;
+};
+
+struct AtlasTextureCache : Test
+{
+    AtlasTextureCache()
+    {
+        ON_CALL(mock_gl, glGenTextures(1, _))
+            .WillByDefault(Invoke([this](GLsizei, GLuint* id) { *id = ++textures_generated; }));
+    }
+
+    NiceMock<mtd::MockGL> mock_gl;
+    GLuint textures_generated{0};
+    float const texel = 1.0f / mgl::AtlasTextureCache::page_size;
+};
+}
+
+TEST_F(AtlasTextureCache, packs_small_renderables_into_one_texture)
+{
+    Surface const icon{{10, 10}};
+    Surface const tooltip{{20, 5}};
+
+    EXPECT_CALL(mock_gl, glTexImage2D(GL_TEXTURE_2D, 0, GL_BGRA_EXT, 1024, 1024, 0, GL_BGRA_EXT, GL_UNSIGNED_BYTE, nullptr));
+
+    mgl::AtlasTextureCache cache;
+    auto const icon_texture = cache.load(*icon.renderable);
+    auto const tooltip_texture = cache.load(*tooltip.renderable);
+
+    EXPECT_THAT(icon_texture, Eq(tooltip_texture));
+    EXPECT_THAT(textures_generated, Eq(1u));
+
+    auto const icon_region = cache.region(*icon.renderable);
+    EXPECT_THAT(icon_region.left, FloatEq(1 * texel));
+    EXPECT_THAT(icon_region.top, FloatEq(1 * texel));
+    EXPECT_THAT(icon_region.right, FloatEq(11 * texel));
+    EXPECT_THAT(icon_region.bottom, FloatEq(11 * texel));
+
+    auto const tooltip_region = cache.region(*tooltip.renderable);
+    EXPECT_THAT(tooltip_region.left, FloatEq(13 * texel));
+    EXPECT_THAT(tooltip_region.top, FloatEq(1 * texel));
+    EXPECT_THAT(tooltip_region.right, FloatEq(33 * texel));
+    EXPECT_THAT(tooltip_region.bottom, FloatEq(6 * texel));
+}
+
+TEST_F(AtlasTextureCache, uploads_pixels_with_a_border_repeating_their_edges)
+{
+    Surface surface{{2, 1}};
+    surface.pixels = {0x11111111, 0x22222222};
+
+    std::vector<uint32_t> uploaded;
+    EXPECT_CALL(mock_gl, glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 4, 3, GL_BGRA_EXT, GL_UNSIGNED_BYTE, _))
+        .WillOnce(WithArg<8>(Invoke([&uploaded](void const* pixels)
+            {
+                auto const begin = static_cast<uint32_t const*>(pixels);
+                uploaded.assign(begin, begin + 12);
+            })));
+
+    mgl::AtlasTextureCache cache;
+    cache.load(*surface.renderable);
+
+    EXPECT_THAT(uploaded, ElementsAre(
+        0x11111111, 0x11111111, 0x22222222, 0x22222222,
+        0x11111111, 0x11111111, 0x22222222, 0x22222222,
+        0x11111111, 0x11111111, 0x22222222, 0x22222222));
+    EXPECT_THAT(cache.uploaded_bytes(), Eq(48u));
+}
+
+TEST_F(AtlasTextureCache, uploads_only_when_the_buffer_changes_or_textures_are_invalidated)
+{
+    Surface const surface{{10, 10}};
+
+    EXPECT_CALL(mock_gl, glTexSubImage2D(_, _, _, _, _, _, _, _, _)).Times(3);
+    EXPECT_CALL(*surface.buffer, id())
+        .WillOnce(Return(mg::BufferID{1}))
+        .WillOnce(Return(mg::BufferID{1}))
+        .WillRepeatedly(Return(mg::BufferID{2}));
+
+    mgl::AtlasTextureCache cache;
+    cache.load(*surface.renderable);
+    cache.drop_unused();
+    cache.load(*surface.renderable);
+    cache.drop_unused();
+    cache.load(*surface.renderable);
+    cache.drop_unused();
+    cache.invalidate();
+    cache.load(*surface.renderable);
+}
+
+TEST_F(AtlasTextureCache, leaves_large_and_scaled_renderables_to_their_own_textures)
+{
+    Surface const window{{640, 480}};
+    Surface const scaled{{10, 10}};
+    ON_CALL(*scaled.renderable, screen_position()).WillByDefault(Return(geom::Rectangle{{0, 0}, {20, 20}}));
+
+    EXPECT_CALL(mock_gl, glTexSubImage2D(_, _, _, _, _, _, _, _, _)).Times(0);
+    EXPECT_CALL(*window.buffer, bind());
+    EXPECT_CALL(*scaled.buffer, bind());
+
+    mgl::AtlasTextureCache cache;
+    auto const window_texture = cache.load(*window.renderable);
+    auto const scaled_texture = cache.load(*scaled.renderable);
+
+    EXPECT_THAT(window_texture, Ne(scaled_texture));
+
+    auto const region = cache.region(*scaled.renderable);
+    EXPECT_THAT(region.left, FloatEq(0.0f));
+    EXPECT_THAT(region.top, FloatEq(0.0f));
+    EXPECT_THAT(region.right, FloatEq(1.0f));
+    EXPECT_THAT(region.bottom, FloatEq(1.0f));
+}
+
+TEST_F(AtlasTextureCache, reuses_the_space_of_renderables_no_longer_drawn)
+{
+    Surface const first{{10, 10}};
+    Surface const second{{10, 10}};
+    Surface const third{{10, 10}};
+
+    mgl::AtlasTextureCache cache;
+    cache.load(*first.renderable);
+    cache.load(*second.renderable);
+    auto const first_region = cache.region(*first.renderable);
+    cache.drop_unused();
+
+    cache.load(*second.renderable);
+    cache.drop_unused();
+
+    cache.load(*second.renderable);
+    cache.load(*third.renderable);
+
+    EXPECT_THAT(cache.region(*third.renderable).left, FloatEq(first_region.left));
+    EXPECT_THAT(cache.region(*third.renderable).top, FloatEq(first_region.top));
+}
+
+TEST_F(AtlasTextureCache, deletes_atlas_textures_once_nothing_drawn_is_on_them)
+{
+    Surface const surface{{10, 10}};
+
+    mgl::AtlasTextureCache cache;
+    cache.load(*surface.renderable);
+    cache.drop_unused();
+
+    EXPECT_CALL(mock_gl, glDeleteTextures(1, Pointee(1u)));
+
+    cache.drop_unused();
+}
+
+TEST_F(AtlasTextureCache, opens_more_atlas_textures_when_full_then_leaves_the_rest_to_their_own)
+{
+    int const per_page = 9;     // 3 x 3 slots of 258 x 258 (with their borders)
+    std::vector<std::unique_ptr<Surface>> surfaces;
+    for (auto i = 0; i != mgl::AtlasTextureCache::max_pages * per_page + 1; ++i)
+        surfaces.push_back(std::make_unique<Surface>(geom::Size{256, 256}));
+
+    mgl::AtlasTextureCache cache;
+    std::vector<std::shared_ptr<mgl::Texture>> textures;
+    for (auto const& surface : surfaces)
+        textures.push_back(cache.load(*surface->renderable));
+
+    EXPECT_THAT(textures[per_page - 1], Eq(textures[0]));
+    EXPECT_THAT(textures[per_page], Ne(textures[0]));
+    EXPECT_THAT(textures_generated, Eq(static_cast<GLuint>(mgl::AtlasTextureCache::max_pages + 1)));
+    EXPECT_THAT(cache.region(*surfaces.back()->renderable).right, FloatEq(1.0f));
+}
+
+TEST_F(AtlasTextureCache, keeps_pixel_formats_on_separate_textures)
+{
+    Surface const argb{{10, 10}, mir_pixel_format_argb_8888};
+    Surface const rgb565{{10, 10}, mir_pixel_format_rgb_565};
+
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, GL_BGRA_EXT, _, _, _, GL_BGRA_EXT, GL_UNSIGNED_BYTE, _));
+    EXPECT_CALL(mock_gl, glTexImage2D(_, _, GL_RGB, _, _, _, GL_RGB, GL_UNSIGNED_SHORT_5_6_5, _));
+
+    mgl::AtlasTextureCache cache;
+
+    EXPECT_THAT(cache.load(*argb.renderable), Ne(cache.load(*rgb565.renderable)));
+}
@@ -21,6 +21,7 @@
 #include "mir/test/doubles/mock_gl_buffer.h"
 #include "mir/test/doubles/mock_renderable.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/renderer/gl/incremental_texture_source.h"
 #include <gtest/gtest.h>
 
 namespace mtd=mir::test::doubles;
@@ -30,6 +31,12 @@ namespace mg=mir::graphics;
 namespace
 {
 
+struct MockIncrementalGLBuffer : mtd::MockGLBuffer,
+                                 mir::renderer::gl::IncrementalTextureSource
+{
+    MOCK_METHOD1(bind_over, size_t(mg::BufferID));
+};
+
 class RecentlyUsedCache : public testing::Test
 {
 public:
@@ -140,3 +147,73 @@ TEST_F(RecentlyUsedCache, invalidated_buffers_are_reloaded)
     cache.invalidate();
     cache.load(*renderable);
 }
+
+TEST_F(RecentlyUsedCache, incremental_buffers_update_what_the_texture_holds)
+{
+    using namespace testing;
+    auto const incremental_buffer = std::make_shared<NiceMock<MockIncrementalGLBuffer>>();
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(incremental_buffer));
+    EXPECT_CALL(*incremental_buffer, id())
+        .WillOnce(Return(mg::BufferID(1)))
+        .WillOnce(Return(mg::BufferID(2)))
+        .WillOnce(Return(mg::BufferID(3)));
+
+    {
+        InSequence seq;
+        EXPECT_CALL(*incremental_buffer, bind());
+        EXPECT_CALL(*incremental_buffer, bind_over(mg::BufferID(1)));
+        EXPECT_CALL(*incremental_buffer, bind());
+    }
+
+    mgl::RecentlyUsedCache cache;
+    cache.load(*renderable);
+    cache.drop_unused();
+
+    cache.load(*renderable);
+    cache.drop_unused();
+
+    // Nothing is known about the texture after invalidation
+    cache.invalidate();
+    cache.load(*renderable);
+    cache.drop_unused();
+}
+
+TEST_F(RecentlyUsedCache, counts_the_bytes_copied_to_textures)
+{
+    using namespace testing;
+    auto const incremental_buffer = std::make_shared<NiceMock<MockIncrementalGLBuffer>>();
+    ON_CALL(*renderable, buffer())
+        .WillByDefault(Return(incremental_buffer));
+    ON_CALL(*incremental_buffer, size())
+        .WillByDefault(Return(mir::geometry::Size{16, 8}));
+    ON_CALL(*incremental_buffer, pixel_format())
+        .WillByDefault(Return(mir_pixel_format_argb_8888));
+    EXPECT_CALL(*incremental_buffer, id())
+        .WillOnce(Return(mg::BufferID(1)))
+        .WillOnce(Return(mg::BufferID(2)))
+        .WillOnce(Return(mg::BufferID(2)));
+    EXPECT_CALL(*incremental_buffer, bind_over(mg::BufferID(1)))
+        .WillOnce(Return(128));
+
+    mgl::RecentlyUsedCache cache;
+    EXPECT_THAT(cache.uploaded_bytes(), Eq(0u));
+
+    cache.load(*renderable);
+    EXPECT_THAT(cache.uploaded_bytes(), Eq(64u * 8));
+
+    cache.load(*renderable);
+    EXPECT_THAT(cache.uploaded_bytes(), Eq(64u * 8 + 128));
+
+    // Nothing new to upload
+    cache.load(*renderable);
+    EXPECT_THAT(cache.uploaded_bytes(), Eq(64u * 8 + 128));
+}
+
+TEST_F(RecentlyUsedCache, does_not_count_buffers_bound_without_copying)
+{
+    mgl::RecentlyUsedCache cache;
+    cache.load(*renderable);
+
+    EXPECT_THAT(cache.uploaded_bytes(), testing::Eq(0u));
+}
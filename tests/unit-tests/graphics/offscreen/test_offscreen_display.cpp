@@ -3,10 +3,19 @@
 #include "src/server/graphics/offscreen/display.h"
 #include "mir/graphics/default_display_configuration_policy.h"
 #include "mir/renderer/gl/render_target.h"
+#include "mir/renderer/sw/pixel_target.h"
 #include "src/server/report/null_report_factory.h"
+#include "src/server/compositor/default_display_buffer_compositor_factory.h"
+#include "mir/compositor/display_buffer_compositor.h"
+#include "src/renderers/sw/renderer_factory.h"
+
+#include "mir/geometry/displacement.h"
 
 #include "mir/test/doubles/mock_egl.h"
 #include "mir/test/doubles/mock_gl.h"
+#include "mir/test/doubles/fake_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_scene_element.h"
 #include "mir/test/as_render_target.h"
 
 #include <gmock/gmock.h>
@@ -19,6 +28,9 @@ namespace mgo=mir::graphics::offscreen;
 namespace mtd=mir::test::doubles;
 namespace mr = mir::report;
 namespace mt = mir::test;
+namespace mc = mir::compositor;
+namespace mrs = mir::renderer::software;
+namespace geom = mir::geometry;
 
 namespace
 {
@@ -173,3 +185,78 @@ TEST_F(OffscreenDisplayTest, restores_previous_state_on_fbo_setup_failure)
             mr::null_display_report());
     }, std::runtime_error);
 }
+
+TEST_F(OffscreenDisplayTest, swaps_software_frames_without_gl)
+{
+    using namespace ::testing;
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report()};
+
+    EXPECT_CALL(mock_gl, glFinish()).Times(0);
+
+    display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+        group.for_each_display_buffer([&](mg::DisplayBuffer& db) {
+            auto const target = dynamic_cast<mrs::PixelTarget*>(db.native_display_buffer());
+            ASSERT_THAT(target, NotNull());
+
+            EXPECT_THAT(target->size(), Eq(db.view_area().size));
+            EXPECT_THAT(target->buffer_age(), Eq(0u));
+
+            target->pixels()[0] = 0xff;
+            target->swap_buffers();
+
+            EXPECT_THAT(target->buffer_age(), Eq(1u));
+            EXPECT_THAT(target->pixels()[0], Eq(0xff));
+        });
+    });
+}
+
+TEST_F(OffscreenDisplayTest, composites_scene_with_the_software_renderer)
+{
+    using namespace ::testing;
+    uint32_t const red = 0xffff0000;
+    uint32_t const black = 0xff000000;
+    geom::Size const window_size{10, 10};
+
+    mgo::Display display{
+        native_display,
+        std::make_shared<mg::CloneDisplayConfigurationPolicy>(),
+        mr::null_display_report()};
+    mc::DefaultDisplayBufferCompositorFactory compositor_factory{
+        std::make_shared<mrs::RendererFactory>(),
+        mr::null_compositor_report()};
+
+    auto const buffer = std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{window_size, mir_pixel_format_xrgb_8888, mg::BufferUsage::software});
+    std::vector<uint32_t> const content(window_size.width.as_int() * window_size.height.as_int(), red);
+    buffer->write(reinterpret_cast<unsigned char const*>(content.data()), content.size() * 4);
+
+    int composited = 0;
+    display.for_each_display_sync_group([&](mg::DisplaySyncGroup& group) {
+        group.for_each_display_buffer([&](mg::DisplayBuffer& db) {
+            auto const origin = db.view_area().top_left;
+            auto const window = std::make_shared<mtd::FakeRenderable>(
+                geom::Rectangle{origin + geom::Displacement{5, 5}, window_size});
+            window->set_buffer(buffer);
+
+            auto const compositor = compositor_factory.create_compositor_for(db);
+            compositor->composite(mc::SceneElementSequence{std::make_shared<mtd::StubSceneElement>(window)});
+
+            auto const target = dynamic_cast<mrs::PixelTarget*>(db.native_display_buffer());
+            ASSERT_THAT(target, NotNull());
+            auto const stride = target->stride().as_int();
+            auto const pixel_at = [&](int x, int y)
+                { return *reinterpret_cast<uint32_t const*>(target->pixels() + y * stride + x * 4); };
+
+            EXPECT_THAT(pixel_at(4, 4), Eq(black));
+            EXPECT_THAT(pixel_at(5, 5), Eq(red));
+            EXPECT_THAT(pixel_at(14, 14), Eq(red));
+            EXPECT_THAT(pixel_at(15, 15), Eq(black));
+            ++composited;
+        });
+    });
+
+    EXPECT_TRUE(composited);
+}
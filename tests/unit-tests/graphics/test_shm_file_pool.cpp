@@ -0,0 +1,141 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/platforms/common/server/shm_file_pool.h"
+#include "mir/shm_file.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <algorithm>
+#include <memory>
+#include <cstring>
+#include <unistd.h>
+
+namespace mgc = mir::graphics::common;
+using namespace testing;
+
+namespace
+{
+size_t const page_size = sysconf(_SC_PAGESIZE);
+size_t const window_size = 800 * 600 * 4;
+
+struct ShmFilePool : Test
+{
+    mgc::ShmFilePool pool{64 * 1024 * 1024};
+};
+}
+
+TEST_F(ShmFilePool, size_classes_are_whole_pages_and_waste_at_most_a_quarter_of_larger_sizes)
+{
+    for (size_t size = 1; size < 64 * 1024 * 1024; size = size * 9 / 8 + 1)
+    {
+        auto const size_class = mgc::ShmFilePool::size_class(size);
+
+        EXPECT_THAT(size_class, Ge(size));
+        EXPECT_THAT(size_class % page_size, Eq(0u));
+        if (size >= 4 * page_size)
+            EXPECT_THAT(size_class, Le(size + size / 4));
+        else
+            EXPECT_THAT(size_class, Lt(size + page_size));
+    }
+}
+
+TEST_F(ShmFilePool, nearby_sizes_share_a_size_class)
+{
+    EXPECT_THAT(mgc::ShmFilePool::size_class(801 * 600 * 4), Eq(mgc::ShmFilePool::size_class(window_size)));
+}
+
+TEST_F(ShmFilePool, reuses_released_files_of_the_same_size_class)
+{
+    void* released_mapping;
+    {
+        auto const file = pool.take(window_size);
+        released_mapping = file->base_ptr();
+    }
+
+    EXPECT_THAT(pool.size_in_bytes(), Eq(mgc::ShmFilePool::size_class(window_size)));
+
+    auto const file = pool.take(801 * 600 * 4);
+
+    EXPECT_THAT(file->base_ptr(), Eq(released_mapping));
+    EXPECT_THAT(pool.size_in_bytes(), Eq(0u));
+}
+
+TEST_F(ShmFilePool, does_not_reuse_files_of_another_size_class)
+{
+    pool.take(window_size);
+
+    auto const file = pool.take(2 * window_size);
+
+    EXPECT_THAT(pool.size_in_bytes(), Eq(mgc::ShmFilePool::size_class(window_size)));
+}
+
+TEST_F(ShmFilePool, clears_reused_files)
+{
+    {
+        auto const file = pool.take(window_size);
+        memset(file->base_ptr(), 0xff, window_size);
+    }
+
+    auto const file = pool.take(window_size);
+    auto const pixels = static_cast<unsigned char const*>(file->base_ptr());
+
+    EXPECT_TRUE(std::all_of(pixels, pixels + window_size, [](unsigned char c) { return c == 0; }));
+}
+
+TEST_F(ShmFilePool, frees_least_recently_released_files_beyond_its_budget)
+{
+    auto const size_class = mgc::ShmFilePool::size_class(window_size);
+    mgc::ShmFilePool small_pool{2 * size_class};
+
+    void* mappings[3];
+    {
+        auto const first = small_pool.take(window_size);
+        auto const second = small_pool.take(window_size);
+        auto const third = small_pool.take(window_size);
+        mappings[0] = first->base_ptr();
+        mappings[1] = second->base_ptr();
+        mappings[2] = third->base_ptr();
+    }   // Released third, second, then first
+
+    EXPECT_THAT(small_pool.size_in_bytes(), Eq(2 * size_class));
+
+    auto const first = small_pool.take(window_size);
+    auto const second = small_pool.take(window_size);
+
+    EXPECT_THAT(first->base_ptr(), Eq(mappings[0]));
+    EXPECT_THAT(second->base_ptr(), Eq(mappings[1]));
+}
+
+TEST_F(ShmFilePool, keeps_nothing_without_a_budget)
+{
+    mgc::ShmFilePool no_pool{0};
+
+    no_pool.take(window_size);
+
+    EXPECT_THAT(no_pool.size_in_bytes(), Eq(0u));
+}
+
+TEST_F(ShmFilePool, files_can_outlive_the_pool)
+{
+    auto pool = std::make_unique<mgc::ShmFilePool>(64 * 1024 * 1024);
+    auto const file = pool->take(window_size);
+
+    pool.reset();
+
+    memset(file->base_ptr(), 0xff, window_size);
+}
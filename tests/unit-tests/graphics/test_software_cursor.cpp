@@ -45,6 +45,7 @@ struct MockInputScene : mtd::StubInputScene
                  void(std::weak_ptr<mg::Renderable> const&));
 
     MOCK_METHOD0(emit_scene_changed, void());
+    MOCK_METHOD1(emit_scene_damaged, void(geom::Rectangle const&));
 };
 
 struct StubCursorImage : mg::CursorImage
@@ -189,13 +190,32 @@ TEST_F(SoftwareCursor, moves_scene_renderable_offset_by_hotspot_when_moved)
                 Eq(new_position - stub_cursor_image.hotspot()));
 }
 
-TEST_F(SoftwareCursor, notifies_scene_when_moving)
+TEST_F(SoftwareCursor, damages_only_old_and_new_cursor_areas_when_moving)
 {
     using namespace testing;
 
-    EXPECT_CALL(mock_input_scene, emit_scene_changed());
+    auto const size = stub_cursor_image.size();
+    auto const hotspot = stub_cursor_image.hotspot();
 
     cursor.show(stub_cursor_image);
+
+    EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(geom::Rectangle{geom::Point{0,0} - hotspot, size}));
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(geom::Rectangle{geom::Point{22,23} - hotspot, size}));
+
+    cursor.move_to({22,23});
+}
+
+TEST_F(SoftwareCursor, does_not_notify_scene_when_not_moving)
+{
+    using namespace testing;
+
+    cursor.show(stub_cursor_image);
+    cursor.move_to({22,23});
+
+    EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
+
     cursor.move_to({22,23});
 }
 
@@ -246,6 +266,7 @@ TEST_F(SoftwareCursor, does_not_hide_or_move_when_already_hidden)
 
     EXPECT_CALL(mock_input_scene, remove_input_visualization(_)).Times(0);
     EXPECT_CALL(mock_input_scene, emit_scene_changed()).Times(0);
+    EXPECT_CALL(mock_input_scene, emit_scene_damaged(_)).Times(0);
 
     // Already hidden, nothing should happen
     cursor.hide();
@@ -18,6 +18,7 @@
 
 #include "mir/events/event_builders.h"
 #include "mir/events/event_private.h" // only needed to validate motion_up/down mapping
+#include "mir_toolkit/mir_blob.h"
 
 #include <gtest/gtest.h>
 #include <gmock/gmock.h>
@@ -283,3 +284,47 @@ TEST_F(InputEventBuilder, when_deserialized_input_device_state_event_has_supplie
         EXPECT_THAT(mir_input_device_state_event_device_pressed_keys_for_index(ids_event, 2, i), Eq(pressed_keys[i]));
     }
 }
+
+TEST_F(InputEventBuilder, deserialized_pointer_event_has_supplied_properties)
+{
+    auto const action = mir_pointer_action_motion;
+    auto const buttons = mir_pointer_button_primary;
+    auto const x = 3.9f, y = 7.4f, hscroll = .9f, vscroll = .3f, dx = 1.5f, dy = -2.5f;
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        action, buttons, x, y, hscroll, vscroll, dx, dy);
+
+    auto const deserialized_event = MirEvent::deserialize(MirEvent::serialize(ev.get()));
+
+    ASSERT_THAT(mir_event_get_type(deserialized_event.get()), Eq(mir_event_type_input));
+    auto const pev = mir_input_event_get_pointer_event(mir_event_get_input_event(deserialized_event.get()));
+    EXPECT_THAT(mir_pointer_event_action(pev), Eq(action));
+    EXPECT_TRUE(mir_pointer_event_button_state(pev, mir_pointer_button_primary));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_x), Eq(x));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_y), Eq(y));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_x), Eq(dx));
+    EXPECT_THAT(mir_pointer_event_axis_value(pev, mir_pointer_axis_relative_y), Eq(dy));
+}
+
+TEST_F(InputEventBuilder, events_too_big_for_their_inline_storage_survive_copying_and_serialization)
+{
+    std::vector<uint8_t> handle(16*1024);
+    for (size_t i = 0; i != handle.size(); ++i)
+        handle[i] = i % 251;
+
+    auto ev = mev::make_event(device_id, timestamp, cookie, modifiers,
+        mir_pointer_action_motion, 0, 1.0f, 2.0f, 0.0f, 0.0f, 0.0f, 0.0f);
+    mev::set_drag_and_drop_handle(*ev, handle);
+
+    auto const copy = mev::clone_event(*ev);
+    ev.reset();
+    auto const deserialized_event = MirEvent::deserialize(MirEvent::serialize(copy.get()));
+
+    std::unique_ptr<MirBlob, decltype(&mir_blob_release)> const blob{
+        deserialized_event->to_input()->to_pointer()->dnd_handle(),
+        &mir_blob_release};
+
+    ASSERT_THAT(blob, NotNull());
+    ASSERT_THAT(mir_blob_size(blob.get()), Eq(handle.size()));
+    auto const data = static_cast<uint8_t const*>(mir_blob_data(blob.get()));
+    EXPECT_THAT(std::vector<uint8_t>(data, data + handle.size()), Eq(handle));
+}
@@ -0,0 +1,233 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/input/input_trace.h"
+
+#include "mir/events/event_builders.h"
+#include "mir/input/input_device_info.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <system_error>
+
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace mi = mir::input;
+namespace mev = mir::events;
+
+using namespace ::testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct InputTraceRecorder : Test
+{
+    InputTraceRecorder()
+    {
+        char name[] = "/tmp/mir_input_trace_XXXXXX";
+        if (!mkdtemp(name))
+            throw std::system_error{errno, std::system_category(), "Failed to create temporary directory"};
+        dir = name;
+        path = dir + "/trace";
+    }
+
+    ~InputTraceRecorder()
+    {
+        unlink(path.c_str());
+        rmdir(dir.c_str());
+    }
+
+    auto written() const -> std::vector<char>
+    {
+        std::ifstream file{path, std::ios::binary};
+        return {std::istreambuf_iterator<char>{file}, std::istreambuf_iterator<char>{}};
+    }
+
+    auto records() const -> std::vector<mi::InputTraceRecord>
+    {
+        mi::InputTrace const trace{path};
+        return {trace.begin(), trace.end()};
+    }
+
+    auto key(MirKeyboardAction action, int scan_code, std::chrono::nanoseconds time) -> mir::EventUPtr
+    {
+        return mev::make_event(
+            device_id, time, std::vector<uint8_t>{}, action, 0, scan_code, mir_input_event_modifier_none);
+    }
+
+    std::string dir;
+    std::string path;
+    MirInputDeviceId const device_id{7};
+};
+}
+
+TEST_F(InputTraceRecorder, writes_a_header_on_creation)
+{
+    mi::InputTraceRecorder recorder{path};
+
+    auto const bytes = written();
+    ASSERT_THAT(bytes.size(), Eq(sizeof(mi::InputTraceHeader)));
+
+    mi::InputTraceHeader header;
+    memcpy(&header, bytes.data(), sizeof header);
+    EXPECT_THAT(std::string(header.magic, sizeof header.magic), Eq("MIRINPUT"));
+    EXPECT_THAT(header.version, Eq(mi::InputTraceHeader::current_version));
+    EXPECT_THAT(header.record_size, Eq(sizeof(mi::InputTraceRecord)));
+}
+
+TEST_F(InputTraceRecorder, throws_if_the_file_cannot_be_opened)
+{
+    EXPECT_THROW(
+        mi::InputTraceRecorder{"/this/path/does/not/exist"},
+        std::system_error);
+}
+
+TEST_F(InputTraceRecorder, records_devices_and_events_in_order)
+{
+    {
+        mi::InputTraceRecorder recorder{path};
+        recorder.device_added(device_id, mi::InputDeviceInfo{"keyboard", "keyboard-uid", mi::DeviceCapability::keyboard});
+        recorder.record(*mev::make_event(
+            device_id, 5ns, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 30, mir_input_event_modifier_none));
+        recorder.device_removed(device_id);
+    }
+
+    auto const trace = records();
+    ASSERT_THAT(trace.size(), Eq(3u));
+
+    EXPECT_THAT(trace[0].kind, Eq(mi::InputTraceRecord::device_added));
+    EXPECT_THAT(trace[0].device_id, Eq(device_id));
+    EXPECT_THAT(trace[0].device.capabilities, Eq(mi::DeviceCapabilities{mi::DeviceCapability::keyboard}.value()));
+    EXPECT_THAT(trace[0].device.name, StrEq("keyboard"));
+
+    EXPECT_THAT(trace[1].kind, Eq(mi::InputTraceRecord::key_event));
+    EXPECT_THAT(trace[1].event_time_ns, Eq(5));
+    EXPECT_THAT(trace[1].action, Eq(mir_keyboard_action_down));
+    EXPECT_THAT(trace[1].key.scan_code, Eq(30));
+
+    EXPECT_THAT(trace[2].kind, Eq(mi::InputTraceRecord::device_removed));
+}
+
+TEST_F(InputTraceRecorder, records_a_record_per_touch_point)
+{
+    {
+        mi::InputTraceRecorder recorder{path};
+        auto touch = mev::make_event(device_id, 1ns, std::vector<uint8_t>{}, mir_input_event_modifier_none);
+        mev::add_touch(*touch, 0, mir_touch_action_change, mir_touch_tooltype_finger, 10, 20, 1, 1, 1, 1);
+        mev::add_touch(*touch, 1, mir_touch_action_down, mir_touch_tooltype_finger, 30, 40, 1, 1, 1, 1);
+        recorder.record(*touch);
+    }
+
+    auto const trace = records();
+    ASSERT_THAT(trace.size(), Eq(2u));
+
+    EXPECT_THAT(trace[0].kind, Eq(mi::InputTraceRecord::touch_point));
+    EXPECT_THAT(trace[0].point_count, Eq(2));
+    EXPECT_THAT(trace[0].touch.x, FloatEq(10));
+    EXPECT_THAT(trace[1].point, Eq(1));
+    EXPECT_THAT(trace[1].action, Eq(mir_touch_action_down));
+    EXPECT_THAT(trace[1].touch.id, Eq(1));
+}
+
+TEST_F(InputTraceRecorder, creates_the_file_readable_only_by_its_owner)
+{
+    mi::InputTraceRecorder recorder{path};
+
+    struct stat info;
+    ASSERT_THAT(stat(path.c_str(), &info), Eq(0));
+    EXPECT_THAT(info.st_mode & 0777, Eq(0600u));
+}
+
+TEST_F(InputTraceRecorder, makes_an_existing_file_readable_only_by_its_owner)
+{
+    close(open(path.c_str(), O_WRONLY | O_CREAT, 0644));
+    chmod(path.c_str(), 0644);
+
+    mi::InputTraceRecorder recorder{path};
+
+    struct stat info;
+    ASSERT_THAT(stat(path.c_str(), &info), Eq(0));
+    EXPECT_THAT(info.st_mode & 0777, Eq(0600u));
+}
+
+TEST_F(InputTraceRecorder, recorded_events_replay_in_the_order_they_came)
+{
+    int const key_count = 1000;     // Many batches' worth
+
+    {
+        mi::InputTraceRecorder recorder{path};
+        recorder.device_added(device_id, mi::InputDeviceInfo{"keyboard", "keyboard-uid", mi::DeviceCapability::keyboard});
+        for (int i = 0; i != key_count; ++i)
+            recorder.record(*key(i % 2 ? mir_keyboard_action_up : mir_keyboard_action_down, i, std::chrono::nanoseconds{i}));
+        recorder.device_removed(device_id);
+    }
+
+    mi::InputTrace const trace{path};
+    ASSERT_THAT(trace.end() - trace.begin(), Eq(key_count + 2));
+
+    auto record = trace.begin();
+    EXPECT_THAT(record->kind, Eq(mi::InputTraceRecord::device_added));
+    EXPECT_THAT(record->device.name, StrEq("keyboard"));
+
+    for (int i = 0; i != key_count; ++i)
+    {
+        ++record;
+        EXPECT_THAT(record->kind, Eq(mi::InputTraceRecord::key_event));
+        EXPECT_THAT(record->device_id, Eq(device_id));
+        EXPECT_THAT(record->event_time_ns, Eq(i));
+        EXPECT_THAT(record->action, Eq(i % 2 ? mir_keyboard_action_up : mir_keyboard_action_down));
+        EXPECT_THAT(record->key.scan_code, Eq(i));
+    }
+
+    EXPECT_THAT((++record)->kind, Eq(mi::InputTraceRecord::device_removed));
+}
+
+TEST_F(InputTraceRecorder, cuts_a_failed_write_back_to_the_last_whole_record)
+{
+    size_t const batch_bytes = 64 * sizeof(mi::InputTraceRecord);
+    auto const limit = sizeof(mi::InputTraceHeader) + batch_bytes + batch_bytes / 2 + 10;
+
+    // Let the file grow past one batch and part of the way through the next
+    auto const old_handler = signal(SIGXFSZ, SIG_IGN);
+    rlimit old_limit;
+    getrlimit(RLIMIT_FSIZE, &old_limit);
+    rlimit new_limit{limit, old_limit.rlim_max};
+    setrlimit(RLIMIT_FSIZE, &new_limit);
+
+    {
+        mi::InputTraceRecorder recorder{path};
+        for (int i = 0; i != 128; ++i)
+            recorder.record(*key(mir_keyboard_action_down, i, std::chrono::nanoseconds{i}));
+    }
+
+    setrlimit(RLIMIT_FSIZE, &old_limit);
+    signal(SIGXFSZ, old_handler);
+
+    EXPECT_THAT(written().size(), Eq(sizeof(mi::InputTraceHeader) + batch_bytes));
+
+    auto const trace = records();
+    ASSERT_THAT(trace.size(), Eq(64u));
+    EXPECT_THAT(trace.back().key.scan_code, Eq(63));
+}
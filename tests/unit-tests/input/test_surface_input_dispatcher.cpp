@@ -33,6 +33,8 @@
 
 #include <mutex>
 #include <algorithm>
+#include <future>
+#include <thread>
 
 namespace ms = mir::scene;
 namespace mi = mir::input;
@@ -547,3 +549,34 @@ TEST_F(SurfaceInputDispatcher, touch_gesture_target_may_vanish_but_things_contin
     EXPECT_FALSE(dispatcher.dispatch(toucher.release_at({0, 0})));
     EXPECT_TRUE(dispatcher.dispatch(toucher.touch_at({0, 0})));
 }
+
+TEST_F(SurfaceInputDispatcher, scene_changes_do_not_wait_for_dispatch_and_apply_once_it_is_done)
+{
+    auto surface = scene.add_surface();
+
+    std::promise<void> delivering;
+    std::promise<void> delivered;
+    auto const delivery_done = delivered.get_future().share();
+    EXPECT_CALL(*surface, consume(_)).Times(1)
+        .WillOnce(InvokeWithoutArgs([&]
+            {
+                delivering.set_value();
+                delivery_done.wait();
+            }));
+
+    dispatcher.start();
+    dispatcher.set_focus(surface);
+
+    FakeKeyboard keyboard;
+    std::thread input_thread{[&] { dispatcher.dispatch(keyboard.press()); }};
+    delivering.get_future().wait();
+
+    auto removing = std::async(std::launch::async, [&] { scene.remove_surface(surface); });
+    EXPECT_THAT(removing.wait_for(std::chrono::seconds{5}), Eq(std::future_status::ready));
+
+    delivered.set_value();
+    input_thread.join();
+
+    // The surface was removed, so it no longer has focus
+    EXPECT_FALSE(dispatcher.dispatch(keyboard.release()));
+}
@@ -177,3 +177,13 @@ TEST_F(MessageProcessorReport, logs_incomplete_calls_on_destruction)
     report.received_invocation(this, 1, __PRETTY_FUNCTION__);
 }
 
+
+TEST_F(MessageProcessorReport, logs_send_queue_depth)
+{
+    EXPECT_CALL(logger, log(
+        ml::Severity::informational,
+        EndsWith("messages waiting for the client=42"),
+        "frontend::MessageProcessor")).Times(1);
+
+    report.send_queue_depth(this, 42);
+}
@@ -0,0 +1,104 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/logging/async_logger.h"
+
+#include "mir/test/signal.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace ml  = mir::logging;
+namespace mrl = mir::report::logging;
+namespace mt = mir::test;
+using namespace testing;
+
+namespace
+{
+class RecordingLogger : public ml::Logger
+{
+public:
+    void log(ml::Severity, std::string const& message, std::string const&) override
+    {
+        if (block)
+            released.wait_for(std::chrono::seconds{5});
+
+        std::lock_guard<std::mutex> lock{mutex};
+        messages.push_back(message);
+        threads.push_back(std::this_thread::get_id());
+    }
+
+    bool block{false};
+    mt::Signal released;
+
+    std::mutex mutex;
+    std::vector<std::string> messages;
+    std::vector<std::thread::id> threads;
+};
+
+struct AsyncLogger : Test
+{
+    std::shared_ptr<RecordingLogger> const sink{std::make_shared<RecordingLogger>()};
+};
+}
+
+TEST_F(AsyncLogger, passes_messages_on_in_order_from_another_thread)
+{
+    {
+        mrl::AsyncLogger logger{sink, 0};
+        logger.log(ml::Severity::informational, "one", "test");
+        logger.log(ml::Severity::informational, "two", "test");
+        logger.log(ml::Severity::error, "three", "test");
+    }
+
+    EXPECT_THAT(sink->messages, ElementsAre("one", "two", "three"));
+    EXPECT_THAT(sink->threads, Each(Ne(std::this_thread::get_id())));
+}
+
+TEST_F(AsyncLogger, limits_how_often_a_message_is_logged)
+{
+    unsigned const max_per_second = 3;
+    {
+        mrl::AsyncLogger logger{sink, max_per_second};
+        for (int i = 0; i != 100; ++i)
+            logger.log(ml::Severity::debug, "frame " + std::to_string(i) + " took too long", "test");
+        logger.log(ml::Severity::debug, "something else", "test");
+    }
+
+    // We might have crossed into the next second part way through
+    EXPECT_THAT(sink->messages.size(), Le(2 * max_per_second + 1));
+    EXPECT_THAT(sink->messages, Contains("frame 0 took too long"));
+    EXPECT_THAT(sink->messages, Contains("something else"));
+}
+
+TEST_F(AsyncLogger, drops_messages_rather_than_waiting_and_says_how_many)
+{
+    sink->block = true;
+    {
+        mrl::AsyncLogger logger{sink, 0};
+        for (int i = 0; i != 5000; ++i)
+            logger.log(ml::Severity::debug, "message", "test");
+        sink->released.raise();
+    }
+
+    EXPECT_THAT(sink->messages.size(), Lt(5000u));
+    EXPECT_THAT(sink->messages, Contains(HasSubstr("were not logged")));
+}
@@ -22,7 +22,10 @@
 
 #include <gtest/gtest.h>
 #include <string>
+#include <vector>
+#include <functional>
 #include <cstdio>
+#include <cstring>
 
 using namespace std;
 
@@ -39,6 +42,12 @@ public:
     void log(ml::Severity, string const& message, string const&)
     {
         last = message;
+        all.push_back(message);
+    }
+    void for_each_message(function<void(string const&)> const& f) const
+    {
+        for (auto const& message : all)
+            f(message);
     }
     string const& last_message() const
     {
@@ -55,6 +64,7 @@ public:
     }
 private:
     string last;
+    vector<string> all;
 };
 
 struct LoggingCompositorReport : ::testing::Test
@@ -189,3 +199,88 @@ TEST_F(LoggingCompositorReport, bypass_has_no_render_time)
 
     report.stopped();
 }
+
+TEST_F(LoggingCompositorReport, logs_frame_predictions)
+{
+    const void* const id = "My Screen";
+
+    report.started();
+
+    for (int f = 0; f < 3; ++f)
+    {
+        report.predicted_frame(id, std::chrono::steady_clock::now(), chrono::microseconds(16667), chrono::microseconds(4500));
+        report.began_frame(id);
+        report.rendered_frame(id);
+        clock->advance_by(chrono::microseconds(12345678));
+        report.finished_frame(id);
+    }
+
+    bool logged_prediction = false;
+    recorder->for_each_message([&](string const& message)
+        {
+            if (message.find("predicted vblank every 16.667 ms, render time 4.500 ms") != string::npos)
+                logged_prediction = true;
+        });
+    EXPECT_TRUE(logged_prediction);
+
+    report.stopped();
+}
+
+TEST_F(LoggingCompositorReport, reports_frame_time_percentiles)
+{
+    const void* const id = "My Screen";
+
+    report.started();
+
+    for (int f = 0; f < 200; ++f)
+    {
+        report.began_frame(id);
+        clock->advance_by(chrono::microseconds(2000));
+        report.rendered_frame(id);
+        // Every tenth frame misses a vblank
+        clock->advance_by(chrono::microseconds(f % 10 ? 14666 : 31333));
+        report.finished_frame(id);
+    }
+
+    unsigned long p50 = 0, p99 = 0;
+    recorder->for_each_message([&](string const& message)
+        {
+            if (auto const frame_time = strstr(message.c_str(), "\"frame_time_us\":"))
+                sscanf(frame_time, "\"frame_time_us\":{\"count\":%*u,\"p50\":%lu,\"p90\":%*u,\"p99\":%lu", &p50, &p99);
+        });
+
+    EXPECT_LE(16666ul, p50);
+    EXPECT_GE(16666ul + 16666ul / 16, p50);
+    EXPECT_LE(33333ul, p99);
+    EXPECT_GE(33333ul + 33333ul / 16, p99);
+
+    report.stopped();
+}
+
+TEST_F(LoggingCompositorReport, reports_client_pixels_copied_per_frame)
+{
+    const void* const id = "My Screen";
+
+    report.started();
+
+    for (int f = 0; f < 200; ++f)
+    {
+        report.began_frame(id);
+        report.copied_bytes(id, f % 2 ? 0 : 1024);
+        report.rendered_frame(id);
+        clock->advance_by(chrono::microseconds(16667));
+        report.finished_frame(id);
+    }
+
+    unsigned long count = 0, max = 0;
+    recorder->for_each_message([&](string const& message)
+        {
+            if (auto const copied = strstr(message.c_str(), "\"copied_bytes\":"))
+                sscanf(copied, "\"copied_bytes\":{\"count\":%lu,\"p50\":%*u,\"p90\":%*u,\"p99\":%*u,\"max\":%lu", &count, &max);
+        });
+
+    EXPECT_LT(0ul, count);
+    EXPECT_EQ(1024ul, max);
+
+    report.stopped();
+}
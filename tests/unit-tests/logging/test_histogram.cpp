@@ -0,0 +1,89 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/report/logging/histogram.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mrl = mir::report::logging;
+using namespace testing;
+
+TEST(Histogram, is_empty_to_begin_with)
+{
+    mrl::Histogram histogram;
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+    EXPECT_THAT(histogram.percentile(99), Eq(0u));
+    EXPECT_THAT(histogram.max(), Eq(0u));
+}
+
+TEST(Histogram, small_values_are_exact)
+{
+    mrl::Histogram histogram;
+
+    for (uint64_t i = 1; i <= 10; ++i)
+        histogram.record(i);
+
+    EXPECT_THAT(histogram.count(), Eq(10u));
+    EXPECT_THAT(histogram.percentile(50), Eq(5u));
+    EXPECT_THAT(histogram.percentile(90), Eq(9u));
+    EXPECT_THAT(histogram.percentile(100), Eq(10u));
+}
+
+TEST(Histogram, large_values_are_within_a_sixteenth)
+{
+    mrl::Histogram histogram;
+
+    for (uint64_t i = 1; i <= 1000; ++i)
+        histogram.record(i * 100);
+
+    auto const p50 = histogram.percentile(50);
+    auto const p99 = histogram.percentile(99);
+    EXPECT_THAT(p50, AllOf(Ge(50000u), Le(50000u + 50000u / 16)));
+    EXPECT_THAT(p99, AllOf(Ge(99000u), Le(99000u + 99000u / 16)));
+    EXPECT_THAT(histogram.max(), Eq(100000u));
+}
+
+TEST(Histogram, percentiles_never_exceed_the_largest_value)
+{
+    mrl::Histogram histogram;
+
+    histogram.record(16667);
+
+    EXPECT_THAT(histogram.percentile(50), Eq(16667u));
+    EXPECT_THAT(histogram.percentile(99), Eq(16667u));
+}
+
+TEST(Histogram, reset_forgets_everything)
+{
+    mrl::Histogram histogram;
+
+    histogram.record(12345);
+    histogram.reset();
+
+    EXPECT_THAT(histogram.count(), Eq(0u));
+    EXPECT_THAT(histogram.max(), Eq(0u));
+}
+
+TEST(Histogram, formats_as_json)
+{
+    mrl::Histogram histogram;
+
+    histogram.record(3);
+
+    EXPECT_THAT(histogram.to_json(), Eq("{\"count\":1,\"p50\":3,\"p90\":3,\"p99\":3,\"max\":3}"));
+}
@@ -0,0 +1,162 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "kms-utils/plane_assignment.h"
+
+#include "mir/test/doubles/mock_drm.h"
+
+#include <drm_fourcc.h>
+#include <fcntl.h>
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+namespace mtd = mir::test::doubles;
+namespace mgk = mir::graphics::kms;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+uint32_t const xrgb = DRM_FORMAT_XRGB8888;
+uint32_t const argb = DRM_FORMAT_ARGB8888;
+
+MATCHER_P2(UsesPlane, plane_id, layer, "")
+{
+    return arg.plane_id == static_cast<uint32_t>(plane_id) && arg.layer == static_cast<size_t>(layer);
+}
+
+struct PlaneAssignment : Test
+{
+    mgk::PlaneUses assign(std::vector<mgk::PlaneLayer> const& layers)
+    {
+        return mgk::assign_overlay_planes(planes, layers, output, [](mgk::PlaneUses const&) { return true; });
+    }
+
+    geom::Rectangle const output{{0, 0}, {1920, 1080}};
+    std::vector<mgk::PlaneInfo> planes{
+        {31, mgk::PlaneInfo::Type::primary, {xrgb, argb}},
+        {32, mgk::PlaneInfo::Type::overlay, {xrgb}},
+        {33, mgk::PlaneInfo::Type::overlay, {xrgb, argb}},
+        {34, mgk::PlaneInfo::Type::cursor, {argb}}};
+};
+}
+
+TEST_F(PlaneAssignment, lifts_layers_from_the_top_onto_overlay_planes)
+{
+    auto const uses = assign({
+        {{{0, 0}, {1920, 1080}}, xrgb, true},
+        {{{10, 10}, {100, 100}}, xrgb, true},
+        {{{500, 10}, {100, 100}}, xrgb, true}});
+
+    EXPECT_THAT(uses, ElementsAre(UsesPlane(32, 2), UsesPlane(33, 1)));
+}
+
+TEST_F(PlaneAssignment, only_uses_planes_supporting_the_layer_format)
+{
+    auto const uses = assign({
+        {{{10, 10}, {100, 100}}, argb, true}});
+
+    EXPECT_THAT(uses, ElementsAre(UsesPlane(33, 0)));
+}
+
+TEST_F(PlaneAssignment, never_lifts_a_layer_under_a_composited_one)
+{
+    auto const uses = assign({
+        {{{10, 10}, {100, 100}}, xrgb, true},
+        {{{50, 50}, {100, 100}}, xrgb, false}});
+
+    EXPECT_THAT(uses, IsEmpty());
+}
+
+TEST_F(PlaneAssignment, never_stacks_overlay_planes)
+{
+    auto const uses = assign({
+        {{{10, 10}, {100, 100}}, xrgb, true},
+        {{{50, 50}, {100, 100}}, argb, true}});
+
+    EXPECT_THAT(uses, ElementsAre(UsesPlane(33, 1)));
+}
+
+TEST_F(PlaneAssignment, composites_layers_crossing_the_edge_of_the_output)
+{
+    auto const uses = assign({
+        {{{1900, 10}, {100, 100}}, xrgb, true},
+        {{{3000, 10}, {100, 100}}, xrgb, false}});
+
+    EXPECT_THAT(uses, IsEmpty());
+}
+
+TEST_F(PlaneAssignment, ignores_layers_off_the_output)
+{
+    auto const uses = assign({
+        {{{10, 10}, {100, 100}}, xrgb, true},
+        {{{0, 0}, {5000, 5000}}, xrgb, false},
+        {{{2000, 10}, {100, 100}}, xrgb, false}});
+
+    EXPECT_THAT(uses, IsEmpty());
+
+    auto const offscreen_on_top = assign({
+        {{{10, 10}, {100, 100}}, xrgb, true},
+        {{{2000, 10}, {100, 100}}, xrgb, false}});
+
+    EXPECT_THAT(offscreen_on_top, ElementsAre(UsesPlane(32, 0)));
+}
+
+TEST_F(PlaneAssignment, composites_what_the_test_commit_rejects)
+{
+    std::vector<size_t> tested;
+    auto const uses = mgk::assign_overlay_planes(
+        planes,
+        {
+            {{{10, 10}, {100, 100}}, xrgb, true},
+            {{{500, 10}, {100, 100}}, xrgb, true}
+        },
+        output,
+        [&tested](mgk::PlaneUses const& uses)
+        {
+            tested.push_back(uses.size());
+            return uses.back().layer != 1;
+        });
+
+    EXPECT_THAT(uses, ElementsAre(UsesPlane(32, 0)));
+    EXPECT_THAT(tested, ElementsAre(1u, 1u));
+}
+
+TEST(PlanesForCrtc, lists_planes_of_the_crtc_with_their_type_and_formats)
+{
+    NiceMock<mtd::MockDRM> mock_drm;
+    char const* const drm_device = "/dev/dri/card0";
+
+    mock_drm.add_plane(drm_device, 40, 0x1, {xrgb, argb}, DRM_PLANE_TYPE_PRIMARY);
+    mock_drm.add_plane(drm_device, 41, 0x2, {xrgb}, DRM_PLANE_TYPE_PRIMARY);
+    mock_drm.add_plane(drm_device, 42, 0x3, {xrgb}, DRM_PLANE_TYPE_OVERLAY);
+    mock_drm.add_plane(drm_device, 43, 0x3, {argb}, DRM_PLANE_TYPE_CURSOR);
+    mock_drm.prepare(drm_device);
+
+    auto const drm_fd = open(drm_device, 0, 0);
+    auto const planes = mgk::planes_for_crtc(drm_fd, 1);
+
+    ASSERT_THAT(planes.size(), Eq(3u));
+    EXPECT_THAT(planes[0].id, Eq(41u));
+    EXPECT_THAT(planes[0].type, Eq(mgk::PlaneInfo::Type::primary));
+    EXPECT_THAT(planes[1].id, Eq(42u));
+    EXPECT_THAT(planes[1].type, Eq(mgk::PlaneInfo::Type::overlay));
+    EXPECT_THAT(planes[1].formats, ElementsAre(xrgb));
+    EXPECT_THAT(planes[2].type, Eq(mgk::PlaneInfo::Type::cursor));
+    EXPECT_TRUE(planes[2].supports(argb));
+    EXPECT_FALSE(planes[2].supports(xrgb));
+}
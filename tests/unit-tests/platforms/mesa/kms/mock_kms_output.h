@@ -66,6 +66,14 @@ struct MockKMSOutput : public graphics::mesa::KMSOutput
     MOCK_METHOD0(clear_cursor, bool());
     MOCK_CONST_METHOD0(has_cursor, bool());
 
+    MOCK_CONST_METHOD0(planes, std::vector<graphics::kms::PlaneInfo>());
+    bool set_plane(uint32_t plane_id, graphics::mesa::FBHandle const& fb, geometry::Rectangle const& position) override
+    {
+        return set_plane_thunk(plane_id, &fb, position);
+    }
+    MOCK_METHOD3(set_plane_thunk, bool(uint32_t, graphics::mesa::FBHandle const*, geometry::Rectangle const&));
+    MOCK_METHOD1(clear_plane, void(uint32_t));
+
     MOCK_METHOD1(set_power_mode, void(MirPowerMode));
     MOCK_METHOD1(set_gamma, void(mir::graphics::GammaCurves const&));
 
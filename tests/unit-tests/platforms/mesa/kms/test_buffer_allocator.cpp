@@ -33,6 +33,7 @@
 #include "mir/test/doubles/null_gl_config.h"
 #include "mir/test/doubles/null_display_configuration_policy.h"
 #include "mir_test_framework/udev_environment.h"
+#include "mir_test_framework/temporary_environment_value.h"
 
 #include <cstdlib>
 #include <memory>
@@ -291,6 +292,61 @@ TEST_F(MesaBufferAllocatorTest, correct_buffer_handle_is_destroyed)
     allocator->alloc_buffer(buffer_properties);
 }
 
+TEST_F(MesaBufferAllocatorTest, does_not_reuse_released_buffer_objects_by_default)
+{
+    using namespace testing;
+    gbm_bo* first_bo{reinterpret_cast<gbm_bo*>(0xabcd)};
+    gbm_bo* second_bo{reinterpret_cast<gbm_bo*>(0xbcde)};
+
+    EXPECT_CALL(mock_gbm, gbm_bo_create(_,_,_,_,_))
+        .WillOnce(Return(first_bo))
+        .WillOnce(Return(second_bo));
+    EXPECT_CALL(mock_gbm, gbm_bo_destroy(first_bo));
+    EXPECT_CALL(mock_gbm, gbm_bo_destroy(second_bo));
+
+    allocator->alloc_buffer(buffer_properties);
+    auto const buffer = allocator->alloc_buffer(buffer_properties);
+
+    auto const native = std::dynamic_pointer_cast<mgm::NativeBuffer>(buffer->native_buffer_handle());
+    ASSERT_THAT(native, Ne(nullptr));
+    EXPECT_THAT(native->bo, Eq(second_bo));
+}
+
+TEST_F(MesaBufferAllocatorTest, reuses_released_buffer_objects_of_the_same_size_and_format_when_pooling)
+{
+    using namespace testing;
+    gbm_bo* bo{reinterpret_cast<gbm_bo*>(0xabcd)};
+
+    mtf::TemporaryEnvironmentValue pool_budget{"MIR_MESA_BUFFER_POOL_MB", "64"};
+    allocator.reset(new mgm::BufferAllocator(
+        *display,
+        platform->gbm->device,
+        mgm::BypassOption::allowed,
+        mgm::BufferImportMethod::gbm_native_pixmap));
+
+    EXPECT_CALL(mock_gbm, gbm_bo_create(_,_,_,_,_))
+        .WillOnce(Return(bo));
+    EXPECT_CALL(mock_gbm, gbm_bo_destroy(bo));
+
+    allocator->alloc_buffer(buffer_properties);
+    auto const buffer = allocator->alloc_buffer(buffer_properties);
+
+    auto const native = std::dynamic_pointer_cast<mgm::NativeBuffer>(buffer->native_buffer_handle());
+    ASSERT_THAT(native, Ne(nullptr));
+    EXPECT_THAT(native->bo, Eq(bo));
+}
+
+TEST_F(MesaBufferAllocatorTest, creates_buffer_objects_for_other_sizes)
+{
+    using namespace testing;
+
+    EXPECT_CALL(mock_gbm, gbm_bo_create(_,300,200,_,_));
+    EXPECT_CALL(mock_gbm, gbm_bo_create(_,301,200,_,_));
+
+    allocator->alloc_buffer(buffer_properties);
+    allocator->alloc_buffer(mg::BufferProperties{geom::Size{301, 200}, pf, usage});
+}
+
 TEST_F(MesaBufferAllocatorTest, throws_on_buffer_creation_failure)
 {
     using namespace testing;
@@ -413,6 +413,61 @@ TEST_F(MesaCursorTest, show_cursor_writes_to_bo)
     cursor.show(image);
 }
 
+TEST_F(MesaCursorTest, showing_the_same_image_again_does_not_rewrite_the_bo)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+
+    cursor.show(StubCursorImage());
+}
+
+TEST_F(MesaCursorTest, showing_the_same_image_after_hiding_places_cursor_on_output)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+    cursor.hide();
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(_, _, _)).Times(0);
+    EXPECT_CALL(*output_container.outputs[0], set_cursor(_));
+
+    cursor.show(stub_image);
+}
+
+TEST_F(MesaCursorTest, writes_the_current_image_to_the_buffer_of_a_new_output)
+{
+    using namespace testing;
+    size_t const cursor_size_bytes{cursor_side * cursor_side * sizeof(uint32_t)};
+
+    cursor.show(stub_image);
+    cursor.show(StubCursorImage());
+
+    // outputs[1] now needs a buffer of its own (as if it had been hotplugged)
+    ON_CALL(*output_container.outputs[1], id()).WillByDefault(Return(1));
+
+    EXPECT_CALL(mock_gbm, gbm_bo_write(mock_gbm.fake_gbm.bo, NotNull(), cursor_size_bytes));
+
+    cursor.move_to({150, 150});
+}
+
+TEST_F(MesaCursorTest, moving_to_the_current_position_does_not_touch_the_outputs)
+{
+    using namespace testing;
+
+    cursor.show(stub_image);
+    cursor.move_to({10, 10});
+
+    EXPECT_CALL(*output_container.outputs[0], move_cursor(_)).Times(0);
+    EXPECT_CALL(*output_container.outputs[0], set_cursor(_)).Times(0);
+
+    cursor.move_to({10, 10});
+
+    output_container.verify_and_clear_expectations();
+}
+
 // When we upload our 1x1 cursor we should upload a single white pixel and then transparency filling a 64x64 buffer.
 MATCHER_P(ContainsASingleWhitePixel, buffersize, "")
 {
@@ -503,3 +503,53 @@ TEST_F(MesaDisplayBufferTest, buffer_requiring_migration_is_ineligable_for_bypas
 
     EXPECT_FALSE(db.overlay(bypassable_list));
 }
+
+TEST_F(MesaDisplayBufferTest, shows_scanout_buffers_on_overlay_planes_until_replaced)
+{
+    uint32_t const overlay_id{40};
+    ON_CALL(*mock_kms_output, planes())
+        .WillByDefault(Return(std::vector<kms::PlaneInfo>{
+            {overlay_id, kms::PlaneInfo::Type::overlay, {GBM_FORMAT_XRGB8888}}}));
+    ON_CALL(mock_gbm, gbm_bo_get_format(_))
+        .WillByDefault(Return(GBM_FORMAT_XRGB8888));
+
+    mir::geometry::Rectangle const window{{17, 40}, {10, 20}};
+    auto const window_buffer = std::make_shared<NiceMock<MockBuffer>>();
+    ON_CALL(*window_buffer, size())
+        .WillByDefault(Return(window.size));
+    ON_CALL(*window_buffer, native_buffer_handle())
+        .WillByDefault(Return(std::make_shared<StubGBMNativeBuffer>(window.size)));
+    auto const window_renderable = std::make_shared<FakeRenderable>(window);
+    window_renderable->set_buffer(window_buffer);
+
+    graphics::mesa::DisplayBuffer db(
+        graphics::mesa::BypassOption::allowed,
+        null_display_report(),
+        {mock_kms_output},
+        make_output_surface(),
+        display_area,
+        identity);
+
+    auto const original_count = window_buffer.use_count();
+
+    InSequence seq;
+    EXPECT_CALL(*mock_kms_output, set_plane_thunk(overlay_id, _, mir::geometry::Rectangle{{5, 6}, {10, 20}}))
+        .WillOnce(Return(true));
+    EXPECT_CALL(*mock_kms_output, clear_plane(overlay_id));
+
+    mir::graphics::RenderableList const list{fake_software_renderable, window_renderable};
+    ASSERT_FALSE(db.overlay(list));
+    EXPECT_THAT(db.assign_planes(list), ElementsAre(fake_software_renderable));
+    db.swap_buffers();
+    db.post();
+
+    EXPECT_EQ(original_count+1, window_buffer.use_count());
+
+    // The window goes back to being composited
+    ASSERT_FALSE(db.overlay({fake_software_renderable}));
+    EXPECT_THAT(db.assign_planes({fake_software_renderable}), ElementsAre(fake_software_renderable));
+    db.swap_buffers();
+    db.post();
+
+    EXPECT_EQ(original_count, window_buffer.use_count());
+}
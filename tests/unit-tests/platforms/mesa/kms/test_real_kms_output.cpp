@@ -411,6 +411,47 @@ TEST_F(RealKMSOutputTest, cursor_set_permission_failure_is_non_fatal)
     });
 }
 
+TEST_F(RealKMSOutputTest, shows_buffers_on_the_overlay_planes_of_its_crtc)
+{
+    using namespace testing;
+
+    uint32_t const overlay_id{40};
+    uint32_t const other_crtc_overlay_id{41};
+    uint32_t const primary_id{42};
+    uint32_t const fb_id{43};
+
+    setup_outputs_connected_crtc();
+    mock_drm.add_plane(drm_device, overlay_id, 0x1, {GBM_FORMAT_XRGB8888}, DRM_PLANE_TYPE_OVERLAY);
+    mock_drm.add_plane(drm_device, other_crtc_overlay_id, 0x2, {GBM_FORMAT_XRGB8888}, DRM_PLANE_TYPE_OVERLAY);
+    mock_drm.add_plane(drm_device, primary_id, 0x1, {GBM_FORMAT_XRGB8888}, DRM_PLANE_TYPE_PRIMARY);
+    mock_drm.prepare(drm_device);
+    append_fb_id(fb_id);
+
+    mgm::RealKMSOutput output{
+        drm_fd,
+        mg::kms::get_connector(drm_fd, connector_ids[0]),
+        mt::fake_shared(null_page_flipper)};
+
+    EXPECT_THAT(output.planes(), IsEmpty());
+
+    auto fb = output.fb_for(fake_bo);
+    EXPECT_TRUE(output.set_crtc(*fb));
+
+    auto const planes = output.planes();
+    ASSERT_THAT(planes.size(), Eq(2u));
+    EXPECT_THAT(planes[0].id, Eq(overlay_id));
+    EXPECT_THAT(planes[0].type, Eq(mg::kms::PlaneInfo::Type::overlay));
+    EXPECT_THAT(planes[1].type, Eq(mg::kms::PlaneInfo::Type::primary));
+
+    EXPECT_CALL(mock_drm, drmModeSetPlane(_, overlay_id, crtc_ids[0], fb_id, _, 5, 6, 7, 8))
+        .WillOnce(Return(0));
+    EXPECT_TRUE(output.set_plane(overlay_id, *fb, {{5, 6}, {7, 8}}));
+
+    EXPECT_CALL(mock_drm, drmModeSetPlane(_, overlay_id, 0, 0, _, _, _, _, _))
+        .WillOnce(Return(0));
+    output.clear_plane(overlay_id);
+}
+
 TEST_F(RealKMSOutputTest, has_no_cursor_if_no_hardware_support)
 {   // Regression test related to LP: #1610054
     using namespace testing;
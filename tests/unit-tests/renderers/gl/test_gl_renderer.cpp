@@ -29,8 +29,10 @@
 #include <mir/test/doubles/mock_gl.h>
 #include <mir/test/doubles/mock_egl.h>
 #include <src/renderers/gl/renderer.h>
+#include <mir/gl/tessellation_helpers.h>
 #include <mir/test/doubles/stub_gl_display_buffer.h>
 #include <mir/test/doubles/mock_gl_display_buffer.h>
+#include <mir/renderer/gl/partial_redraw_target.h>
 
 using testing::SetArgPointee;
 using testing::InSequence;
@@ -41,12 +43,16 @@ using testing::AnyNumber;
 using testing::AtLeast;
 using testing::DoAll;
 using testing::_;
+using testing::Invoke;
+using testing::Eq;
+using testing::Le;
 
 namespace mt=mir::test;
 namespace mtd=mir::test::doubles;
 namespace mg=mir::graphics;
 namespace mgl=mir::gl;
 namespace mrg = mir::renderer::gl;
+namespace geom = mir::geometry;
 
 namespace
 {
@@ -88,6 +94,12 @@ void SetUpMockProgramData(mtd::MockGL &mock_gl)
         .WillByDefault(Return(alpha_uniform_location));
 }
 
+struct MockPartialRedrawDisplayBuffer : mtd::MockGLDisplayBuffer, mrg::PartialRedrawTarget
+{
+    MOCK_METHOD0(buffer_age, unsigned int());
+    MOCK_METHOD1(swap_buffers_with_damage, void(geom::Rectangles const&));
+};
+
 class GLRenderer :
     public testing::Test
 {
@@ -439,3 +451,235 @@ TEST_F(GLRenderer, sets_viewport_downscaled_wide)
 
     mrg::Renderer renderer(mock_display_buffer);
 }
+
+TEST_F(GLRenderer, uploads_vertices_of_a_frame_to_one_buffer_object)
+{
+    GLuint const vertex_buffer{42};
+
+    mrg::Renderer renderer(display_buffer);
+
+    EXPECT_CALL(mock_gl, glGenBuffers(1, _))
+        .WillOnce(SetArgPointee<1>(vertex_buffer));
+    EXPECT_CALL(mock_gl, glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer))
+        .Times(AtLeast(2));
+    EXPECT_CALL(mock_gl, glBufferData(GL_ARRAY_BUFFER, 6 * sizeof(mgl::Vertex), _, GL_STREAM_DRAW))
+        .Times(2);
+
+    renderer.render(renderable_list);
+    renderer.render(renderable_list);
+
+    EXPECT_CALL(mock_gl, glDeleteBuffers(1, Pointee(vertex_buffer)));
+}
+
+TEST_F(GLRenderer, draws_primitives_with_the_same_state_together)
+{
+    struct TwoQuadRenderer : mrg::Renderer
+    {
+        using mrg::Renderer::Renderer;
+
+        void tessellate(std::vector<mgl::Primitive>& primitives,
+                        mg::Renderable const& renderable) const override
+        {
+            primitives.resize(2);
+            primitives[0] = mgl::tessellate_renderable_into_rectangle(renderable, geom::Displacement{0, 0});
+            primitives[1] = mgl::tessellate_renderable_into_rectangle(renderable, geom::Displacement{10, 10});
+        }
+    };
+
+    TwoQuadRenderer renderer(display_buffer);
+
+    EXPECT_CALL(mock_gl, glDrawArrays(GL_TRIANGLES, 0, 12));
+
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, only_uploads_uniforms_that_change)
+{
+    auto const other = std::make_shared<testing::NiceMock<mtd::MockRenderable>>();
+    EXPECT_CALL(*other, id()).WillRepeatedly(Return(&other));
+    EXPECT_CALL(*other, buffer()).WillRepeatedly(Return(mock_buffer));
+    EXPECT_CALL(*other, shaped()).WillRepeatedly(Return(false));
+    EXPECT_CALL(*other, alpha()).WillRepeatedly(Return(0.5f));
+    EXPECT_CALL(*other, transformation()).WillRepeatedly(Return(trans));
+    EXPECT_CALL(*other, screen_position())
+        .WillRepeatedly(Return(mir::geometry::Rectangle{{10,20},{30,40}}));
+    EXPECT_CALL(*renderable, alpha()).WillRepeatedly(Return(0.5f));
+    renderable_list.push_back(other);
+
+    mrg::Renderer renderer(display_buffer);
+
+    EXPECT_CALL(mock_gl, glUniform1f(_, 0.5f));
+    EXPECT_CALL(mock_gl, glUniform2f(_, _, _));
+    EXPECT_CALL(mock_gl, glDrawArrays(GL_TRIANGLES, _, 6)).Times(2);
+
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRenderer, draws_small_renderables_sharing_an_atlas_texture_in_one_call)
+{
+    geom::Size const size{16, 16};
+    mg::RenderableList small_renderables;
+    for (auto i = 0; i != 2; ++i)
+    {
+        auto const buffer = std::make_shared<testing::NiceMock<mtd::MockGLBuffer>>(
+            size, geom::Stride{size.width.as_int() * 4}, mir_pixel_format_argb_8888);
+        auto const small = std::make_shared<testing::NiceMock<mtd::MockRenderable>>();
+        ON_CALL(*small, id()).WillByDefault(Return(small.get()));
+        ON_CALL(*small, buffer()).WillByDefault(Return(buffer));
+        ON_CALL(*small, shaped()).WillByDefault(Return(true));
+        ON_CALL(*small, screen_position()).WillByDefault(Return(geom::Rectangle{{20 * i, 0}, size}));
+        small_renderables.push_back(small);
+    }
+
+    mrg::Renderer renderer(display_buffer);
+
+    std::vector<mgl::Vertex> vertices;
+    EXPECT_CALL(mock_gl, glBufferData(GL_ARRAY_BUFFER, _, _, _))
+        .WillOnce(Invoke([&vertices](GLenum, GLsizeiptr size, void const* data, GLenum)
+            {
+                auto const begin = static_cast<mgl::Vertex const*>(data);
+                vertices.assign(begin, begin + size / sizeof(mgl::Vertex));
+            }));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _)).Times(0);
+    EXPECT_CALL(mock_gl, glDrawArrays(GL_TRIANGLES, 0, 12));
+
+    renderer.render(small_renderables);
+
+    // Each samples only its own part of the atlas
+    ASSERT_THAT(vertices.size(), Eq(12u));
+    for (auto const& vertex : vertices)
+    {
+        EXPECT_THAT(vertex.texcoord[0], Le(40.0f / 1024));
+        EXPECT_THAT(vertex.texcoord[1], Le(20.0f / 1024));
+    }
+}
+
+struct GLRendererPartialRedraw : GLRenderer
+{
+    GLRendererPartialRedraw()
+    {
+        ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_WIDTH,_))
+            .WillByDefault(DoAll(SetArgPointee<3>(view_area.size.width.as_int()),
+                                 Return(EGL_TRUE)));
+        ON_CALL(mock_egl, eglQuerySurface(_,_,EGL_HEIGHT,_))
+            .WillByDefault(DoAll(SetArgPointee<3>(view_area.size.height.as_int()),
+                                 Return(EGL_TRUE)));
+        ON_CALL(partial_display_buffer, view_area())
+            .WillByDefault(Return(view_area));
+    }
+
+    geom::Rectangle const view_area{{0,0}, {1920,1080}};
+    testing::NiceMock<MockPartialRedrawDisplayBuffer> partial_display_buffer;
+};
+
+TEST_F(GLRendererPartialRedraw, redraws_everything_when_buffer_age_is_unknown)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(0));
+
+    mrg::Renderer renderer(partial_display_buffer);
+    renderer.render(renderable_list);
+
+    EXPECT_CALL(mock_gl, glScissor(_,_,_,_)).Times(0);
+    EXPECT_CALL(partial_display_buffer, swap_buffers());
+
+    renderer.set_damage({geom::Rectangle{{10, 20}, {30, 40}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, redraws_everything_on_first_frame)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(1));
+
+    mrg::Renderer renderer(partial_display_buffer);
+
+    EXPECT_CALL(mock_gl, glScissor(_,_,_,_)).Times(0);
+    EXPECT_CALL(partial_display_buffer, swap_buffers());
+
+    renderer.set_damage({geom::Rectangle{{10, 20}, {30, 40}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, scissors_to_damage_when_buffer_is_preserved)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(1));
+
+    mrg::Renderer renderer(partial_display_buffer);
+    renderer.render(renderable_list);
+
+    geom::Rectangle const damage{{10, 20}, {30, 40}};
+
+    InSequence seq;
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST));
+    EXPECT_CALL(mock_gl, glScissor(10, 1080 - 60, 30, 40));
+    EXPECT_CALL(mock_gl, glClear(_));
+    EXPECT_CALL(mock_gl, glDisable(GL_SCISSOR_TEST));
+    EXPECT_CALL(partial_display_buffer, swap_buffers_with_damage(geom::Rectangles{damage}));
+
+    renderer.set_damage({damage});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, redraws_damage_of_intervening_frames_for_older_buffers)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(1));
+
+    mrg::Renderer renderer(partial_display_buffer);
+    renderer.render(renderable_list);
+
+    renderer.set_damage({geom::Rectangle{{0, 0}, {10, 10}}});
+    renderer.render(renderable_list);
+
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(2));
+
+    EXPECT_CALL(mock_gl, glScissor(0, 1080 - 20, 20, 20));
+
+    renderer.set_damage({geom::Rectangle{{10, 10}, {10, 10}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, redraws_everything_after_suspend)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(1));
+
+    mrg::Renderer renderer(partial_display_buffer);
+    renderer.render(renderable_list);
+    renderer.suspend();
+
+    EXPECT_CALL(mock_gl, glScissor(_,_,_,_)).Times(0);
+
+    renderer.set_damage({geom::Rectangle{{10, 20}, {30, 40}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, only_draws_visible_region_of_partially_hidden_renderables)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(0));
+
+    mrg::Renderer renderer(partial_display_buffer);
+
+    InSequence seq;
+    EXPECT_CALL(mock_gl, glEnable(GL_SCISSOR_TEST));
+    EXPECT_CALL(mock_gl, glScissor(0, 1080 - 10, 10, 10));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _));
+    EXPECT_CALL(mock_gl, glScissor(20, 1080 - 10, 10, 10));
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _));
+    EXPECT_CALL(mock_gl, glDisable(GL_SCISSOR_TEST));
+
+    renderer.set_visible_regions({{renderable->id(), geom::Region{
+        geom::Rectangle{{0, 0}, {10, 10}},
+        geom::Rectangle{{20, 0}, {10, 10}}}}});
+    renderer.render(renderable_list);
+}
+
+TEST_F(GLRendererPartialRedraw, draws_renderables_without_visible_region_in_full)
+{
+    ON_CALL(partial_display_buffer, buffer_age()).WillByDefault(Return(0));
+
+    mrg::Renderer renderer(partial_display_buffer);
+
+    EXPECT_CALL(mock_gl, glScissor(_,_,_,_)).Times(0);
+    EXPECT_CALL(mock_gl, glDrawArrays(_, _, _));
+
+    renderer.set_visible_regions({});
+    renderer.render(renderable_list);
+}
@@ -0,0 +1,281 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/renderers/sw/renderer.h"
+#include "src/renderers/sw/pixel_kernels.h"
+#include "mir/renderer/sw/pixel_target.h"
+#include "mir/graphics/display_buffer.h"
+
+#include "mir/test/doubles/fake_renderable.h"
+#include "mir/test/doubles/stub_buffer.h"
+#include "mir/test/doubles/stub_display_buffer.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <cmath>
+#include <vector>
+
+namespace mg = mir::graphics;
+namespace mrs = mir::renderer::software;
+namespace mtd = mir::test::doubles;
+namespace geom = mir::geometry;
+using namespace testing;
+
+namespace
+{
+uint32_t const black = 0xff000000;
+uint32_t const white = 0xffffffff;
+uint32_t const red = 0xffff0000;
+
+class MemoryDisplayBuffer :
+    public mg::DisplayBuffer,
+    public mg::NativeDisplayBuffer,
+    public mrs::PixelTarget
+{
+public:
+    MemoryDisplayBuffer(geom::Rectangle const& area, geom::Size const& size)
+        : area{area},
+          pixel_size{size},
+          frame(size.width.as_int() * size.height.as_int(), 0x12345678)
+    {
+    }
+
+    geom::Rectangle view_area() const override { return area; }
+    bool overlay(mg::RenderableList const&) override { return false; }
+    glm::mat2 transformation() const override { return glm::mat2{1}; }
+    mg::NativeDisplayBuffer* native_display_buffer() override { return this; }
+
+    geom::Size size() const override { return pixel_size; }
+    geom::Stride stride() const override { return geom::Stride{pixel_size.width.as_int() * 4}; }
+    unsigned char* pixels() override { return reinterpret_cast<unsigned char*>(frame.data()); }
+    unsigned int buffer_age() const override { return age; }
+    void swap_buffers() override { ++swaps; }
+
+    uint32_t at(int x, int y) const { return frame[y * pixel_size.width.as_int() + x]; }
+
+    geom::Rectangle const area;
+    geom::Size const pixel_size;
+    std::vector<uint32_t> frame;
+    unsigned int age = 0;
+    int swaps = 0;
+};
+
+std::shared_ptr<mtd::StubBuffer> buffer_of(geom::Size size, MirPixelFormat format, uint32_t colour)
+{
+    auto const buffer = std::make_shared<mtd::StubBuffer>(
+        mg::BufferProperties{size, format, mg::BufferUsage::software});
+    std::vector<uint32_t> pixels(size.width.as_int() * size.height.as_int(), colour);
+    buffer->write(reinterpret_cast<unsigned char const*>(pixels.data()), pixels.size() * 4);
+    return buffer;
+}
+
+std::shared_ptr<mtd::FakeRenderable> renderable_of(
+    geom::Rectangle const& rect, MirPixelFormat format, uint32_t colour,
+    float alpha = 1.0f, bool shaped = false)
+{
+    auto const renderable = std::make_shared<mtd::FakeRenderable>(rect, alpha, !shaped);
+    renderable->set_buffer(buffer_of(rect.size, format, colour));
+    return renderable;
+}
+
+struct SoftwareRenderer : Test
+{
+    MemoryDisplayBuffer display_buffer{{{0, 0}, {8, 8}}, {8, 8}};
+};
+}
+
+TEST_F(SoftwareRenderer, needs_a_pixel_target)
+{
+    mtd::StubDisplayBuffer gl_display_buffer{{{0, 0}, {8, 8}}};
+
+    EXPECT_THROW(mrs::Renderer{gl_display_buffer}, std::logic_error);
+}
+
+TEST_F(SoftwareRenderer, clears_to_black_and_copies_opaque_renderables)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.render({renderable_of({{2, 2}, {4, 4}}, mir_pixel_format_xrgb_8888, red)});
+
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(black));
+    EXPECT_THAT(display_buffer.at(2, 2), Eq(red));
+    EXPECT_THAT(display_buffer.at(5, 5), Eq(red));
+    EXPECT_THAT(display_buffer.at(6, 6), Eq(black));
+    EXPECT_THAT(display_buffer.swaps, Eq(1));
+}
+
+TEST_F(SoftwareRenderer, draws_within_the_viewport)
+{
+    MemoryDisplayBuffer second_output{{{8, 0}, {8, 8}}, {8, 8}};
+    mrs::Renderer renderer{second_output};
+
+    renderer.render({renderable_of({{6, 2}, {4, 4}}, mir_pixel_format_xrgb_8888, red)});
+
+    EXPECT_THAT(second_output.at(0, 2), Eq(red));
+    EXPECT_THAT(second_output.at(1, 5), Eq(red));
+    EXPECT_THAT(second_output.at(2, 2), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, blends_shaped_renderables_with_premultiplied_alpha)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.render({
+        renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white),
+        renderable_of({{0, 0}, {4, 4}}, mir_pixel_format_argb_8888, 0x80000000, 1.0f, true)});
+
+    EXPECT_THAT(display_buffer.at(1, 1), Eq(0xff7f7f7fu));
+    EXPECT_THAT(display_buffer.at(5, 5), Eq(white));
+}
+
+TEST_F(SoftwareRenderer, ignores_alpha_channel_of_unshaped_renderables)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.render({
+        renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white),
+        renderable_of({{0, 0}, {4, 4}}, mir_pixel_format_argb_8888, 0x00ff0000)});
+
+    EXPECT_THAT(display_buffer.at(1, 1) & 0xffffff, Eq(0xff0000u));
+}
+
+TEST_F(SoftwareRenderer, fades_translucent_renderables)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.render({renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white, 0.5f)});
+
+    EXPECT_THAT(display_buffer.at(3, 3), Eq(0xff808080u));
+}
+
+TEST_F(SoftwareRenderer, swaps_red_and_blue_of_abgr_buffers)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.render({
+        renderable_of({{0, 0}, {4, 4}}, mir_pixel_format_xbgr_8888, 0xff0000ff),
+        renderable_of({{4, 4}, {4, 4}}, mir_pixel_format_abgr_8888, 0xff0000ff, 0.5f, true)});
+
+    EXPECT_THAT(display_buffer.at(1, 1), Eq(red));
+    EXPECT_THAT(display_buffer.at(5, 5), Eq(0xff800000u));
+}
+
+TEST_F(SoftwareRenderer, only_redraws_damage_when_the_target_keeps_its_pixels)
+{
+    mrs::Renderer renderer{display_buffer};
+    display_buffer.age = 1;
+
+    auto const background = renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white);
+    renderer.render({background});
+
+    background->set_buffer(buffer_of({8, 8}, mir_pixel_format_xrgb_8888, red));
+    renderer.set_damage({{{0, 0}, {2, 2}}});
+    renderer.render({background});
+
+    EXPECT_THAT(display_buffer.at(1, 1), Eq(red));
+    EXPECT_THAT(display_buffer.at(4, 4), Eq(white));
+}
+
+TEST_F(SoftwareRenderer, redraws_everything_when_the_target_age_is_unknown)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const background = renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white);
+    renderer.render({background});
+
+    background->set_buffer(buffer_of({8, 8}, mir_pixel_format_xrgb_8888, red));
+    renderer.set_damage({{{0, 0}, {2, 2}}});
+    renderer.render({background});
+
+    EXPECT_THAT(display_buffer.at(4, 4), Eq(red));
+}
+
+TEST_F(SoftwareRenderer, only_draws_visible_parts)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    auto const hidden = renderable_of({{0, 0}, {8, 8}}, mir_pixel_format_xrgb_8888, white);
+    renderer.set_visible_regions({{hidden->id(), geom::Region{{{0, 0}, {2, 2}}}}});
+    renderer.render({hidden});
+
+    EXPECT_THAT(display_buffer.at(1, 1), Eq(white));
+    EXPECT_THAT(display_buffer.at(4, 4), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, turns_output_a_quarter)
+{
+    MemoryDisplayBuffer turned{{{0, 0}, {4, 2}}, {2, 4}};
+    mrs::Renderer renderer{turned};
+
+    // Right in the scene is up on the output, and up is left
+    renderer.set_output_transform(glm::mat2{0, 1, -1, 0});
+    renderer.render({
+        renderable_of({{0, 0}, {1, 2}}, mir_pixel_format_xrgb_8888, red),
+        renderable_of({{3, 0}, {1, 1}}, mir_pixel_format_xrgb_8888, white)});
+
+    EXPECT_THAT(turned.at(0, 3), Eq(red));
+    EXPECT_THAT(turned.at(1, 3), Eq(red));
+    EXPECT_THAT(turned.at(0, 0), Eq(white));
+    EXPECT_THAT(turned.at(1, 0), Eq(black));
+}
+
+TEST_F(SoftwareRenderer, turns_output_a_half)
+{
+    mrs::Renderer renderer{display_buffer};
+
+    renderer.set_output_transform(glm::mat2{-1, 0, 0, -1});
+    renderer.render({renderable_of({{0, 0}, {1, 1}}, mir_pixel_format_xrgb_8888, red)});
+
+    EXPECT_THAT(display_buffer.at(7, 7), Eq(red));
+    EXPECT_THAT(display_buffer.at(0, 0), Eq(black));
+}
+
+TEST(SoftwareRendererKernels, blend_line_matches_blending_each_pixel)
+{
+    // Every length up to a few times the widest vector, so every tail is covered
+    for (int count = 1; count != 40; ++count)
+    {
+        for (uint32_t alpha : {255u, 200u, 1u})
+        {
+            std::vector<uint32_t> src(count), dest(count);
+            for (int i = 0; i != count; ++i)
+            {
+                uint32_t const a = (i * 37) % 256;
+                auto const c = [a, i](int shift) { return ((i * (shift + 11)) % (a + 1)) << shift; };
+                src[i] = a << 24 | c(16) | c(8) | c(0);
+                dest[i] = 0xff000000 | (i * 0x030507);
+            }
+            auto const before = dest;
+
+            mrs::blend_line(dest.data(), src.data(), count, alpha, false);
+
+            for (int i = 0; i != count; ++i)
+            {
+                for (int shift = 0; shift != 32; shift += 8)
+                {
+                    auto const s = ((src[i] >> shift) & 0xff) * alpha / 255.0;
+                    auto const sa = (src[i] >> 24) * alpha / 255.0;
+                    auto const d = (before[i] >> shift) & 0xff;
+                    auto const expected = s + d * (255 - sa) / 255.0;
+
+                    EXPECT_THAT(((dest[i] >> shift) & 0xff), AllOf(Ge(std::floor(expected) - 1), Le(std::ceil(expected) + 1)))
+                        << "count " << count << ", pixel " << i << ", alpha " << alpha;
+                }
+            }
+        }
+    }
+}
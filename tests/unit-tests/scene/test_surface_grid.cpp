@@ -0,0 +1,213 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/scene/surface_grid.h"
+#include "mir/test/doubles/stub_surface.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+namespace ms = mir::scene;
+namespace geom = mir::geometry;
+namespace mtd = mir::test::doubles;
+
+using namespace testing;
+
+namespace
+{
+struct RectangularSurface : mtd::StubSurface
+{
+    RectangularSurface(geom::Rectangle const& rect) : rect{rect} {}
+
+    geom::Rectangle input_bounds() const override { return rect; }
+    bool input_area_contains(geom::Point const& point) const override
+    {
+        if (!accepts_input)
+            return false;
+
+        if (input_region.empty())
+            return rect.contains(point);
+
+        auto const local = geom::Point{} + (point - rect.top_left);
+        return std::any_of(input_region.begin(), input_region.end(),
+            [&local](geom::Rectangle const& r) { return r.contains(local); });
+    }
+
+    geom::Rectangle rect;
+    std::vector<geom::Rectangle> input_region;
+    bool accepts_input{true};
+};
+
+struct SurfaceGrid : Test
+{
+    std::shared_ptr<RectangularSurface> add(geom::Rectangle const& rect)
+    {
+        auto const surface = std::make_shared<RectangularSurface>(rect);
+        grid.add(surface, rect);
+        return surface;
+    }
+
+    void move(std::shared_ptr<RectangularSurface> const& surface, geom::Rectangle const& rect)
+    {
+        surface->rect = rect;
+        grid.update(surface.get(), rect);
+    }
+
+    void set_input_region(std::shared_ptr<RectangularSurface> const& surface, std::vector<geom::Rectangle> const& region)
+    {
+        surface->input_region = region;
+        grid.set_input_region(surface.get(), region);
+    }
+
+    ms::SurfaceGrid grid;
+};
+}
+
+TEST_F(SurfaceGrid, finds_the_topmost_surface_under_a_point)
+{
+    auto const bottom = add({{0, 0}, {900, 900}});
+    auto const middle = add({{0, 0}, {500, 200}});
+    auto const top = add({{0, 0}, {200, 500}});
+
+    EXPECT_THAT(grid.surface_at({100, 100}), Eq(top));
+    EXPECT_THAT(grid.surface_at({300, 100}), Eq(middle));
+    EXPECT_THAT(grid.surface_at({600, 600}), Eq(bottom));
+    EXPECT_THAT(grid.surface_at({999, 999}), IsNull());
+}
+
+TEST_F(SurfaceGrid, passes_over_surfaces_not_accepting_input_at_the_point)
+{
+    auto const bottom = add({{0, 0}, {100, 100}});
+    auto const top = add({{0, 0}, {100, 100}});
+
+    top->accepts_input = false;
+
+    EXPECT_THAT(grid.surface_at({50, 50}), Eq(bottom));
+}
+
+TEST_F(SurfaceGrid, follows_surfaces_that_move_and_resize)
+{
+    auto const surface = add({{0, 0}, {100, 100}});
+
+    move(surface, {{1000, 1000}, {100, 100}});
+
+    EXPECT_THAT(grid.surface_at({50, 50}), IsNull());
+    EXPECT_THAT(grid.surface_at({1050, 1050}), Eq(surface));
+
+    move(surface, {{1000, 1000}, {1000, 1000}});
+
+    EXPECT_THAT(grid.surface_at({1950, 1950}), Eq(surface));
+}
+
+TEST_F(SurfaceGrid, does_not_find_removed_surfaces)
+{
+    auto const bottom = add({{0, 0}, {100, 100}});
+    auto const top = add({{0, 0}, {100, 100}});
+
+    grid.remove(top.get());
+
+    EXPECT_THAT(grid.surface_at({50, 50}), Eq(bottom));
+
+    grid.remove(bottom.get());
+
+    EXPECT_THAT(grid.surface_at({50, 50}), IsNull());
+}
+
+TEST_F(SurfaceGrid, finds_surfaces_in_their_new_stacking_order)
+{
+    auto const first = add({{0, 0}, {100, 100}});
+    auto const second = add({{0, 0}, {100, 100}});
+
+    grid.set_position(first.get(), 1);
+    grid.set_position(second.get(), 0);
+    grid.restacked();
+
+    EXPECT_THAT(grid.surface_at({50, 50}), Eq(first));
+}
+
+TEST_F(SurfaceGrid, finds_surfaces_at_negative_coordinates)
+{
+    auto const surface = add({{-300, -300}, {100, 100}});
+
+    EXPECT_THAT(grid.surface_at({-250, -250}), Eq(surface));
+    EXPECT_THAT(grid.surface_at({-150, -150}), IsNull());
+}
+
+TEST_F(SurfaceGrid, finds_huge_surfaces_in_stacking_order_with_small_ones)
+{
+    auto const bottom = add({{0, 0}, {100, 100}});
+    auto const huge = add({{-10000, -10000}, {20000, 20000}});
+    auto const top = add({{50, 50}, {100, 100}});
+
+    EXPECT_THAT(grid.surface_at({25, 25}), Eq(huge));
+    EXPECT_THAT(grid.surface_at({75, 75}), Eq(top));
+    EXPECT_THAT(grid.surface_at({9000, -9000}), Eq(huge));
+
+    grid.remove(huge.get());
+
+    EXPECT_THAT(grid.surface_at({25, 25}), Eq(bottom));
+    EXPECT_THAT(grid.surface_at({9000, -9000}), IsNull());
+}
+
+TEST_F(SurfaceGrid, finds_surfaces_by_input_regions_reaching_past_them)
+{
+    auto const bottom = add({{0, 0}, {900, 900}});
+    auto const top = add({{0, 0}, {100, 100}});
+
+    set_input_region(top, {{{0, 0}, {10, 10}}, {{600, 600}, {100, 100}}});
+
+    EXPECT_THAT(grid.surface_at({650, 650}), Eq(top));
+    EXPECT_THAT(grid.surface_at({5, 5}), Eq(top));
+    EXPECT_THAT(grid.surface_at({50, 50}), Eq(bottom));
+
+    move(top, {{100, 0}, {100, 100}});
+
+    EXPECT_THAT(grid.surface_at({750, 650}), Eq(top));
+    EXPECT_THAT(grid.surface_at({650, 650}), Eq(bottom));
+
+    set_input_region(top, {});
+
+    EXPECT_THAT(grid.surface_at({750, 650}), Eq(bottom));
+    EXPECT_THAT(grid.surface_at({150, 50}), Eq(top));
+}
+
+TEST_F(SurfaceGrid, keeps_stacking_order_as_surfaces_are_raised_and_lowered)
+{
+    std::vector<std::shared_ptr<RectangularSurface>> surfaces;
+    for (auto i = 0; i != 6; ++i)
+        surfaces.push_back(add({{10 * i, 0}, {600, 600}}));
+
+    auto const restack = [&](std::vector<size_t> const& bottom_to_top)
+        {
+            for (size_t position = 0; position != bottom_to_top.size(); ++position)
+                grid.set_position(surfaces[bottom_to_top[position]].get(), position);
+            grid.restacked();
+        };
+
+    restack({1, 2, 3, 4, 5, 0});    // Raise the bottom surface
+    EXPECT_THAT(grid.surface_at({55, 10}), Eq(surfaces[0]));
+
+    restack({0, 1, 2, 3, 4, 5});    // Lower it again
+    EXPECT_THAT(grid.surface_at({55, 10}), Eq(surfaces[5]));
+
+    restack({5, 4, 3, 2, 1, 0});    // Reverse everything
+    for (auto i = 0; i != 6; ++i)
+        EXPECT_THAT(grid.surface_at({10 * i + 5, 10}), Eq(surfaces[0])) << i;
+    EXPECT_THAT(grid.surface_at({605, 10}), Eq(surfaces[1]));
+    EXPECT_THAT(grid.surface_at({645, 10}), Eq(surfaces[5]));
+}
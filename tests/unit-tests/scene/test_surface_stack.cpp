@@ -79,6 +79,7 @@ struct MockSceneObserver : public ms::Observer
     MOCK_METHOD1(surface_removed, void(std::shared_ptr<ms::Surface> const&));
     MOCK_METHOD0(surfaces_reordered, void());
     MOCK_METHOD0(scene_changed, void());
+    MOCK_METHOD1(scene_damaged, void(geom::Rectangle const&));
 
     MOCK_METHOD1(surface_exists, void(std::shared_ptr<ms::Surface> const&));
     MOCK_METHOD0(end_observation, void());
@@ -919,6 +920,20 @@ TEST_F(SurfaceStack, scene_observers_notified_of_generic_scene_change)
     stack.emit_scene_changed();
 }
 
+TEST_F(SurfaceStack, scene_observers_notified_of_scene_damage)
+{
+    MockSceneObserver o1, o2;
+    geom::Rectangle const damage{{1, 2}, {3, 4}};
+
+    EXPECT_CALL(o1, scene_damaged(damage)).Times(1);
+    EXPECT_CALL(o2, scene_damaged(damage)).Times(1);
+
+    stack.add_observer(mt::fake_shared(o1));
+    stack.add_observer(mt::fake_shared(o2));
+
+    stack.emit_scene_damaged(damage);
+}
+
 TEST_F(SurfaceStack, for_each_enumerates_all_input_surfaces)
 {
     using namespace ::testing;
@@ -986,6 +1001,43 @@ TEST_F(SurfaceStack, returns_top_visible_surface_under_cursor)
     EXPECT_THAT(stack.surface_at(cursor_over_none).get(), IsNull());
 }
 
+TEST_F(SurfaceStack, returns_surface_under_cursor_after_it_moves)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({100, 100});
+    stub_surface2->resize({100, 100});
+    stub_surface2->move_to({2000, 2000});
+
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({2050, 2050}), Eq(stub_surface2));
+
+    stub_surface1->move_to({2000, 2000});
+    stack.raise(stub_surface1);
+
+    EXPECT_THAT(stack.surface_at({50, 50}).get(), IsNull());
+    EXPECT_THAT(stack.surface_at({2050, 2050}), Eq(stub_surface1));
+}
+
+TEST_F(SurfaceStack, returns_surface_whose_input_region_reaches_past_it_under_cursor)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    stub_surface1->resize({900, 900});
+    stub_surface2->resize({100, 100});
+    stub_surface2->set_input_region({{{500, 0}, {100, 100}}});
+
+    EXPECT_THAT(stack.surface_at({550, 50}), Eq(stub_surface2));
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface1));
+
+    stub_surface2->set_input_region({});
+
+    EXPECT_THAT(stack.surface_at({550, 50}), Eq(stub_surface1));
+    EXPECT_THAT(stack.surface_at({50, 50}), Eq(stub_surface2));
+}
+
 TEST_F(SurfaceStack, raise_surfaces_to_top)
 {
     stack.add_surface(stub_surface1, default_params.input_mode);
@@ -1216,3 +1268,85 @@ TEST_F(SurfaceStack, all_depth_layers_are_handled)
     }
 
 }
+
+TEST_F(SurfaceStack, scene_elements_taken_before_a_change_are_not_affected_by_it)
+{
+    using namespace ::testing;
+
+    stack.add_surface(stub_surface1, default_params.input_mode);
+    stack.add_surface(stub_surface2, default_params.input_mode);
+
+    auto const elements = stack.scene_elements_for(compositor_id);
+
+    stack.remove_surface(stub_surface1);
+    stack.raise(stub_surface2);
+    stack.add_surface(stub_surface3, default_params.input_mode);
+
+    EXPECT_THAT(
+        elements,
+        ElementsAre(
+            SceneElementForStream(stub_buffer_stream1),
+            SceneElementForStream(stub_buffer_stream2)));
+    EXPECT_THAT(
+        stack.scene_elements_for(compositor_id),
+        ElementsAre(
+            SceneElementForStream(stub_buffer_stream2),
+            SceneElementForStream(stub_buffer_stream3)));
+}
+
+TEST_F(SurfaceStack, compositors_see_a_consistent_scene_while_it_changes)
+{
+    using namespace ::testing;
+
+    stack.register_compositor(compositor_id);
+    stack.add_surface(stub_surface1, default_params.input_mode);
+
+    std::atomic<bool> done{false};
+    std::atomic<int> inconsistent_scenes{0};
+
+    std::thread compositor{
+        [&]
+        {
+            while (!done)
+            {
+                auto const elements = stack.scene_elements_for(compositor_id);
+                stack.frames_pending(compositor_id);
+
+                // surface1 is always there, and surface2 is only ever above it
+                if (elements.empty() ||
+                    elements.front()->renderable()->id() != stub_buffer_stream1.get() ||
+                    elements.size() > 2)
+                {
+                    ++inconsistent_scenes;
+                }
+            }
+        }};
+
+    for (int i = 0; i != 1000; ++i)
+    {
+        stack.add_surface(stub_surface2, default_params.input_mode);
+        stack.raise(stub_surface2);
+        stack.remove_surface(stub_surface2);
+    }
+
+    done = true;
+    compositor.join();
+
+    EXPECT_THAT(inconsistent_scenes, Eq(0));
+}
+
+TEST_F(SurfaceStack, scene_elements_can_be_freed_as_a_compositor_thread_exits)
+{
+    stack.add_surface(stub_surface1, default_params.input_mode);
+
+    std::thread compositor{
+        [this]
+        {
+            // Constructed before, so destroyed after, the thread's recycled elements
+            static thread_local mc::SceneElementSequence held;
+            held = stack.scene_elements_for(compositor_id);
+            held = stack.scene_elements_for(compositor_id);
+        }};
+
+    compositor.join();
+}
@@ -66,6 +66,16 @@ struct NamedThreadBufferStream : mtd::StubBufferStream
     std::string thread_name;
 };
 
+struct BlockingBufferStream : mtd::StubBufferStream
+{
+    void with_most_recent_buffer_do(std::function<void(mg::Buffer & )> const& fn) override
+    {
+        released.wait_for(std::chrono::seconds{5});
+        StubBufferStream::with_most_recent_buffer_do(fn);
+    }
+    mt::Signal released;
+};
+
 struct ThreadedSnapshotStrategyTest : testing::Test
 {
     NamedThreadBufferStream buffer_access;
@@ -112,6 +122,36 @@ TEST_F(ThreadedSnapshotStrategyTest, takes_snapshot)
     EXPECT_EQ(pixels, snapshot.pixels);
 }
 
+TEST_F(ThreadedSnapshotStrategyTest, queued_requests_for_the_same_stream_share_a_snapshot)
+{
+    using namespace testing;
+
+    NiceMock<MockPixelBuffer> pixel_buffer;
+    BlockingBufferStream busy_stream;
+
+    /* Once for the stream keeping the snapshot thread busy, once for both requests queued behind it */
+    EXPECT_CALL(pixel_buffer, fill_from(_)).Times(2);
+
+    ms::ThreadedSnapshotStrategy strategy{mt::fake_shared(pixel_buffer)};
+
+    std::atomic<int> snapshots_taken{0};
+    mt::Signal all_snapshots_taken;
+    auto const snapshot_taken = [&](ms::Snapshot const&)
+        {
+            if (++snapshots_taken == 3)
+                all_snapshots_taken.raise();
+        };
+
+    strategy.take_snapshot_of(mt::fake_shared(busy_stream), snapshot_taken);
+    strategy.take_snapshot_of(mt::fake_shared(buffer_access), snapshot_taken);
+    strategy.take_snapshot_of(mt::fake_shared(buffer_access), snapshot_taken);
+    busy_stream.released.raise();
+
+    all_snapshots_taken.wait_for(std::chrono::seconds{5});
+
+    EXPECT_THAT(snapshots_taken, Eq(3));
+}
+
 #ifndef MIR_DONT_USE_PTHREAD_GETNAME_NP
 TEST_F(ThreadedSnapshotStrategyTest, names_snapshot_thread)
 {
@@ -0,0 +1,247 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/pointer_motion_coalescer.h"
+
+#include "mir/events/event_builders.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <vector>
+
+namespace mf = mir::frontend;
+namespace mev = mir::events;
+namespace geom = mir::geometry;
+
+using namespace testing;
+using namespace std::chrono_literals;
+
+namespace
+{
+struct Motion
+{
+    std::chrono::milliseconds ms;
+    geom::Point position;
+
+    bool operator==(Motion const& other) const
+    {
+        return ms == other.ms && position == other.position;
+    }
+};
+
+void PrintTo(Motion const& motion, std::ostream* os)
+{
+    *os << motion.ms.count() << "ms " << motion.position;
+}
+
+auto pointer_event(MirPointerAction action, float x, float y, float vscroll = 0) -> mir::EventUPtr
+{
+    return mev::make_event(
+        MirInputDeviceId{0}, 0ns, std::vector<uint8_t>{}, mir_input_event_modifier_none,
+        action, 0, x, y, 0, vscroll, 0, 0);
+}
+
+struct PointerMotionCoalescer : Test
+{
+    auto make_coalescer(bool enabled) -> std::unique_ptr<mf::PointerMotionCoalescer>
+    {
+        return std::make_unique<mf::PointerMotionCoalescer>(
+            enabled,
+            [this]() { return awaiting_frame; },
+            [this](std::function<void()>&& action) { next_frame_actions.push_back(std::move(action)); },
+            [this](std::chrono::milliseconds ms, geom::Point position) { sent.push_back({ms, position}); });
+    }
+
+    void frame()
+    {
+        auto const actions = std::move(next_frame_actions);
+        next_frame_actions.clear();
+        for (auto const& action : actions)
+            action();
+        awaiting_frame = false;
+    }
+
+    void before(MirEvent const& event)
+    {
+        coalescer->before(mir_event_get_input_event(&event));
+    }
+
+    bool awaiting_frame{true};
+    std::vector<std::function<void()>> next_frame_actions;
+    std::vector<Motion> sent;
+    std::unique_ptr<mf::PointerMotionCoalescer> const coalescer{make_coalescer(true)};
+};
+}
+
+TEST_F(PointerMotionCoalescer, sends_only_the_latest_motion_once_the_frame_is_drawn)
+{
+    EXPECT_TRUE(coalescer->hold(1ms, {1, 1}));
+    EXPECT_TRUE(coalescer->hold(2ms, {2, 2}));
+    EXPECT_TRUE(coalescer->hold(3ms, {3, 3}));
+
+    EXPECT_THAT(sent, IsEmpty());
+    EXPECT_THAT(next_frame_actions.size(), Eq(1u));
+
+    frame();
+
+    EXPECT_THAT(sent, ElementsAre(Motion{3ms, {3, 3}}));
+}
+
+TEST_F(PointerMotionCoalescer, does_not_hold_back_motion_while_not_awaiting_a_frame)
+{
+    awaiting_frame = false;
+
+    EXPECT_FALSE(coalescer->hold(1ms, {1, 1}));
+    EXPECT_THAT(next_frame_actions, IsEmpty());
+}
+
+TEST_F(PointerMotionCoalescer, does_not_hold_back_motion_when_disabled)
+{
+    auto const disabled = make_coalescer(false);
+
+    EXPECT_FALSE(disabled->hold(1ms, {1, 1}));
+    EXPECT_THAT(next_frame_actions, IsEmpty());
+}
+
+TEST_F(PointerMotionCoalescer, sends_pending_motion_before_motion_that_is_not_held_back)
+{
+    coalescer->hold(1ms, {1, 1});
+    frame();
+    sent.clear();
+
+    awaiting_frame = true;
+    coalescer->hold(2ms, {2, 2});
+    awaiting_frame = false;
+
+    EXPECT_FALSE(coalescer->hold(3ms, {3, 3}));
+    EXPECT_THAT(sent, ElementsAre(Motion{2ms, {2, 2}}));
+}
+
+TEST_F(PointerMotionCoalescer, holds_motion_again_for_the_next_frame)
+{
+    coalescer->hold(1ms, {1, 1});
+    frame();
+
+    awaiting_frame = true;
+    coalescer->hold(2ms, {2, 2});
+    frame();
+
+    EXPECT_THAT(sent, ElementsAre(Motion{1ms, {1, 1}}, Motion{2ms, {2, 2}}));
+}
+
+TEST_F(PointerMotionCoalescer, a_frame_with_nothing_pending_sends_nothing)
+{
+    coalescer->hold(1ms, {1, 1});
+    coalescer->flush();
+    sent.clear();
+
+    frame();
+
+    EXPECT_THAT(sent, IsEmpty());
+}
+
+TEST_F(PointerMotionCoalescer, more_motion_does_not_flush_pending_motion)
+{
+    coalescer->hold(1ms, {1, 1});
+
+    before(*pointer_event(mir_pointer_action_motion, 2, 2));
+
+    EXPECT_THAT(sent, IsEmpty());
+}
+
+TEST_F(PointerMotionCoalescer, flushes_pending_motion_before_a_button)
+{
+    coalescer->hold(1ms, {1, 1});
+
+    before(*pointer_event(mir_pointer_action_button_down, 1, 1));
+
+    EXPECT_THAT(sent, ElementsAre(Motion{1ms, {1, 1}}));
+}
+
+TEST_F(PointerMotionCoalescer, flushes_pending_motion_before_scrolling)
+{
+    coalescer->hold(1ms, {1, 1});
+
+    before(*pointer_event(mir_pointer_action_motion, 1, 1, 1));
+
+    EXPECT_THAT(sent, ElementsAre(Motion{1ms, {1, 1}}));
+}
+
+TEST_F(PointerMotionCoalescer, flushes_pending_motion_before_the_pointer_leaves)
+{
+    coalescer->hold(1ms, {1, 1});
+
+    before(*pointer_event(mir_pointer_action_leave, 1, 1));
+
+    EXPECT_THAT(sent, ElementsAre(Motion{1ms, {1, 1}}));
+}
+
+TEST_F(PointerMotionCoalescer, flushes_pending_motion_before_a_key)
+{
+    coalescer->hold(1ms, {1, 1});
+
+    before(*mev::make_event(
+        MirInputDeviceId{0}, 0ns, std::vector<uint8_t>{}, mir_keyboard_action_down, 0, 0, mir_input_event_modifier_none));
+
+    EXPECT_THAT(sent, ElementsAre(Motion{1ms, {1, 1}}));
+}
+
+TEST_F(PointerMotionCoalescer, flushed_motion_is_not_sent_again_on_the_next_frame)
+{
+    coalescer->hold(1ms, {1, 1});
+    before(*pointer_event(mir_pointer_action_button_down, 1, 1));
+
+    frame();
+
+    EXPECT_THAT(sent.size(), Eq(1u));
+}
+
+TEST(CoalescePointerMotionFor, no_clients_coalesces_for_none)
+{
+    auto const coalesce_for = mf::coalesce_pointer_motion_for("");
+
+    EXPECT_FALSE(coalesce_for("gedit"));
+    EXPECT_FALSE(coalesce_for(""));
+}
+
+TEST(CoalescePointerMotionFor, all_coalesces_for_every_client)
+{
+    auto const coalesce_for = mf::coalesce_pointer_motion_for("all");
+
+    EXPECT_TRUE(coalesce_for("gedit"));
+    EXPECT_TRUE(coalesce_for("weston-terminal"));
+}
+
+TEST(CoalescePointerMotionFor, a_list_coalesces_for_the_executables_named)
+{
+    auto const coalesce_for = mf::coalesce_pointer_motion_for("gedit,weston-terminal");
+
+    EXPECT_TRUE(coalesce_for("gedit"));
+    EXPECT_TRUE(coalesce_for("weston-terminal"));
+    EXPECT_FALSE(coalesce_for("gnome-terminal"));
+    EXPECT_FALSE(coalesce_for("gedit,weston-terminal"));
+    EXPECT_FALSE(coalesce_for(""));
+}
+
+TEST(CoalescePointerMotionFor, a_single_name_coalesces_for_only_that_executable)
+{
+    auto const coalesce_for = mf::coalesce_pointer_motion_for("gedit");
+
+    EXPECT_TRUE(coalesce_for("gedit"));
+    EXPECT_FALSE(coalesce_for("ged"));
+    EXPECT_FALSE(coalesce_for("all"));
+}
@@ -159,3 +159,53 @@ TEST_F(WaylandExecutorTest, spawning_is_threadsafe)
 
     EXPECT_THAT(counter, Eq(thread_count));
 }
+
+TEST_F(WaylandExecutorTest, runs_work_spawned_from_a_thread_in_order)
+{
+    using namespace std::literals::chrono_literals;
+
+    mf::WaylandExecutor executor{the_event_loop};
+
+    size_t const task_count{1000};
+    std::vector<size_t> executed;
+
+    {
+        mt::AutoJoinThread spawner{
+            [&executor, &executed]()
+            {
+                for (auto i = 0u; i < task_count; ++i)
+                    executor.spawn([&executed, i]() { executed.push_back(i); });
+            }};
+
+        while (executed.size() < task_count && mt::fd_becomes_readable(event_loop_fd, 1s))
+        {
+            wl_event_loop_dispatch(the_event_loop, 0);
+        }
+    }
+
+    ASSERT_THAT(executed.size(), Eq(task_count));
+    for (auto i = 0u; i < task_count; ++i)
+        EXPECT_THAT(executed[i], Eq(i));
+}
+
+TEST_F(WaylandExecutorTest, runs_a_burst_of_spawned_work_in_one_dispatch)
+{
+    mf::WaylandExecutor executor{the_event_loop};
+
+    int const task_count{100};
+    int counter{0};
+
+    {
+        mt::AutoJoinThread spawner{
+            [&executor, &counter]()
+            {
+                for (auto i = 0; i < task_count; ++i)
+                    executor.spawn([&counter]() { ++counter; });
+            }};
+    }
+
+    wl_event_loop_dispatch(the_event_loop, 0);
+
+    EXPECT_THAT(counter, Eq(task_count));
+    EXPECT_THAT(event_loop_fd, Not(FdIsReadable()));
+}
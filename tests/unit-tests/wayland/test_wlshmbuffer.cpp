@@ -0,0 +1,176 @@
+/*
+ * Copyright © 2019 Canonical Ltd.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 or 3 as
+ * published by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "src/server/frontend_wayland/wlshmbuffer.h"
+
+#include "mir/executor.h"
+#include "mir/anonymous_shm_file.h"
+
+#include <gtest/gtest.h>
+#include <gmock/gmock.h>
+
+#include <wayland-server.h>
+#include <wayland-client.h>
+
+#include <sys/socket.h>
+#include <cstring>
+#include <vector>
+
+namespace mf = mir::frontend;
+
+using namespace testing;
+
+namespace
+{
+struct ImmediateExecutor : mir::Executor
+{
+    void spawn(std::function<void()>&& work) override
+    {
+        work();
+    }
+};
+
+class WlShmBufferTest : public Test
+{
+public:
+    WlShmBufferTest()
+        : display{wl_display_create()}
+    {
+        wl_display_init_shm(display);
+
+        int fds[2];
+        socketpair(AF_LOCAL, SOCK_STREAM | SOCK_CLOEXEC, 0, fds);
+        client = wl_client_create(display, fds[0]);
+        client_display = wl_display_connect_to_fd(fds[1]);
+
+        auto const registry = wl_display_get_registry(client_display);
+        wl_registry_add_listener(registry, &registry_listener, this);
+        roundtrip();
+        wl_registry_destroy(registry);
+
+        pool = wl_shm_create_pool(shm, shm_file.fd(), pool_size);
+    }
+
+    ~WlShmBufferTest()
+    {
+        wl_shm_pool_destroy(pool);
+        wl_shm_destroy(shm);
+        roundtrip();
+        wl_display_disconnect(client_display);
+        wl_display_destroy(display);
+    }
+
+    /// Lets the server handle the client's requests, then the client the server's events
+    void roundtrip()
+    {
+        auto const callback = wl_display_sync(client_display);
+        wl_display_flush(client_display);
+        wl_event_loop_dispatch(wl_display_get_event_loop(display), 0);
+        wl_display_flush_clients(display);
+        wl_display_dispatch(client_display);
+        wl_callback_destroy(callback);
+    }
+
+    void draw(unsigned char value)
+    {
+        std::memset(shm_file.base_ptr(), value, height * stride);
+    }
+
+    /// The server's side of the client's \a buffer
+    wl_resource* resource_for(wl_buffer* buffer)
+    {
+        return wl_client_get_object(client, wl_proxy_get_id(reinterpret_cast<wl_proxy*>(buffer)));
+    }
+
+    std::vector<unsigned char> read(mf::WlShmBuffer& buffer)
+    {
+        std::vector<unsigned char> pixels;
+        buffer.read([this, &pixels](unsigned char const* data)
+            {
+                pixels.assign(data, data + height * stride);
+            });
+        return pixels;
+    }
+
+    int32_t const width{4};
+    int32_t const height{3};
+    int32_t const stride{width * 4};
+    int32_t const pool_size{height * stride};
+
+    wl_display* const display;
+    wl_client* client;
+    wl_display* client_display;
+    wl_shm* shm{nullptr};
+    wl_shm_pool* pool;
+    // Leaves room for the client to grow the pool
+    mir::AnonymousShmFile shm_file{static_cast<size_t>(2 * pool_size)};
+    std::shared_ptr<mir::Executor> const executor{std::make_shared<ImmediateExecutor>()};
+
+    static void handle_global(void* data, wl_registry* registry, uint32_t name, char const* interface, uint32_t)
+    {
+        auto const self = static_cast<WlShmBufferTest*>(data);
+        if (strcmp(interface, wl_shm_interface.name) == 0)
+            self->shm = static_cast<wl_shm*>(wl_registry_bind(registry, name, &wl_shm_interface, 1));
+    }
+
+    static void handle_global_remove(void*, wl_registry*, uint32_t)
+    {
+    }
+
+    static wl_registry_listener const registry_listener;
+};
+
+wl_registry_listener const WlShmBufferTest::registry_listener{&handle_global, &handle_global_remove};
+}
+
+TEST_F(WlShmBufferTest, reads_the_committed_contents_after_the_client_destroys_the_buffer)
+{
+    draw(0xa5);
+    auto const client_buffer = wl_shm_pool_create_buffer(pool, 0, width, height, stride, WL_SHM_FORMAT_ARGB8888);
+    roundtrip();
+
+    bool consumed{false};
+    auto const buffer = mf::WlShmBuffer::mir_buffer_from_wl_buffer(
+        resource_for(client_buffer),
+        executor,
+        [&consumed] { consumed = true; });
+
+    wl_buffer_destroy(client_buffer);
+    roundtrip();
+
+    EXPECT_THAT(read(*buffer), Each(Eq(0xa5)));
+    EXPECT_TRUE(consumed);
+}
+
+TEST_F(WlShmBufferTest, reads_the_committed_contents_after_the_client_resizes_the_pool_and_redraws)
+{
+    draw(0xa5);
+    auto const client_buffer = wl_shm_pool_create_buffer(pool, 0, width, height, stride, WL_SHM_FORMAT_ARGB8888);
+    roundtrip();
+
+    auto const buffer = mf::WlShmBuffer::mir_buffer_from_wl_buffer(
+        resource_for(client_buffer),
+        executor,
+        [] {});
+
+    wl_shm_pool_resize(pool, 2 * pool_size);
+    roundtrip();
+    draw(0x5a);
+
+    EXPECT_THAT(read(*buffer), Each(Eq(0xa5)));
+
+    wl_buffer_destroy(client_buffer);
+}